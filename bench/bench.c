@@ -0,0 +1,435 @@
+/**
+ * @file bench.c
+ * @brief Purpose: compile and run generated workloads several times and report
+ *        p50/p99 of compile time, load time, run time, VM instructions per
+ *        second and peak memory.
+ *
+ * Load and run time, the instructions executed and the peak memory come
+ * from the runtime's own report (--stats=json), so process start up is left
+ * out of the times; the compile time is measured around the compiler process.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "workload.h"
+
+#define DEFAULT_RUNS        (5)                     /**< runs of each workload */
+#define DEFAULT_BIN_DIR     "../bin"                /**< where compiler and runtime are */
+#define DEFAULT_TMPDIR      "/tmp"                  /**< temporary directory if $TMPDIR is not set */
+#define STATS_LINE_SIZE     (4096)                  /**< longest stats report line */
+
+/**
+ * @brief the workloads run by default, small and large of each shape.
+ */
+static const char *s_default_suite[] = {
+    "loops:4", "loops:6",
+    "expr:50", "expr:500",
+    "vars:8", "vars:64",
+    "ifs:8", "ifs:64",
+    "output:10000", "output:100000",
+};
+
+/**
+ * @brief measurements of the runs of a workload.
+ */
+enum metric {
+    METRIC_COMPILE = 0,                             /**< compile time, ms */
+    METRIC_LOAD,                                    /**< load time, ms */
+    METRIC_RUN,                                     /**< run time, ms */
+    METRIC_IPS,                                     /**< VM instructions per second, millions */
+    METRIC_RSS,                                     /**< peak resident set size of the runtime, KB */
+    METRIC_COUNT
+};
+
+static const char *s_metric_names[METRIC_COUNT] = {
+    [METRIC_COMPILE]    = "compile_ms",
+    [METRIC_LOAD]       = "load_ms",
+    [METRIC_RUN]        = "run_ms",
+    [METRIC_IPS]        = "minstr_per_s",
+    [METRIC_RSS]        = "rss_kb",
+};
+
+/**
+ * @brief run a program and wait for it.
+ * @param argv arguments of the program, argv[0] is its path.
+ * @param stdout_path where its stdout goes, NULL to keep it.
+ * @param usage [out] resources used by it.
+ * @return exit status, -1 if it didn't exit normally.
+ */
+static int s_run(char *const [], const char *, struct rusage *);
+
+/**
+ * @brief get a number from the stats report, e.g. "run_seconds".
+ * @param line the stats report.
+ * @param key name of the field.
+ * @param value [out] the number.
+ * @return 0 on success; otherwise EBADMSG.
+ */
+static int s_stats_field(const char *, const char *, double *);
+
+/**
+ * @brief compare two doubles for qsort.
+ * @return <0, 0 or >0.
+ */
+static int s_compare(const void *, const void *);
+
+/**
+ * @brief get a percentile, nearest rank.
+ * @param values the samples, sorted in place.
+ * @param count number of samples.
+ * @param percent the percentile, e.g. 99.
+ * @return the percentile.
+ */
+static double s_percentile(double *, int, double);
+
+/**
+ * @brief benchmark one workload.
+ * @param spec workload spec, "name:size".
+ * @param bin_dir where compiler and runtime are.
+ * @param work_dir where the programs and reports go.
+ * @param runs runs of the workload.
+ * @param csv CSV output, NULL for none.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_bench(const char *, const char *, const char *, int, FILE *);
+
+/**
+ * @brief output the usage information about the harness.
+ */
+static void s_usage();
+
+/**
+ * @brief main entrance of the benchmark harness.
+ * @param argc arguments count.
+ * @param argv arguments vector.
+ * @return 0 on success; otherwise errno.
+ */
+int main(int argc, char *argv[])
+{
+    const char *bin_dir = DEFAULT_BIN_DIR;
+    const char *csv_path = NULL;
+    const char *tmp_dir;
+    char work_dir[PATH_MAX];
+    char *end = NULL;
+    FILE *csv = NULL;
+    int runs = DEFAULT_RUNS;
+    int failed = 0;
+    int option;
+    int i;
+
+    static struct option long_options[] = {
+        {"runs",    required_argument, NULL, 'r'},
+        {"bin",     required_argument, NULL, 'b'},
+        {"csv",     required_argument, NULL, 'c'},
+        {NULL,      0,                 NULL, 0}
+    };
+
+    while ((option = getopt_long(argc, argv, "r:b:c:", long_options, NULL)) != -1) {
+        switch (option) {
+            case 'r':
+                runs = strtol(optarg, &end, 10);
+                if (*optarg == '\0' || *end != '\0' || runs < 1) {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            case 'b':
+                bin_dir = optarg;
+                break;
+            case 'c':
+                csv_path = optarg;
+                break;
+            default:
+                s_usage();
+                return EINVAL;
+        }
+    }
+
+    tmp_dir = getenv("TMPDIR");
+    if (tmp_dir == NULL || *tmp_dir == '\0')
+        tmp_dir = DEFAULT_TMPDIR;
+    snprintf(work_dir, sizeof(work_dir), "%s/ten-bench.XXXXXX", tmp_dir);
+    if (mkdtemp(work_dir) == NULL) {
+        fprintf(stderr, "%s: %s\n", work_dir, strerror(errno));
+        return errno;
+    }
+
+    if (csv_path != NULL) {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "%s: %s\n", csv_path, strerror(errno));
+            return errno;
+        }
+        fprintf(csv, "workload,runs,executed");
+        for (i = 0; i < METRIC_COUNT; i++)
+            fprintf(csv, ",%s_p50,%s_p99", s_metric_names[i], s_metric_names[i]);
+        fprintf(csv, "\n");
+    }
+
+    printf("%-16s %5s %21s %21s %21s %19s %17s\n", "workload", "runs",
+           "compile ms p50/p99", "load ms p50/p99", "run ms p50/p99",
+           "Minstr/s p50/p99", "rss KB p50/p99");
+
+    if (optind == argc) {
+        for (i = 0; i < (int)(sizeof(s_default_suite) / sizeof(s_default_suite[0])); i++)
+            failed |= s_bench(s_default_suite[i], bin_dir, work_dir, runs, csv) != 0;
+    } else {
+        for (i = optind; i < argc; i++)
+            failed |= s_bench(argv[i], bin_dir, work_dir, runs, csv) != 0;
+    }
+
+    if (csv != NULL && fclose(csv) != 0) {
+        fprintf(stderr, "%s: %s\n", csv_path, strerror(errno));
+        failed = 1;
+    }
+
+    rmdir(work_dir);
+    return failed ? EXIT_FAILURE : 0;
+}
+
+/**
+ * @brief benchmark one workload.
+ * @param spec workload spec, "name:size".
+ * @param bin_dir where compiler and runtime are.
+ * @param work_dir where the programs and reports go.
+ * @param runs runs of the workload.
+ * @param csv CSV output, NULL for none.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_bench(const char *spec, const char *bin_dir, const char *work_dir,
+                   int runs, FILE *csv) {
+    char compiler_path[PATH_MAX];
+    char runtime_path[PATH_MAX];
+    char source_path[PATH_MAX];
+    char asm_path[PATH_MAX];
+    char stats_path[PATH_MAX];
+    char line[STATS_LINE_SIZE];
+    const workload_st *workload;
+    struct timespec start, stop;
+    struct rusage usage;
+    double *samples[METRIC_COUNT];
+    double executed = 0;
+    double seconds;
+    FILE *fout;
+    long size;
+    int rc = 0;
+    int run;
+    int i;
+
+    workload = workload_parse(spec, &size);
+    if (workload == NULL) {
+        fprintf(stderr, "%s: unknown workload\n", spec);
+        return EINVAL;
+    }
+
+    snprintf(compiler_path, sizeof(compiler_path), "%s/compiler", bin_dir);
+    snprintf(runtime_path, sizeof(runtime_path), "%s/runtime", bin_dir);
+    snprintf(source_path, sizeof(source_path), "%s/bench.ten", work_dir);
+    snprintf(asm_path, sizeof(asm_path), "%s/bench.asm", work_dir);
+    snprintf(stats_path, sizeof(stats_path), "%s/bench.stats", work_dir);
+
+    fout = fopen(source_path, "w");
+    if (fout == NULL)
+        return errno;
+    workload->generate(fout, size);
+    if (fclose(fout) != 0)
+        return errno;
+
+    for (i = 0; i < METRIC_COUNT; i++) {
+        samples[i] = (double *)calloc(runs, sizeof(double));
+        if (samples[i] == NULL)
+            exit(ENOMEM);
+    }
+
+    {
+        char *const compile_argv[] = { compiler_path, source_path, asm_path, NULL };
+        char *const run_argv[] = { runtime_path, "--stats=json", "--stats-output", stats_path,
+                                   asm_path, NULL };
+
+        for (run = 0; run < runs && rc == 0; run++) {
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            if (s_run(compile_argv, NULL, &usage) != 0) {
+                fprintf(stderr, "%s: compile failed\n", spec);
+                rc = EINVAL;
+                break;
+            }
+            clock_gettime(CLOCK_MONOTONIC, &stop);
+            samples[METRIC_COMPILE][run] = (stop.tv_sec - start.tv_sec) * 1e3 +
+                                           (stop.tv_nsec - start.tv_nsec) / 1e6;
+
+            unlink(stats_path);
+            if (s_run(run_argv, "/dev/null", &usage) != 0) {
+                fprintf(stderr, "%s: run failed\n", spec);
+                rc = EINVAL;
+                break;
+            }
+
+            fout = fopen(stats_path, "r");
+            if (fout == NULL || fgets(line, sizeof(line), fout) == NULL ||
+                s_stats_field(line, "executed", &executed) != 0 ||
+                s_stats_field(line, "load_seconds", &seconds) != 0) {
+                fprintf(stderr, "%s: no stats report\n", spec);
+                rc = EBADMSG;
+            } else {
+                samples[METRIC_LOAD][run] = seconds * 1e3;
+                if (s_stats_field(line, "run_seconds", &seconds) != 0)
+                    rc = EBADMSG;
+                samples[METRIC_RUN][run] = seconds * 1e3;
+                samples[METRIC_IPS][run] = seconds > 0 ? executed / seconds / 1e6 : 0;
+                if (s_stats_field(line, "max_rss_kb", &samples[METRIC_RSS][run]) != 0)
+                    rc = EBADMSG;
+            }
+            if (fout != NULL)
+                fclose(fout);
+        }
+    }
+
+    if (rc == 0) {
+        printf("%-16s %5d", spec, runs);
+        if (csv != NULL)
+            fprintf(csv, "%s,%d,%.0f", spec, runs, executed);
+        for (i = 0; i < METRIC_COUNT; i++) {
+            double p50 = s_percentile(samples[i], runs, 50);
+            double p99 = s_percentile(samples[i], runs, 99);
+
+            if (i == METRIC_RSS)
+                printf(" %8.0f/%-8.0f", p50, p99);
+            else if (i == METRIC_IPS)
+                printf(" %9.1f/%-9.1f", p50, p99);
+            else
+                printf(" %10.3f/%-10.3f", p50, p99);
+            if (csv != NULL)
+                fprintf(csv, ",%.6f,%.6f", p50, p99);
+        }
+        printf("\n");
+        if (csv != NULL)
+            fprintf(csv, "\n");
+    }
+    fflush(stdout);
+
+    for (i = 0; i < METRIC_COUNT; i++)
+        free(samples[i]);
+    unlink(source_path);
+    unlink(asm_path);
+    unlink(stats_path);
+    return rc;
+}
+
+/**
+ * @brief run a program and wait for it.
+ * @param argv arguments of the program, argv[0] is its path.
+ * @param stdout_path where its stdout goes, NULL to keep it.
+ * @param usage [out] resources used by it.
+ * @return exit status, -1 if it didn't exit normally.
+ */
+static int s_run(char *const argv[], const char *stdout_path, struct rusage *usage) {
+    pid_t pid;
+    int status;
+    int fd;
+
+    pid = fork();
+    if (pid < 0)
+        return -1;
+
+    if (pid == 0) {
+        if (stdout_path != NULL) {
+            fd = open(stdout_path, O_WRONLY);
+            if (fd < 0 || dup2(fd, STDOUT_FILENO) < 0)
+                _exit(127);
+            close(fd);
+        }
+        execv(argv[0], argv);
+        fprintf(stderr, "%s: %s\n", argv[0], strerror(errno));
+        _exit(127);
+    }
+
+    if (wait4(pid, &status, 0, usage) < 0)
+        return -1;
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/**
+ * @brief get a number from the stats report, e.g. "run_seconds".
+ * @param line the stats report.
+ * @param key name of the field.
+ * @param value [out] the number.
+ * @return 0 on success; otherwise EBADMSG.
+ */
+static int s_stats_field(const char *line, const char *key, double *value) {
+    char pattern[64];
+    const char *found;
+    char *end = NULL;
+
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    found = strstr(line, pattern);
+    if (found == NULL)
+        return EBADMSG;
+
+    *value = strtod(found + strlen(pattern), &end);
+    return end == found + strlen(pattern) ? EBADMSG : 0;
+}
+
+/**
+ * @brief compare two doubles for qsort.
+ * @return <0, 0 or >0.
+ */
+static int s_compare(const void *left, const void *right) {
+    double l = *(const double *)left;
+    double r = *(const double *)right;
+
+    return (l > r) - (l < r);
+}
+
+/**
+ * @brief get a percentile, nearest rank.
+ * @param values the samples, sorted in place.
+ * @param count number of samples.
+ * @param percent the percentile, e.g. 99.
+ * @return the percentile.
+ */
+static double s_percentile(double *values, int count, double percent) {
+    int rank;
+
+    qsort(values, count, sizeof(double), s_compare);
+    rank = (int)(percent / 100.0 * count + 0.999999);
+    if (rank < 1)
+        rank = 1;
+    return values[rank - 1];
+}
+
+/**
+ * @brief output the usage information about the harness.
+ */
+static void s_usage() {
+    const workload_st *workloads;
+    int count;
+    int i;
+
+    workloads = workload_list(&count);
+
+    printf("Usage:\n");
+    printf("./ten-bench [options] [<workload>:<size> ...]\n");
+    printf("e.g ./ten-bench --runs 10 --csv bench.csv loops:6 output:100000\n");
+    printf("Without workloads the default suite runs.\n");
+    printf("Options:\n");
+    printf("  --runs <n>                  runs of each workload, default %d\n", DEFAULT_RUNS);
+    printf("  --bin <dir>                 where compiler and runtime are, default %s\n",
+                                          DEFAULT_BIN_DIR);
+    printf("  --csv <file>                also write the results as CSV\n");
+    printf("Workloads:\n");
+    for (i = 0; i < count; i++)
+        printf("  %-8s size is %s\n", workloads[i].name, workloads[i].size_meaning);
+}
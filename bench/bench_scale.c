@@ -0,0 +1,505 @@
+/**
+ * @file bench_scale.c
+ * @brief Purpose: compiler throughput on generated sources from 1 KB to 1 GB,
+ *        and where the compiler stops scaling.
+ *
+ * For each shape (a long statement list, deep nesting, a long expression) the
+ * source grows by SIZE_FACTOR from --min-bytes to --max-bytes. Every size is
+ * compiled once with "--time-report", and the report gives each phase apart:
+ *   - lexer MB/s, bytes of source over the lexical phase;
+ *   - parser nodes/s, parse tree nodes over the syntax phase;
+ *   - code generation instructions/s, instructions over the semantic and
+ *     emit phases.
+ * A size fails when the compiler is killed (SIGSEGV is reported as a stack
+ * overflow), runs out of cpu time (twice --budget) or exits with an error.
+ * A size is flagged "superlinear" when its time grows faster than
+ * SUPERLINEAR times the source, with the phase to blame. The next size is
+ * skipped when the growth seen so far projects it over --budget seconds.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "workload.h"
+
+#define DEFAULT_MIN_BYTES   (1L << 10)              /**< smallest source, 1 KB */
+#define DEFAULT_MAX_BYTES   (1L << 30)              /**< largest source, 1 GB */
+#define DEFAULT_BUDGET      (60.0)                  /**< seconds of one compile at most */
+#define DEFAULT_BIN_DIR     "../bin"                /**< where the compiler is */
+#define DEFAULT_TMPDIR      "/tmp"                  /**< temporary directory if $TMPDIR is not set */
+#define SIZE_FACTOR         (10)                    /**< growth between sizes */
+#define SUPERLINEAR         (1.5)                   /**< growth exponent flagged as superlinear */
+#define NOISE_SECONDS       (0.05)                  /**< shorter phases are too noisy to judge growth */
+#define REPORT_LINE_SIZE    (256)                   /**< longest time report line */
+#define STATUS_SIZE         (64)                    /**< longest status of a size */
+#define WORK_DIR_SIZE       (PATH_MAX - 32)         /**< longest work directory, with room for file names */
+
+enum scale_phase {
+    SCALE_LEXICAL = 0,
+    SCALE_SYNTAX,
+    SCALE_SEMANTIC,
+    SCALE_EMIT,
+    SCALE_PHASE_COUNT
+};
+
+static const char *s_phase_names[SCALE_PHASE_COUNT] = {
+    [SCALE_LEXICAL]     = "lexical",
+    [SCALE_SYNTAX]      = "syntax",
+    [SCALE_SEMANTIC]    = "semantic",
+    [SCALE_EMIT]        = "emit",
+};
+
+static const char *s_default_shapes[] = { "statements", "nesting", "expression" };
+
+typedef struct scale_result {
+    long bytes;                                     /**< size of the source */
+    double seconds;                                 /**< wall time of the compile */
+    double phase_seconds[SCALE_PHASE_COUNT];        /**< wall time of each phase */
+    double tokens;                                  /**< tokens of the source */
+    double nodes;                                   /**< parse tree nodes */
+    double instructions;                            /**< byte code instructions */
+    double max_rss_kb;                              /**< peak memory of the compiler */
+    char status[STATUS_SIZE];                       /**< "ok", or why the size failed */
+} scale_result_st;
+
+/**
+ * @brief compile one generated source and read its time report.
+ * @param compiler_path path of the compiler.
+ * @param work_dir where the source and the reports go.
+ * @param workload the shape.
+ * @param bytes size of the source.
+ * @param budget seconds of one compile at most.
+ * @param result [out] the measurement, result->status tells if it failed.
+ * @return 0 on success, even if the compiler failed; otherwise errno.
+ */
+static int s_compile(const char *, const char *, const workload_st *, long, double,
+                     scale_result_st *);
+
+/**
+ * @brief read the time report of the compiler.
+ * @param path path of the report.
+ * @param result [out] times and counts of the report.
+ * @return 0 on success; otherwise EBADMSG.
+ */
+static int s_read_report(const char *, scale_result_st *);
+
+/**
+ * @brief get the growth exponent between two sizes, time ~ bytes^exponent.
+ * @param seconds time of the larger size.
+ * @param previous_seconds time of the smaller size.
+ * @param bytes the larger size.
+ * @param previous_bytes the smaller size.
+ * @return the exponent, 0 if any time is too short to tell.
+ */
+static double s_growth(double, double, long, long);
+
+/**
+ * @brief get the seconds since a point in time.
+ * @param start the point in time.
+ * @return seconds elapsed.
+ */
+static double s_seconds_since(const struct timespec *);
+
+/**
+ * @brief output the usage information about the harness.
+ */
+static void s_usage();
+
+/**
+ * @brief main entrance of the scaling benchmark.
+ * @param argc arguments count.
+ * @param argv arguments vector.
+ * @return 0 on success, a failing size is a result; otherwise errno.
+ */
+int main(int argc, char *argv[])
+{
+    const char *const *shapes = s_default_shapes;
+    const workload_st *workload;
+    scale_result_st result;
+    scale_result_st previous;
+    const char *bin_dir = DEFAULT_BIN_DIR;
+    const char *csv_path = NULL;
+    const char *tmp_dir;
+    char compiler_path[PATH_MAX];
+    char work_dir[WORK_DIR_SIZE];
+    char spec[STATUS_SIZE];
+    long min_bytes = DEFAULT_MIN_BYTES;
+    long max_bytes = DEFAULT_MAX_BYTES;
+    double budget = DEFAULT_BUDGET;
+    double growth;
+    double worst;
+    double projected;
+    const char *blame;
+    char *end = NULL;
+    FILE *csv = NULL;
+    long bytes;
+    int shape_count = sizeof(s_default_shapes) / sizeof(s_default_shapes[0]);
+    int option;
+    int rc = 0;
+    int i, j;
+
+    static struct option long_options[] = {
+        {"min-bytes",   required_argument, NULL, 's'},
+        {"max-bytes",   required_argument, NULL, 'S'},
+        {"budget",      required_argument, NULL, 'b'},
+        {"bin",         required_argument, NULL, 'B'},
+        {"csv",         required_argument, NULL, 'c'},
+        {NULL,          0,                 NULL, 0}
+    };
+
+    while ((option = getopt_long(argc, argv, "s:S:b:B:c:", long_options, NULL)) != -1) {
+        switch (option) {
+            case 's':
+            case 'S':
+                // the same suffixes as the workloads, e.g. "64M".
+                snprintf(spec, sizeof(spec), "statements:%s", optarg);
+                if (workload_parse(spec, &bytes) == NULL) {
+                    s_usage();
+                    return EINVAL;
+                }
+                if (option == 's')
+                    min_bytes = bytes;
+                else
+                    max_bytes = bytes;
+                break;
+            case 'b':
+                budget = strtod(optarg, &end);
+                if (*optarg == '\0' || *end != '\0' || budget <= 0) {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            case 'B':
+                bin_dir = optarg;
+                break;
+            case 'c':
+                csv_path = optarg;
+                break;
+            default:
+                s_usage();
+                return EINVAL;
+        }
+    }
+    if (max_bytes < min_bytes) {
+        s_usage();
+        return EINVAL;
+    }
+    if (optind < argc) {
+        shapes = (const char *const *)&argv[optind];
+        shape_count = argc - optind;
+    }
+
+    snprintf(compiler_path, sizeof(compiler_path), "%s/compiler", bin_dir);
+    if (access(compiler_path, X_OK) != 0) {
+        fprintf(stderr, "%s: %s\n", compiler_path, strerror(errno));
+        return errno;
+    }
+
+    tmp_dir = getenv("TMPDIR");
+    if (tmp_dir == NULL || *tmp_dir == '\0')
+        tmp_dir = DEFAULT_TMPDIR;
+    snprintf(work_dir, sizeof(work_dir), "%s/ten-bench-scale.XXXXXX", tmp_dir);
+    if (mkdtemp(work_dir) == NULL) {
+        fprintf(stderr, "%s: %s\n", work_dir, strerror(errno));
+        return errno;
+    }
+
+    if (csv_path != NULL) {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "%s: %s\n", csv_path, strerror(errno));
+            rmdir(work_dir);
+            return errno;
+        }
+        fprintf(csv, "shape,bytes,status,seconds,lexer_mb_per_s,parser_nodes_per_s,"
+                     "codegen_instructions_per_s,tokens,nodes,instructions,max_rss_kb,growth\n");
+    }
+
+    printf("%-11s %11s %9s %11s %12s %12s %9s %6s  %s\n", "shape", "bytes", "seconds",
+           "lexer MB/s", "parser Mn/s", "codegen Mi/s", "rss MB", "growth", "status");
+
+    for (i = 0; i < shape_count && rc == 0; i++) {
+        workload = workload_find(shapes[i]);
+        if (workload == NULL) {
+            fprintf(stderr, "%s: unknown workload\n", shapes[i]);
+            rc = EINVAL;
+            break;
+        }
+
+        memset(&previous, 0, sizeof(previous));
+        for (bytes = min_bytes; bytes <= max_bytes; bytes *= SIZE_FACTOR) {
+            rc = s_compile(compiler_path, work_dir, workload, bytes, budget, &result);
+            if (rc != 0) {
+                fprintf(stderr, "%s: %s\n", shapes[i], strerror(rc));
+                break;
+            }
+
+            // judge the growth by the total, blame the phase growing the most.
+            growth = 0;
+            blame = NULL;
+            if (previous.bytes > 0 && strcmp(result.status, "ok") == 0) {
+                growth = s_growth(result.seconds, previous.seconds,
+                                  result.bytes, previous.bytes);
+                worst = 0;
+                for (j = 0; j < SCALE_PHASE_COUNT; j++) {
+                    double phase_growth = s_growth(result.phase_seconds[j],
+                                                   previous.phase_seconds[j],
+                                                   result.bytes, previous.bytes);
+                    if (phase_growth > worst) {
+                        worst = phase_growth;
+                        blame = s_phase_names[j];
+                    }
+                }
+                if (growth > SUPERLINEAR && blame != NULL)
+                    snprintf(result.status, sizeof(result.status),
+                             "superlinear in %s (n^%.1f)", blame, worst);
+            }
+
+            if (strcmp(result.status, "ok") == 0 || strncmp(result.status, "superlinear", 11) == 0) {
+                printf("%-11s %11ld %9.3f %11.2f %12.3f %12.3f %9.1f %6.2f  %s\n",
+                       workload->name, result.bytes, result.seconds,
+                       result.phase_seconds[SCALE_LEXICAL] > 0 ?
+                       result.bytes / 1e6 / result.phase_seconds[SCALE_LEXICAL] : 0,
+                       result.phase_seconds[SCALE_SYNTAX] > 0 ?
+                       result.nodes / 1e6 / result.phase_seconds[SCALE_SYNTAX] : 0,
+                       result.phase_seconds[SCALE_SEMANTIC] + result.phase_seconds[SCALE_EMIT] > 0 ?
+                       result.instructions / 1e6 / (result.phase_seconds[SCALE_SEMANTIC] +
+                                                    result.phase_seconds[SCALE_EMIT]) : 0,
+                       result.max_rss_kb / 1024, growth, result.status);
+            } else {
+                printf("%-11s %11ld %9.3f %11s %12s %12s %9s %6s  failed: %s\n",
+                       workload->name, result.bytes, result.seconds,
+                       "-", "-", "-", "-", "-", result.status);
+            }
+            if (csv != NULL) {
+                fprintf(csv, "%s,%ld,%s,%.6f,%.3f,%.0f,%.0f,%.0f,%.0f,%.0f,%.0f,%.3f\n",
+                        workload->name, result.bytes, result.status, result.seconds,
+                        result.phase_seconds[SCALE_LEXICAL] > 0 ?
+                        result.bytes / 1e6 / result.phase_seconds[SCALE_LEXICAL] : 0,
+                        result.phase_seconds[SCALE_SYNTAX] > 0 ?
+                        result.nodes / result.phase_seconds[SCALE_SYNTAX] : 0,
+                        result.phase_seconds[SCALE_SEMANTIC] + result.phase_seconds[SCALE_EMIT] > 0 ?
+                        result.instructions / (result.phase_seconds[SCALE_SEMANTIC] +
+                                               result.phase_seconds[SCALE_EMIT]) : 0,
+                        result.tokens, result.nodes, result.instructions,
+                        result.max_rss_kb, growth);
+            }
+            fflush(stdout);
+
+            // a failed size ends the shape, larger ones fail the same way.
+            if (strcmp(result.status, "ok") != 0 && strncmp(result.status, "superlinear", 11) != 0)
+                break;
+
+            // project the next size with the growth seen so far, at least linear.
+            projected = result.seconds * pow(SIZE_FACTOR, growth > 1 ? growth : 1);
+            if (bytes * SIZE_FACTOR <= max_bytes && projected > budget) {
+                printf("%-11s %11ld %9s %11s %12s %12s %9s %6s  skipped: projected %.0f s\n",
+                       workload->name, bytes * SIZE_FACTOR, "-", "-", "-", "-", "-", "-",
+                       projected);
+                if (csv != NULL)
+                    fprintf(csv, "%s,%ld,skipped,,,,,,,,,\n", workload->name, bytes * SIZE_FACTOR);
+                break;
+            }
+            previous = result;
+        }
+    }
+
+    if (csv != NULL && fclose(csv) != 0 && rc == 0) {
+        fprintf(stderr, "%s: %s\n", csv_path, strerror(errno));
+        rc = errno;
+    }
+    rmdir(work_dir);
+    return rc;
+}
+
+/**
+ * @brief compile one generated source and read its time report.
+ * @param compiler_path path of the compiler.
+ * @param work_dir where the source and the reports go.
+ * @param workload the shape.
+ * @param bytes size of the source.
+ * @param budget seconds of one compile at most.
+ * @param result [out] the measurement, result->status tells if it failed.
+ * @return 0 on success, even if the compiler failed; otherwise errno.
+ */
+static int s_compile(const char *compiler_path, const char *work_dir, const workload_st *workload,
+                     long bytes, double budget, scale_result_st *result) {
+    char source_path[PATH_MAX];
+    char asm_path[PATH_MAX];
+    char report_path[PATH_MAX];
+    struct timespec start;
+    struct rlimit limit;
+    struct stat source_stat;
+    FILE *fout;
+    pid_t pid;
+    int status;
+    int fd;
+    int rc = 0;
+
+    memset(result, 0, sizeof(*result));
+    snprintf(source_path, sizeof(source_path), "%s/scale.ten", work_dir);
+    snprintf(asm_path, sizeof(asm_path), "%s/scale.asm", work_dir);
+    snprintf(report_path, sizeof(report_path), "%s/scale.report", work_dir);
+
+    fout = fopen(source_path, "w");
+    if (fout == NULL)
+        return errno;
+    workload->generate(fout, bytes);
+    if (fclose(fout) != 0 || stat(source_path, &source_stat) != 0) {
+        rc = errno;
+        unlink(source_path);
+        return rc;
+    }
+    result->bytes = source_stat.st_size;
+
+    char *const argv[] = { (char *)compiler_path, "--time-report", source_path, asm_path, NULL };
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pid = fork();
+    if (pid < 0) {
+        rc = errno;
+        unlink(source_path);
+        return rc;
+    }
+    if (pid == 0) {
+        // cpu time, not wall time, so a loaded machine doesn't fail a size.
+        limit.rlim_cur = (rlim_t)(budget * 2) + 1;
+        limit.rlim_max = limit.rlim_cur + 1;
+        setrlimit(RLIMIT_CPU, &limit);
+        fd = open(report_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || dup2(fd, STDERR_FILENO) < 0)
+            _exit(127);
+        close(fd);
+        fd = open("/dev/null", O_WRONLY);
+        if (fd < 0 || dup2(fd, STDOUT_FILENO) < 0)
+            _exit(127);
+        close(fd);
+        execv(argv[0], argv);
+        _exit(127);
+    }
+
+    if (waitpid(pid, &status, 0) < 0)
+        rc = errno;
+    result->seconds = s_seconds_since(&start);
+
+    if (rc != 0)
+        snprintf(result->status, sizeof(result->status), "%s", strerror(rc));
+    else if (WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV)
+        snprintf(result->status, sizeof(result->status), "stack overflow (SIGSEGV)");
+    else if (WIFSIGNALED(status) && (WTERMSIG(status) == SIGXCPU || WTERMSIG(status) == SIGKILL))
+        snprintf(result->status, sizeof(result->status), "timeout (%.0f s cpu)", budget * 2);
+    else if (WIFSIGNALED(status))
+        snprintf(result->status, sizeof(result->status), "%s", strsignal(WTERMSIG(status)));
+    else if (WEXITSTATUS(status) != 0)
+        snprintf(result->status, sizeof(result->status), "exit %d", WEXITSTATUS(status));
+    else if (s_read_report(report_path, result) != 0)
+        snprintf(result->status, sizeof(result->status), "no time report");
+    else
+        snprintf(result->status, sizeof(result->status), "ok");
+
+    unlink(source_path);
+    unlink(asm_path);
+    unlink(report_path);
+    return 0;
+}
+
+/**
+ * @brief read the time report of the compiler.
+ * @param path path of the report.
+ * @param result [out] times and counts of the report.
+ * @return 0 on success; otherwise EBADMSG.
+ */
+static int s_read_report(const char *path, scale_result_st *result) {
+    char line[REPORT_LINE_SIZE];
+    char name[REPORT_LINE_SIZE];
+    double wall_ms;
+    long max_rss_kb;
+    int phases = 0;
+    FILE *fin;
+    int i;
+
+    fin = fopen(path, "r");
+    if (fin == NULL)
+        return EBADMSG;
+
+    while (fgets(line, sizeof(line), fin) != NULL) {
+        if (sscanf(line, "%255s %lf %*f %*u %ld", name, &wall_ms, &max_rss_kb) == 3) {
+            for (i = 0; i < SCALE_PHASE_COUNT; i++) {
+                if (strcmp(name, s_phase_names[i]) == 0) {
+                    result->phase_seconds[i] = wall_ms / 1e3;
+                    phases++;
+                }
+            }
+            if (strcmp(name, "total") == 0)
+                result->max_rss_kb = max_rss_kb;
+        } else if (strncmp(line, "tokens ", 7) == 0) {
+            result->tokens = strtod(line + 7, NULL);
+        } else if (strncmp(line, "parse tree nodes ", 17) == 0) {
+            result->nodes = strtod(line + 17, NULL);
+        } else if (strncmp(line, "instructions ", 13) == 0) {
+            result->instructions = strtod(line + 13, NULL);
+        }
+    }
+    fclose(fin);
+
+    return phases == SCALE_PHASE_COUNT ? 0 : EBADMSG;
+}
+
+/**
+ * @brief get the growth exponent between two sizes, time ~ bytes^exponent.
+ * @param seconds time of the larger size.
+ * @param previous_seconds time of the smaller size.
+ * @param bytes the larger size.
+ * @param previous_bytes the smaller size.
+ * @return the exponent, 0 if any time is too short to tell.
+ */
+static double s_growth(double seconds, double previous_seconds, long bytes, long previous_bytes) {
+    if (seconds < NOISE_SECONDS || previous_seconds <= 0 || bytes <= previous_bytes)
+        return 0;
+    return log(seconds / previous_seconds) / log((double)bytes / previous_bytes);
+}
+
+/**
+ * @brief get the seconds since a point in time.
+ * @param start the point in time.
+ * @return seconds elapsed.
+ */
+static double s_seconds_since(const struct timespec *start) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * @brief output the usage information about the harness.
+ */
+static void s_usage() {
+    printf("Usage:\n");
+    printf("./ten-bench-scale [options] [shape ...]\n");
+    printf("e.g ./ten-bench-scale --max-bytes 100M statements\n");
+    printf("Shapes: statements, nesting, expression, default all of them\n");
+    printf("Options:\n");
+    printf("  --min-bytes <n>             smallest source, K, M or G suffix, default 1K\n");
+    printf("  --max-bytes <n>             largest source, default 1G, sizes grow by %d\n",
+                                          SIZE_FACTOR);
+    printf("  --budget <sec>              skip sizes projected over sec per compile,\n");
+    printf("                              and fail those over twice it of cpu, default %.0f\n",
+                                          DEFAULT_BUDGET);
+    printf("  --bin <dir>                 where the compiler is, default %s\n", DEFAULT_BIN_DIR);
+    printf("  --csv <file>                also write the results as CSV\n");
+}
@@ -0,0 +1,671 @@
+/**
+ * @file bench_utils.c
+ * @brief Purpose: microbenchmarks of the compiler utility containers,
+ *        link_list, symbol_table and ast, from 10 to 10M elements.
+ *
+ * Methodology, for each case and size:
+ *   - every size runs in its own child process, so memory is returned between
+ *     sizes and a crash (e.g. a stack overflow in a recursive traverse) is
+ *     reported instead of ending the benchmark;
+ *   - the setup of a repetition (filling the container, building the tree)
+ *     is not timed, only the operation under test;
+ *   - one warm-up repetition, then at least MIN_REPS repetitions, until
+ *     --min-time seconds are spent or --max-reps is reached; the median and
+ *     the minimum per operation are reported;
+ *   - the next size is skipped when the growth seen so far projects a
+ *     repetition over --budget seconds, so quadratic cases stop in time.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "link_node.h"
+#include "link_list.h"
+#include "symbol_table.h"
+#include "ast.h"
+
+#define DEFAULT_MIN_SIZE    (10)                    /**< smallest size */
+#define DEFAULT_MAX_SIZE    (10000000)              /**< largest size */
+#define DEFAULT_MIN_TIME    (0.2)                   /**< seconds of repetitions per size */
+#define DEFAULT_MAX_REPS    (100000)                /**< repetitions per size at most */
+#define MIN_REPS            (3)                     /**< repetitions per size at least */
+#define DEFAULT_BUDGET      (5.0)                   /**< seconds of one repetition at most */
+#define SIZE_FACTOR         (10)                    /**< growth between sizes */
+#define KEY_SIZE            (24)                    /**< bytes of a symbol key, with '\0' */
+
+/**
+ * @brief prepare a repetition, not timed.
+ * @param size elements of the case.
+ * @return state of the repetition.
+ */
+typedef void *(*setup_cb)(long);
+
+/**
+ * @brief the operation under test, timed.
+ * @param state state of the repetition.
+ * @param size elements of the case.
+ */
+typedef void (*run_cb)(void *, long);
+
+/**
+ * @brief clean up a repetition, not timed.
+ * @param state state of the repetition.
+ */
+typedef void (*teardown_cb)(void *);
+
+typedef struct bench_case {
+    const char *name;                               /**< name of the case */
+    setup_cb setup;                                 /**< untimed preparation */
+    run_cb run;                                     /**< timed operation, size operations */
+    teardown_cb teardown;                           /**< untimed clean up */
+} bench_case_st;
+
+typedef struct bench_result {
+    double median_ns;                               /**< median time per operation */
+    double min_ns;                                  /**< best time per operation */
+    double rep_seconds;                             /**< median time of one repetition */
+    long reps;                                      /**< repetitions timed */
+} bench_result_st;
+
+typedef struct symbol_state {
+    symbol_table_st *table;                         /**< the table under test */
+    char *keys;                                     /**< size keys, KEY_SIZE bytes each */
+    char *misses;                                   /**< size keys not in the table, or NULL */
+} symbol_state_st;
+
+static double s_min_time = DEFAULT_MIN_TIME;        /**< seconds of repetitions per size */
+static long s_max_reps = DEFAULT_MAX_REPS;          /**< repetitions per size at most */
+static volatile long s_sink;                        /**< keeps the results of the runs alive */
+
+/**
+ * @brief get the seconds of CLOCK_MONOTONIC.
+ * @return seconds.
+ */
+static double s_now();
+
+/**
+ * @brief compare two doubles for qsort.
+ * @return <0, 0 or >0.
+ */
+static int s_compare(const void *, const void *);
+
+/**
+ * @brief measure one case at one size, in the calling process.
+ * @param bench the case.
+ * @param size elements of the case.
+ * @param result [out] the measurement.
+ */
+static void s_measure(const bench_case_st *, long, bench_result_st *);
+
+/**
+ * @brief measure one case at one size in a child process.
+ * @param bench the case.
+ * @param size elements of the case.
+ * @param result [out] the measurement.
+ * @return 0 on success; otherwise the signal that killed the child, or -1.
+ */
+static int s_measure_child(const bench_case_st *, long, bench_result_st *);
+
+
+/**
+ * @brief an empty list.
+ */
+static void *s_list_empty(long size) {
+    return link_list_init();
+}
+
+/**
+ * @brief a list of size nodes.
+ */
+static void *s_list_filled(long size) {
+    link_list_st *list = link_list_init();
+    long i;
+
+    for (i = 0; i < size; i++)
+        link_list_append(list, link_node_new(NULL, NULL));
+    return list;
+}
+
+/**
+ * @brief append size new nodes, as the code generator does with byte code.
+ */
+static void s_list_append(void *state, long size) {
+    long i;
+
+    for (i = 0; i < size; i++)
+        link_list_append((link_list_st *)state, link_node_new(NULL, NULL));
+}
+
+/**
+ * @brief pop and free size nodes.
+ */
+static void s_list_pop(void *state, long size) {
+    long i;
+
+    for (i = 0; i < size; i++)
+        link_node_free(link_list_pop((link_list_st *)state));
+}
+
+/**
+ * @brief count a node.
+ */
+static int s_list_count(link_node_st *node, void *cb_data) {
+    (*(long *)cb_data)++;
+    return LINK_LIST_CONTINUE;
+}
+
+/**
+ * @brief visit every node, as the byte code is printed.
+ */
+static void s_list_traverse(void *state, long size) {
+    long count = 0;
+
+    link_list_traverse((link_list_st *)state, s_list_count, &count);
+    s_sink = count;
+}
+
+/**
+ * @brief free the list.
+ */
+static void s_list_free(void *state) {
+    link_list_free((link_list_st *)state);
+}
+
+/**
+ * @brief an initialized table, with its keywords, and size keys to insert.
+ */
+static void *s_symbol_empty(long size) {
+    symbol_state_st *state;
+    long i;
+
+    state = (symbol_state_st *)malloc(sizeof(symbol_state_st));
+    if (state == NULL)
+        exit(ENOMEM);
+
+    state->table = symbol_table_init();
+    state->keys = (char *)malloc(size * KEY_SIZE);
+    if (state->keys == NULL)
+        exit(ENOMEM);
+
+    for (i = 0; i < size; i++)
+        snprintf(state->keys + i * KEY_SIZE, KEY_SIZE, "id%09ld", i);
+    state->misses = NULL;
+    return state;
+}
+
+/**
+ * @brief a table holding size keys.
+ */
+static void *s_symbol_filled(long size) {
+    symbol_state_st *state = (symbol_state_st *)s_symbol_empty(size);
+    long i;
+
+    for (i = 0; i < size; i++)
+        symbol_table_insert(state->table, state->keys + i * KEY_SIZE, IDENTIFIER);
+    return state;
+}
+
+/**
+ * @brief a table holding size keys, and size other keys to look up.
+ */
+static void *s_symbol_missed(long size) {
+    symbol_state_st *state = (symbol_state_st *)s_symbol_filled(size);
+    long i;
+
+    state->misses = (char *)malloc(size * KEY_SIZE);
+    if (state->misses == NULL)
+        exit(ENOMEM);
+
+    for (i = 0; i < size; i++)
+        snprintf(state->misses + i * KEY_SIZE, KEY_SIZE, "no%09ld", i);
+    return state;
+}
+
+/**
+ * @brief insert size new identifiers, as the lexer does.
+ */
+static void s_symbol_insert(void *state, long size) {
+    symbol_state_st *symbols = (symbol_state_st *)state;
+    long i;
+
+    for (i = 0; i < size; i++)
+        symbol_table_insert(symbols->table, symbols->keys + i * KEY_SIZE, IDENTIFIER);
+}
+
+/**
+ * @brief look up size identifiers in the table, in a scattered order.
+ */
+static void s_symbol_lookup(void *state, long size) {
+    symbol_state_st *symbols = (symbol_state_st *)state;
+    long found = 0;
+    long i;
+
+    for (i = 0; i < size; i++)
+        found += symbol_table_lookup(symbols->table,
+                    symbols->keys + ((i * 7919) % size) * KEY_SIZE) == IDENTIFIER;
+    s_sink = found;
+}
+
+/**
+ * @brief look up size identifiers missing from the table.
+ */
+static void s_symbol_lookup_miss(void *state, long size) {
+    symbol_state_st *symbols = (symbol_state_st *)state;
+    long found = 0;
+    long i;
+
+    for (i = 0; i < size; i++)
+        found += symbol_table_lookup(symbols->table, symbols->misses + i * KEY_SIZE) != -1;
+    s_sink = found;
+}
+
+/**
+ * @brief free the table and the keys.
+ */
+static void s_symbol_free(void *state) {
+    symbol_state_st *symbols = (symbol_state_st *)state;
+
+    symbol_table_fini(symbols->table);
+    free(symbols->keys);
+    free(symbols->misses);
+    free(symbols);
+}
+
+/**
+ * @brief an empty tree.
+ */
+static void *s_ast_empty(long size) {
+    return ast_init();
+}
+
+/**
+ * @brief append size declarations to a statement list, as the parser does.
+ */
+static void s_ast_build(void *state, long size) {
+    ast_node_st *last = NULL;
+    ast_node_st *node;
+    long i;
+
+    for (i = 0; i < size; i++) {
+        node = ast_new_node((ast_st *)state, AST_DECL, 1, 1);
+        if (last == NULL)
+            ast_set_root((ast_st *)state, node);
+        else
+            last->next = node;
+        last = node;
+    }
+}
+
+/**
+ * @brief a list of size statements, a long program.
+ */
+static void *s_ast_wide(long size) {
+    ast_st *ast = ast_init();
+
+    s_ast_build(ast, size);
+    return ast;
+}
+
+/**
+ * @brief a chain of size nested ifs, a deeply nested program.
+ */
+static void *s_ast_deep(long size) {
+    ast_st *ast = ast_init();
+    ast_node_st *last;
+    ast_node_st *node;
+    long i;
+
+    last = ast_new_node(ast, AST_IF, 1, 1);
+    ast_set_root(ast, last);
+    for (i = 1; i < size; i++) {
+        node = ast_new_node(ast, AST_IF, 1, 1);
+        last->then_body = node;
+        last = node;
+    }
+    return ast;
+}
+
+/**
+ * @brief count the nodes of a statement list or an expression, recursing
+ *        into the children as the code generator does.
+ * @param node first node, can be NULL.
+ * @return the number of nodes.
+ */
+static long s_ast_count(const ast_node_st *node) {
+    long count = 0;
+
+    for ( ; node != NULL; node = node->next) {
+        count++;
+        switch (node->kind) {
+            case AST_ASSIGN:
+            case AST_PRINT:
+                count += s_ast_count(node->expr);
+                break;
+            case AST_IF:
+                count += s_ast_count(node->cond) + s_ast_count(node->then_body) +
+                         s_ast_count(node->else_body);
+                break;
+            case AST_FOR:
+                count += s_ast_count(node->from) + s_ast_count(node->to) +
+                         s_ast_count(node->step) + s_ast_count(node->body);
+                break;
+            case AST_COMPARE:
+            case AST_BINARY:
+                count += s_ast_count(node->left) + s_ast_count(node->right);
+                break;
+            default:
+                break;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief visit every node.
+ */
+static void s_ast_traverse(void *state, long size) {
+    s_sink = s_ast_count(ast_get_root((ast_st *)state));
+}
+
+/**
+ * @brief free the tree, the operation under test.
+ */
+static void s_ast_free(void *state, long size) {
+    ast_free((ast_st *)state);
+}
+
+/**
+ * @brief free the tree after a build or a traverse.
+ */
+static void s_ast_teardown(void *state) {
+    ast_free((ast_st *)state);
+}
+
+static const bench_case_st s_cases[] = {
+    { "link_list_append",           s_list_empty,       s_list_append,          s_list_free },
+    { "link_list_pop",              s_list_filled,      s_list_pop,             s_list_free },
+    { "link_list_traverse",         s_list_filled,      s_list_traverse,        s_list_free },
+    { "symbol_table_insert",        s_symbol_empty,     s_symbol_insert,        s_symbol_free },
+    { "symbol_table_lookup",        s_symbol_filled,    s_symbol_lookup,        s_symbol_free },
+    { "symbol_table_lookup_miss",   s_symbol_missed,    s_symbol_lookup_miss,   s_symbol_free },
+    { "ast_build",                  s_ast_empty,        s_ast_build,            s_ast_teardown },
+    { "ast_traverse_wide",          s_ast_wide,         s_ast_traverse,         s_ast_teardown },
+    { "ast_traverse_deep",          s_ast_deep,         s_ast_traverse,         s_ast_teardown },
+    { "ast_free_wide",              s_ast_wide,         s_ast_free,             NULL },
+    { "ast_free_deep",              s_ast_deep,         s_ast_free,             NULL },
+};
+
+/**
+ * @brief output the usage information about the benchmark.
+ */
+static void s_usage();
+
+/**
+ * @brief main entrance of the utility microbenchmarks.
+ * @param argc arguments count.
+ * @param argv arguments vector.
+ * @return 0 on success; otherwise errno.
+ */
+int main(int argc, char *argv[])
+{
+    const bench_case_st *bench;
+    bench_result_st result;
+    long min_size = DEFAULT_MIN_SIZE;
+    long max_size = DEFAULT_MAX_SIZE;
+    double budget = DEFAULT_BUDGET;
+    double previous;
+    double projected;
+    const char *filter = NULL;
+    const char *csv_path = NULL;
+    char *end = NULL;
+    FILE *csv = NULL;
+    long size;
+    size_t i;
+    int option;
+    int rc;
+
+    static struct option long_options[] = {
+        {"min-size",    required_argument, NULL, 's'},
+        {"max-size",    required_argument, NULL, 'S'},
+        {"min-time",    required_argument, NULL, 't'},
+        {"max-reps",    required_argument, NULL, 'r'},
+        {"budget",      required_argument, NULL, 'b'},
+        {"filter",      required_argument, NULL, 'f'},
+        {"csv",         required_argument, NULL, 'c'},
+        {NULL,          0,                 NULL, 0}
+    };
+
+    while ((option = getopt_long(argc, argv, "s:S:t:r:b:f:c:", long_options, NULL)) != -1) {
+        switch (option) {
+            case 's':
+                min_size = strtol(optarg, &end, 10);
+                break;
+            case 'S':
+                max_size = strtol(optarg, &end, 10);
+                break;
+            case 't':
+                s_min_time = strtod(optarg, &end);
+                break;
+            case 'r':
+                s_max_reps = strtol(optarg, &end, 10);
+                break;
+            case 'b':
+                budget = strtod(optarg, &end);
+                break;
+            case 'f':
+                filter = optarg;
+                end = "";
+                break;
+            case 'c':
+                csv_path = optarg;
+                end = "";
+                break;
+            default:
+                s_usage();
+                return EINVAL;
+        }
+        if (*optarg == '\0' || *end != '\0') {
+            s_usage();
+            return EINVAL;
+        }
+    }
+    if (optind != argc || min_size < 1 || max_size < min_size || s_max_reps < 1) {
+        s_usage();
+        return EINVAL;
+    }
+
+    if (csv_path != NULL) {
+        csv = fopen(csv_path, "w");
+        if (csv == NULL) {
+            fprintf(stderr, "%s: %s\n", csv_path, strerror(errno));
+            return errno;
+        }
+        fprintf(csv, "case,size,reps,ns_per_op_median,ns_per_op_min,status\n");
+    }
+
+    printf("%-28s %10s %8s %12s %12s %10s\n", "case", "size", "reps",
+           "ns/op p50", "ns/op min", "Mops/s");
+
+    for (i = 0; i < sizeof(s_cases) / sizeof(s_cases[0]); i++) {
+        bench = &(s_cases[i]);
+        if (filter != NULL && strstr(bench->name, filter) == NULL)
+            continue;
+
+        previous = 0;
+        for (size = min_size; size <= max_size; size *= SIZE_FACTOR) {
+            rc = s_measure_child(bench, size, &result);
+            if (rc != 0) {
+                printf("%-28s %10ld   failed: %s\n", bench->name, size,
+                       rc == SIGSEGV ? "stack overflow (SIGSEGV)" :
+                       rc > 0 ? strsignal(rc) : "no result");
+                if (csv != NULL)
+                    fprintf(csv, "%s,%ld,0,,,%s\n", bench->name, size,
+                            rc == SIGSEGV ? "stack overflow" : "failed");
+                break;
+            }
+
+            printf("%-28s %10ld %8ld %12.2f %12.2f %10.2f\n", bench->name, size,
+                   result.reps, result.median_ns, result.min_ns,
+                   result.median_ns > 0 ? 1e3 / result.median_ns : 0);
+            if (csv != NULL)
+                fprintf(csv, "%s,%ld,%ld,%.3f,%.3f,ok\n", bench->name, size,
+                        result.reps, result.median_ns, result.min_ns);
+            fflush(stdout);
+
+            // project the next size with the growth seen so far, at least linear.
+            projected = result.rep_seconds * SIZE_FACTOR;
+            if (previous > 0 && result.rep_seconds > previous * SIZE_FACTOR)
+                projected = result.rep_seconds * (result.rep_seconds / previous);
+            previous = result.rep_seconds;
+            if (size * SIZE_FACTOR <= max_size && projected > budget) {
+                printf("%-28s %10ld   skipped: projected %.1f s per repetition\n",
+                       bench->name, size * SIZE_FACTOR, projected);
+                if (csv != NULL)
+                    fprintf(csv, "%s,%ld,0,,,skipped\n", bench->name, size * SIZE_FACTOR);
+                break;
+            }
+        }
+    }
+
+    if (csv != NULL && fclose(csv) != 0) {
+        fprintf(stderr, "%s: %s\n", csv_path, strerror(errno));
+        return errno;
+    }
+    return 0;
+}
+
+/**
+ * @brief measure one case at one size in a child process.
+ * @param bench the case.
+ * @param size elements of the case.
+ * @param result [out] the measurement.
+ * @return 0 on success; otherwise the signal that killed the child, or -1.
+ */
+static int s_measure_child(const bench_case_st *bench, long size, bench_result_st *result) {
+    int fds[2];
+    pid_t pid;
+    int status;
+    ssize_t length;
+
+    if (pipe(fds) != 0)
+        return -1;
+
+    pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        s_measure(bench, size, result);
+        length = write(fds[1], result, sizeof(*result));
+        _exit(length == sizeof(*result) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    length = read(fds[0], result, sizeof(*result));
+    close(fds[0]);
+
+    if (waitpid(pid, &status, 0) < 0)
+        return -1;
+    if (WIFSIGNALED(status))
+        return WTERMSIG(status);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || length != sizeof(*result))
+        return -1;
+    return 0;
+}
+
+/**
+ * @brief measure one case at one size, in the calling process.
+ * @param bench the case.
+ * @param size elements of the case.
+ * @param result [out] the measurement.
+ */
+static void s_measure(const bench_case_st *bench, long size, bench_result_st *result) {
+    double *samples;
+    double total = 0;
+    double start;
+    void *state;
+    long reps;
+
+    samples = (double *)malloc((s_max_reps + MIN_REPS) * sizeof(double));
+    if (samples == NULL)
+        exit(ENOMEM);
+
+    // warm up: page in the allocator, the code and the caches.
+    state = bench->setup(size);
+    bench->run(state, size);
+    if (bench->teardown != NULL)
+        bench->teardown(state);
+
+    for (reps = 0; (reps < s_max_reps || reps < MIN_REPS) && (reps < MIN_REPS || total < s_min_time); reps++) {
+        state = bench->setup(size);
+        start = s_now();
+        bench->run(state, size);
+        samples[reps] = s_now() - start;
+        total += samples[reps];
+        if (bench->teardown != NULL)
+            bench->teardown(state);
+    }
+
+    qsort(samples, reps, sizeof(double), s_compare);
+    result->rep_seconds = samples[reps / 2];
+    result->median_ns = samples[reps / 2] * 1e9 / size;
+    result->min_ns = samples[0] * 1e9 / size;
+    result->reps = reps;
+    free(samples);
+}
+
+/**
+ * @brief get the seconds of CLOCK_MONOTONIC.
+ * @return seconds.
+ */
+static double s_now() {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/**
+ * @brief compare two doubles for qsort.
+ * @return <0, 0 or >0.
+ */
+static int s_compare(const void *left, const void *right) {
+    double l = *(const double *)left;
+    double r = *(const double *)right;
+
+    return (l > r) - (l < r);
+}
+
+/**
+ * @brief output the usage information about the benchmark.
+ */
+static void s_usage() {
+    printf("Usage:\n");
+    printf("./ten-bench-utils [options]\n");
+    printf("e.g ./ten-bench-utils --filter symbol_table --max-size 100000\n");
+    printf("Options:\n");
+    printf("  --min-size <n>              smallest size, default %d\n", DEFAULT_MIN_SIZE);
+    printf("  --max-size <n>              largest size, default %d, sizes grow by %d\n",
+                                          DEFAULT_MAX_SIZE, SIZE_FACTOR);
+    printf("  --min-time <sec>            time spent on repetitions per size, default %.1f\n",
+                                          DEFAULT_MIN_TIME);
+    printf("  --max-reps <n>              repetitions per size at most, default %d\n",
+                                          DEFAULT_MAX_REPS);
+    printf("  --budget <sec>              skip sizes projected over sec per repetition,\n");
+    printf("                              default %.1f\n", DEFAULT_BUDGET);
+    printf("  --filter <text>             only the cases whose name has text\n");
+    printf("  --csv <file>                also write the results as CSV\n");
+}
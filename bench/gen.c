@@ -0,0 +1,59 @@
+/**
+ * @file gen.c
+ * @brief Purpose: write a benchmark workload program to stdout.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+
+#include "workload.h"
+
+/**
+ * @brief output the usage information about the generator.
+ */
+static void s_usage();
+
+/**
+ * @brief main entrance of the generator.
+ * @param argc arguments count.
+ * @param argv arguments vector.
+ * @return 0 on success; otherwise errno.
+ */
+int main(int argc, char *argv[])
+{
+    const workload_st *workload;
+    long size;
+
+    if (argc != 2) {
+        s_usage();
+        return EINVAL;
+    }
+
+    workload = workload_parse(argv[1], &size);
+    if (workload == NULL) {
+        s_usage();
+        return EINVAL;
+    }
+
+    workload->generate(stdout, size);
+    return fflush(stdout) == 0 ? 0 : errno;
+}
+
+/**
+ * @brief output the usage information about the generator.
+ */
+static void s_usage() {
+    const workload_st *workloads;
+    int count;
+    int i;
+
+    workloads = workload_list(&count);
+
+    printf("Usage:\n");
+    printf("./ten-gen <workload>:<size>\n");
+    printf("e.g ./ten-gen loops:4 > loops.ten\n");
+    printf("Workloads:\n");
+    for (i = 0; i < count; i++)
+        printf("  %-8s size is %s\n", workloads[i].name, workloads[i].size_meaning);
+}
@@ -0,0 +1,332 @@
+/**
+ * @file workload.c
+ * @brief Purpose: generate TEN programs of a given shape and size for benchmarks.
+ *
+ * Every program prints a checksum at the end, so a broken engine change shows
+ * up as a different output. Identifiers are letters only, as the grammar
+ * wants, variable n is named by n in base 26, e.g. "va", "vb", ..., "vba".
+ *
+ * The "statements", "nesting" and "expression" workloads are sized in bytes
+ * of source, for the compiler scaling benchmark; every unit of them has a
+ * fixed width, so the source grows linearly with the size.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "workload.h"
+
+#define LOOP_TRIPS          (8)                     /**< iterations of each nested loop */
+#define REPEAT_TRIPS        (1000)                  /**< iterations around a straight workload */
+#define NAME_SIZE           (16)                    /**< longest generated identifier */
+
+#define STATEMENT           "sum is (sum + %ld) %% 1000000;\n"     /**< one statement, %ld is a digit */
+#define NEST_OPEN           "if (i >= 0) then {\n"                 /**< one level of nesting, opened */
+#define NEST_CLOSE          "} else {\nsum is sum + 2;\n};\n"      /**< one level of nesting, closed */
+#define EXPRESSION_LINE     (8)                     /**< terms per line of a long expression */
+
+/**
+ * @brief name the n-th variable.
+ * @param n index of the variable.
+ * @param name [out] the identifier, NAME_SIZE bytes.
+ * @return name.
+ */
+static char *s_name(long, char *);
+
+/**
+ * @brief nested for loops, LOOP_TRIPS iterations each, counting the innermost body.
+ * @param fout output stream.
+ * @param depth depth of the nest.
+ */
+static void s_nested_loops(FILE *, long);
+
+/**
+ * @brief one long arithmetic expression, evaluated REPEAT_TRIPS times.
+ * @param fout output stream.
+ * @param terms terms of the expression.
+ */
+static void s_long_expression(FILE *, long);
+
+/**
+ * @brief many variables declared, set and summed in the scope of a loop body.
+ * @param fout output stream.
+ * @param count variables in the scope.
+ */
+static void s_many_variables(FILE *, long);
+
+/**
+ * @brief deeply nested if statements, evaluated REPEAT_TRIPS times.
+ * @param fout output stream.
+ * @param depth depth of the nest.
+ */
+static void s_nested_if(FILE *, long);
+
+/**
+ * @brief a loop printing one line per iteration.
+ * @param fout output stream.
+ * @param lines lines printed.
+ */
+static void s_output_loop(FILE *, long);
+
+/**
+ * @brief a long straight list of statements.
+ * @param fout output stream.
+ * @param bytes size of the source, about.
+ */
+static void s_statement_list(FILE *, long);
+
+/**
+ * @brief nested if statements, as deep as the size allows.
+ * @param fout output stream.
+ * @param bytes size of the source, about.
+ */
+static void s_deep_nesting(FILE *, long);
+
+/**
+ * @brief one assignment of an expression, as long as the size allows.
+ * @param fout output stream.
+ * @param bytes size of the source, about.
+ */
+static void s_huge_expression(FILE *, long);
+
+static const workload_st s_workloads[] = {
+    { "loops",  "loop nesting depth",       s_nested_loops },
+    { "expr",   "terms per expression",     s_long_expression },
+    { "vars",   "variables per scope",      s_many_variables },
+    { "ifs",    "if nesting depth",         s_nested_if },
+    { "output", "lines printed",            s_output_loop },
+    { "statements", "bytes of statements",  s_statement_list },
+    { "nesting", "bytes of nested ifs",     s_deep_nesting },
+    { "expression", "bytes of expression",  s_huge_expression },
+};
+
+/**
+ * @brief look up a workload.
+ * @param name name of the workload.
+ * @return NULL if not found; otherwise the workload.
+ */
+const workload_st *workload_find(const char *name) {
+    size_t i;
+
+    for (i = 0; i < sizeof(s_workloads) / sizeof(s_workloads[0]); i++) {
+        if (strcmp(s_workloads[i].name, name) == 0)
+            return &(s_workloads[i]);
+    }
+    return NULL;
+}
+
+/**
+ * @brief get all workloads.
+ * @param count [out] number of workloads.
+ * @return array of the workloads.
+ */
+const workload_st *workload_list(int *count) {
+    *count = sizeof(s_workloads) / sizeof(s_workloads[0]);
+    return s_workloads;
+}
+
+/**
+ * @brief parse a workload spec, "name:size".
+ * @param spec the spec.
+ * @param size [out] size of the workload.
+ * @return NULL on invalid spec; otherwise the workload.
+ */
+const workload_st *workload_parse(const char *spec, long *size) {
+    char name[NAME_SIZE];
+    const char *colon;
+    char *end = NULL;
+
+    colon = strchr(spec, ':');
+    if (colon == NULL || colon - spec >= NAME_SIZE)
+        return NULL;
+
+    *size = strtol(colon + 1, &end, 10);
+    // sizes in bytes are easier with a suffix, e.g. "statements:64M".
+    if (*end == 'K' || *end == 'M' || *end == 'G') {
+        *size <<= (*end == 'K' ? 10 : *end == 'M' ? 20 : 30);
+        end++;
+    }
+    if (colon[1] == '\0' || *end != '\0' || *size < 1)
+        return NULL;
+
+    snprintf(name, sizeof(name), "%.*s", (int)(colon - spec), spec);
+    return workload_find(name);
+}
+
+/**
+ * @brief name the n-th variable.
+ * @param n index of the variable.
+ * @param name [out] the identifier, NAME_SIZE bytes.
+ * @return name.
+ */
+static char *s_name(long n, char *name) {
+    char digits[NAME_SIZE];
+    int length = 0;
+    int i;
+
+    do {
+        digits[length++] = 'a' + n % 26;
+        n /= 26;
+    } while (n > 0 && length < NAME_SIZE - 2);
+
+    name[0] = 'v';
+    for (i = 0; i < length; i++)
+        name[i + 1] = digits[length - 1 - i];
+    name[length + 1] = '\0';
+    return name;
+}
+
+/**
+ * @brief nested for loops, LOOP_TRIPS iterations each, counting the innermost body.
+ * @param fout output stream.
+ * @param depth depth of the nest.
+ */
+static void s_nested_loops(FILE *fout, long depth) {
+    char name[NAME_SIZE];
+    long i;
+
+    fprintf(fout, "var sum;\nsum is 0;\n");
+    for (i = 0; i < depth; i++)
+        fprintf(fout, "var %s;\n", s_name(i, name));
+
+    for (i = 0; i < depth; i++)
+        fprintf(fout, "%*sfor %s from 0 to %d step %s + 1 {\n", (int)i * 4, "",
+                      s_name(i, name), LOOP_TRIPS, name);
+    fprintf(fout, "%*ssum is sum + 1;\n", (int)depth * 4, "");
+    for (i = depth - 1; i >= 0; i--)
+        fprintf(fout, "%*s};\n", (int)i * 4, "");
+
+    fprintf(fout, "print sum;\n");
+}
+
+/**
+ * @brief one long arithmetic expression, evaluated REPEAT_TRIPS times.
+ * @param fout output stream.
+ * @param terms terms of the expression.
+ */
+static void s_long_expression(FILE *fout, long terms) {
+    static const char operators[] = { '+', '-', '*', '%' };
+    long i;
+
+    fprintf(fout, "var i;\nvar x;\nvar sum;\nsum is 0;\n");
+    fprintf(fout, "for i from 0 to %d step i + 1 {\n", REPEAT_TRIPS);
+    fprintf(fout, "    x is i");
+    // the products stay small, "% 7" keeps the sum from overflowing.
+    for (i = 1; i < terms; i++) {
+        if (operators[i % 4] == '%')
+            fprintf(fout, " %% 7");
+        else
+            fprintf(fout, " %c (i + %ld)", operators[i % 4], i % 10);
+    }
+    fprintf(fout, ";\n    sum is (sum + x) %% 1000000;\n};\nprint sum;\n");
+}
+
+/**
+ * @brief many variables declared, set and summed in the scope of a loop body.
+ * @param fout output stream.
+ * @param count variables in the scope.
+ */
+static void s_many_variables(FILE *fout, long count) {
+    char name[NAME_SIZE];
+    long i;
+
+    fprintf(fout, "var i;\nvar sum;\nsum is 0;\n");
+    fprintf(fout, "for i from 0 to %d step i + 1 {\n", REPEAT_TRIPS / 10);
+    for (i = 0; i < count; i++)
+        fprintf(fout, "    var %s;\n    %s is i + %ld;\n", s_name(i, name), name, i);
+    // the first variables are the farthest ones for a lookup.
+    for (i = 0; i < count; i++)
+        fprintf(fout, "    sum is (sum + %s) %% 1000000;\n", s_name(i, name));
+    fprintf(fout, "};\nprint sum;\n");
+}
+
+/**
+ * @brief deeply nested if statements, evaluated REPEAT_TRIPS times.
+ * @param fout output stream.
+ * @param depth depth of the nest.
+ */
+static void s_nested_if(FILE *fout, long depth) {
+    long i;
+
+    fprintf(fout, "var i;\nvar sum;\nsum is 0;\n");
+    fprintf(fout, "for i from 0 to %d step i + 1 {\n", REPEAT_TRIPS);
+    for (i = 0; i < depth; i++) {
+        fprintf(fout, "%*sif (i >= %ld) then {\n", (int)(i + 1) * 4, "",
+                      i * REPEAT_TRIPS / (depth * 2));
+    }
+    fprintf(fout, "%*ssum is sum + 1;\n", (int)(depth + 1) * 4, "");
+    for (i = depth - 1; i >= 0; i--)
+        fprintf(fout, "%*s} else {\n%*ssum is sum + 2;\n%*s};\n",
+                      (int)(i + 1) * 4, "", (int)(i + 2) * 4, "", (int)(i + 1) * 4, "");
+    fprintf(fout, "};\nprint sum;\n");
+}
+
+/**
+ * @brief a loop printing one line per iteration.
+ * @param fout output stream.
+ * @param lines lines printed.
+ */
+static void s_output_loop(FILE *fout, long lines) {
+    fprintf(fout, "var i;\n");
+    fprintf(fout, "for i from 0 to %ld step i + 1 {\n    print i;\n};\n", lines);
+}
+
+/**
+ * @brief a long straight list of statements.
+ * @param fout output stream.
+ * @param bytes size of the source, about.
+ */
+static void s_statement_list(FILE *fout, long bytes) {
+    long count;
+    long i;
+
+    // "%ld" is one digit, "%%" is one byte.
+    count = bytes / (long)(sizeof(STATEMENT) - 4);
+    fprintf(fout, "var sum;\nsum is 0;\n");
+    for (i = 0; i < count; i++)
+        fprintf(fout, STATEMENT, i % 10);
+    fprintf(fout, "print sum;\n");
+}
+
+/**
+ * @brief nested if statements, as deep as the size allows.
+ * @param fout output stream.
+ * @param bytes size of the source, about.
+ */
+static void s_deep_nesting(FILE *fout, long bytes) {
+    long depth;
+    long i;
+
+    // the nest is not indented, the indentation would grow the source quadratically.
+    depth = bytes / (long)(sizeof(NEST_OPEN) - 1 + sizeof(NEST_CLOSE) - 1);
+    fprintf(fout, "var i;\nvar sum;\ni is 1;\nsum is 0;\n");
+    for (i = 0; i < depth; i++)
+        fputs(NEST_OPEN, fout);
+    fprintf(fout, "sum is sum + 1;\n");
+    for (i = 0; i < depth; i++)
+        fputs(NEST_CLOSE, fout);
+    fprintf(fout, "print sum;\n");
+}
+
+/**
+ * @brief one assignment of an expression, as long as the size allows.
+ * @param fout output stream.
+ * @param bytes size of the source, about.
+ */
+static void s_huge_expression(FILE *fout, long bytes) {
+    static const char *terms[] = { " + (x * 3)", " - (x % 7)", " * (x + 1)", " % (x + 9)" };
+    long count;
+    long i;
+
+    // every term is 10 bytes, plus a new line every EXPRESSION_LINE terms.
+    count = bytes / 10;
+    fprintf(fout, "var x;\nvar y;\nx is 5;\ny is x");
+    for (i = 0; i < count; i++) {
+        fputs(terms[i % 4], fout);
+        if (i % EXPRESSION_LINE == EXPRESSION_LINE - 1)
+            fputc('\n', fout);
+    }
+    fprintf(fout, ";\nprint y;\n");
+}
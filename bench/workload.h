@@ -0,0 +1,47 @@
+/**
+ * @file workload.h
+ * @brief Purpose: generate TEN programs of a given shape and size for benchmarks.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __WORKLOAD_H__
+#define __WORKLOAD_H__
+
+#include <stdio.h>
+
+/**
+ * @brief write a workload program.
+ * @param fout output stream.
+ * @param size size of the workload, its meaning depends on the workload.
+ */
+typedef void (*workload_cb)(FILE *, long);
+
+typedef struct workload {
+    const char *name;                               /**< name on the command line */
+    const char *size_meaning;                       /**< what the size is */
+    workload_cb generate;                           /**< generator of the program */
+} workload_st;
+
+/**
+ * @brief look up a workload.
+ * @param name name of the workload.
+ * @return NULL if not found; otherwise the workload.
+ */
+const workload_st *workload_find(const char *);
+
+/**
+ * @brief get all workloads.
+ * @param count [out] number of workloads.
+ * @return array of the workloads.
+ */
+const workload_st *workload_list(int *);
+
+/**
+ * @brief parse a workload spec, "name:size".
+ * @param spec the spec.
+ * @param size [out] size of the workload.
+ * @return NULL on invalid spec; otherwise the workload.
+ */
+const workload_st *workload_parse(const char *, long *);
+
+#endif
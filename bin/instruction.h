@@ -0,0 +1,252 @@
+/**
+ * @file instruction.h
+ * @brief Purpose: declaration of the machine instruction.
+ * @version 1.0
+ * @date 04.23.2017
+ * @author Xiangyu Guo
+ */
+#ifndef __INSTRUCTION_H__
+#define __INSTRUCTION_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define INSTRUCTION_LOAD_EAGER      (0)             /**< decode all instructions on load */
+#define INSTRUCTION_LOAD_LAZY       (1)             /**< decode an instruction on first fetch */
+
+#define OPERAND_FIRST               (0)             /**< first operand of an instruction */
+#define OPERAND_SECOND              (1)             /**< second operand of an instruction */
+
+#define INSTRUCTION_NO_TARGET       (-1)            /**< jump target doesn't exist */
+
+typedef struct instruction instruction_st;
+struct instruction;
+
+typedef struct instruction_set instruction_set_st;
+struct instruction_set;
+
+/**
+ * @brief decoded operation of an instruction, labels are scope operations.
+ */
+enum op_type {
+    OP_DEC = 0,
+    OP_MOV,
+    OP_OUT,
+    OP_ADD,
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,
+    OP_MOD,
+    OP_CMP,
+    OP_JE,
+    OP_JNE,
+    OP_JL,
+    OP_JLE,
+    OP_JG,
+    OP_JGE,
+    OP_JMP,
+    OP_SCOPE_OPEN,                                  /**< label, e.g. "for1:" */
+    OP_SCOPE_CLOSE,                                 /**< end label, e.g. "for1_end:" */
+    OP_COUNT
+};
+
+/**
+ * @brief decoded kind of an operand.
+ */
+enum operand_kind {
+    OPERAND_NONE = 0,                               /**< operand doesn't exist */
+    OPERAND_VARIABLE,                               /**< variable name */
+    OPERAND_IMMEDIATE,                              /**< integer value */
+};
+
+/**
+ * @brief a pre-decoded instruction, the element of an embedded program image.
+ */
+typedef struct instruction_image_entry {
+    int op_type;                                    /**< decoded operation code */
+    const char *op_code;                            /**< operation code */
+    const char *op_first;                           /**< first operands */
+    const char *op_second;                          /**< second operands */
+    int kinds[2];                                   /**< decoded kind of operands */
+    int values[2];                                  /**< decoded value of immediate operands */
+    int target;                                     /**< resolved jump target */
+} instruction_image_entry_st;
+
+/**
+ * @brief a pre-decoded program, generated by "runtime --emit-c".
+ */
+typedef struct instruction_image {
+    int count;                                      /**< total of instructions */
+    const instruction_image_entry_st *entries;      /**< all instructions */
+} instruction_image_st;
+
+/**
+ * @brief load an ASM program into the runtime.
+ * @param file_path path of asm file.
+ * @param mode INSTRUCTION_LOAD_EAGER or INSTRUCTION_LOAD_LAZY.
+ * @param threads most threads used for loading, 1 for loading on the caller.
+ * @return instruct_set loaded instruction sequence.
+ */
+instruction_set_st *instruction_load_program(const char *, int, int);
+
+/**
+ * @brief load a pre-decoded program image, nothing is parsed.
+ * @param image a valid program image.
+ * @return instruct_set loaded instruction sequence.
+ */
+instruction_set_st *instruction_load_image(const instruction_image_st *);
+
+/**
+ * @brief write the decoded program as C source of an instruction_image_st.
+ * @param instruction_set a valid instruction_set object.
+ * @param fout output stream.
+ * @param symbol name of the image object.
+ * @return 0 on success; otherwise errno.
+ */
+int instruction_set_emit_c(instruction_set_st *, FILE *, const char *);
+
+/**
+ * @brief clean up the instruction set.
+ * @param instructions, a valid instruction set object.
+ */
+void instruction_clean_up(instruction_set_st *);
+
+/**
+ * @brief get next instruction from instruction set
+ * @param instruction_set a valid instruction_set object.
+ * @return NULL, failed or no more instructions; otherwise a pointer to the instruction.
+ */
+instruction_st *instruction_set_get_instruction(instruction_set_st *);
+
+/**
+ * @brief get the total of instructions.
+ * @param instruction_set a valid instruction_set object.
+ * @return count of instructions.
+ */
+int instruction_set_get_count(instruction_set_st *);
+
+/**
+ * @brief get the total of labels defined in the program.
+ * @param instruction_set a valid instruction_set object.
+ * @return count of labels, 0 for a program image.
+ */
+int instruction_set_get_label_count(instruction_set_st *);
+
+/**
+ * @brief get the total of jumps resolved to a label so far,
+ *        instructions not decoded yet are not counted.
+ * @param instruction_set a valid instruction_set object.
+ * @return count of resolved jumps.
+ */
+int instruction_set_get_resolved_count(instruction_set_st *);
+
+/**
+ * @brief get an instruction by its address, the program counter stays.
+ * @param instruction_set a valid instruction_set object.
+ * @param address address of the instruction, from 0 to count - 1.
+ * @return NULL on invalid address; otherwise a pointer to the instruction.
+ */
+instruction_st *instruction_set_get_address(instruction_set_st *, int);
+
+/**
+ * @brief set a new program counter
+ * @param instruction_set a valid instruction_set object.
+ * @param new_pc new program counter address.
+ */
+void instruction_set_set_pc(instruction_set_st *, int);
+
+/**
+ * @brief get current program counter
+ * @param instruction_set a valid instruction_set object.
+ * @return program counter, address of the next instruction.
+ */
+int instruction_set_get_pc(instruction_set_st *);
+
+/**
+ * @brief get the identity of the loaded program
+ * @param instruction_set a valid instruction_set object.
+ * @return hash value over all instructions of the program.
+ */
+uint64_t instruction_set_get_hash(instruction_set_st *);
+
+/**
+ * @brief get the comparision result
+ * @param instruction_set a valid instruction_set object.
+ * @return flag value.
+ */
+int instruction_set_get_flag(instruction_set_st *);
+
+/**
+ * @brief set a new comparision result
+ * @param instruction_set a valid instruction_set object.
+ * @param new_flag new flag value.
+ */
+void instruction_set_set_flag(instruction_set_st *, int);
+
+/**
+ * @brief look up a label address.
+ * @param instruction_st a valid instruction_set object.
+ * @param label, the label string going to lookup.
+ * @return a valid address for program counter, if label doesn't exist, exit.
+ */
+unsigned int instruction_set_get_label(instruction_set_st *, char *);
+
+/**
+ * @brief get operation code from an instruction.
+ * @param instruction, a valid instruction object.
+ * @return op_code, operation code
+ */
+char *instruction_get_op_code(instruction_st *);
+
+/**
+ * @brief get operation code from an instruction.
+ * @param instruction, a valid instruction object.
+ * @return operand, first operand
+ */
+char *instruction_get_op_first(instruction_st *);
+
+/**
+ * @brief get operation code from an instruction.
+ * @param instruction, a valid instruction object.
+ * @return operand, second operand
+ */
+char *instruction_get_op_second(instruction_st *);
+
+/**
+ * @brief get decoded operation from an instruction.
+ * @param instruction, a valid instruction object.
+ * @return op_type, one of enum op_type.
+ */
+int instruction_get_op_type(instruction_st *);
+
+/**
+ * @brief get decoded kind of an operand.
+ * @param instruction, a valid instruction object.
+ * @param which, OPERAND_FIRST or OPERAND_SECOND.
+ * @return operand_kind, one of enum operand_kind.
+ */
+int instruction_get_operand_kind(instruction_st *, int);
+
+/**
+ * @brief get decoded value of an immediate operand.
+ * @param instruction, a valid instruction object.
+ * @param which, OPERAND_FIRST or OPERAND_SECOND.
+ * @return value of the operand, 0 if it is not an immediate.
+ */
+int instruction_get_operand_value(instruction_st *, int);
+
+/**
+ * @brief get resolved jump target of an instruction.
+ * @param instruction, a valid instruction object.
+ * @return address of the target, INSTRUCTION_NO_TARGET if the label doesn't exist.
+ */
+int instruction_get_target(instruction_st *);
+
+/**
+ * @brief get the name of an operation.
+ * @param op_type one of enum op_type.
+ * @return name of the operation, e.g. "MOV".
+ */
+const char *instruction_op_name(int);
+
+#endif
@@ -1,8 +1,8 @@
 mkdir bin
 cd src/compiler
-make
+make $1
 cp compiler ../../bin/
 cd ../runtime
-make
+make $1
 cp runtime ../../bin/
-
+cp libtenrt.a instruction.h trace-analyze ../../bin/
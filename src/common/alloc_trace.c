@@ -0,0 +1,440 @@
+/**
+ * @file alloc_trace.c
+ * @brief Purpose: count the heap allocations of the compiler and the runtime
+ *        by call site, in an opt-in build.
+ *
+ * Each call site ("file:line function") keeps its calls, bytes, live blocks,
+ * live bytes and peak live bytes. Live blocks are found again on free and
+ * realloc through a table from address to site. The tables are mapped with
+ * mmap, so they don't count themselves, and a spin lock guards them for the
+ * threads of the parallel loader. Blocks the C library allocated (getline)
+ * are unknown to the table and freed as they are.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/mman.h>
+
+#include "alloc_trace.h"
+
+// the functions below call the allocator itself.
+#undef malloc
+#undef calloc
+#undef realloc
+#undef strdup
+#undef free
+
+#define ALLOC_TRACE_MAX_SITES   (1024)              /**< call sites kept, a power of 2 */
+#define ALLOC_TRACE_MIN_BLOCKS  (1 << 16)           /**< slots of the block table at first */
+#define ALLOC_TRACE_TOMBSTONE   ((void *)1)         /**< slot of a freed block */
+
+enum alloc_function {
+    ALLOC_MALLOC = 0,
+    ALLOC_CALLOC,
+    ALLOC_REALLOC,
+    ALLOC_STRDUP,
+    ALLOC_FUNCTION_COUNT,
+};
+
+typedef struct alloc_site {
+    const char *file;                               /**< source file, NULL for a free slot */
+    int line;                                       /**< source line */
+    int function;                                   /**< enum alloc_function */
+    uint64_t calls;                                 /**< calls made */
+    uint64_t bytes;                                 /**< bytes asked for */
+    uint64_t live;                                  /**< blocks not freed yet */
+    uint64_t live_bytes;                            /**< bytes not freed yet */
+    uint64_t peak_bytes;                            /**< peak of live_bytes */
+} alloc_site_st;
+
+typedef struct alloc_block {
+    void *ptr;                                      /**< address, NULL for empty */
+    size_t size;                                    /**< bytes of the block */
+    int site;                                       /**< index of the site */
+} alloc_block_st;
+
+static const char *s_function_names[ALLOC_FUNCTION_COUNT] = {
+    [ALLOC_MALLOC]  = "malloc",
+    [ALLOC_CALLOC]  = "calloc",
+    [ALLOC_REALLOC] = "realloc",
+    [ALLOC_STRDUP]  = "strdup",
+};
+
+static alloc_site_st s_sites[ALLOC_TRACE_MAX_SITES]; /**< sites by hash of file and line */
+static int s_site_count;                            /**< sites in use */
+static alloc_block_st *s_blocks;                    /**< live blocks by hash of address */
+static size_t s_block_capacity;                     /**< slots of s_blocks, a power of 2 */
+static size_t s_block_used;                         /**< slots live or freed */
+static uint64_t s_live_bytes;                       /**< bytes not freed yet, all sites */
+static uint64_t s_peak_bytes;                       /**< peak of s_live_bytes */
+static volatile char s_lock;                        /**< guards everything above */
+static int s_registered;                            /**< 1 once the report is set to run at exit */
+
+/**
+ * @brief count one allocation of a site, with the lock held.
+ * @param ptr the block allocated.
+ * @param size bytes of the block.
+ * @param file source file of the call.
+ * @param line source line of the call.
+ * @param function enum alloc_function.
+ */
+static void s_record(void *, size_t, const char *, int, int);
+
+/**
+ * @brief forget a block and release it from its site, with the lock held.
+ * @param ptr the block.
+ */
+static void s_release(void *);
+
+/**
+ * @brief find the slot of a block, or the empty slot to put it.
+ * @param ptr the block.
+ * @return index of the slot.
+ */
+static size_t s_block_slot(void *);
+
+/**
+ * @brief double the block table, dropping the freed slots.
+ * @return 0 on success; otherwise ENOMEM.
+ */
+static int s_block_grow();
+
+/**
+ * @brief write the report at exit.
+ */
+static void s_report();
+
+/**
+ * @brief compare two sites by calls, then by bytes, both descending.
+ * @param a a site.
+ * @param b a site.
+ * @return the order.
+ */
+static int s_site_compare(const void *, const void *);
+
+/**
+ * @brief take the lock.
+ */
+static inline void s_lock_take() {
+    while (__atomic_test_and_set(&s_lock, __ATOMIC_ACQUIRE))
+        ;
+}
+
+/**
+ * @brief give the lock back.
+ */
+static inline void s_lock_give() {
+    __atomic_clear(&s_lock, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief malloc, counted on its call site.
+ * @param size bytes to allocate.
+ * @param file source file of the call.
+ * @param line source line of the call.
+ * @return as malloc.
+ */
+void *alloc_trace_malloc(size_t size, const char *file, int line) {
+    void *ptr = malloc(size);
+
+    if (ptr != NULL) {
+        s_lock_take();
+        s_record(ptr, size, file, line, ALLOC_MALLOC);
+        s_lock_give();
+    }
+    return ptr;
+}
+
+/**
+ * @brief calloc, counted on its call site.
+ * @param count number of elements.
+ * @param size bytes of an element.
+ * @param file source file of the call.
+ * @param line source line of the call.
+ * @return as calloc.
+ */
+void *alloc_trace_calloc(size_t count, size_t size, const char *file, int line) {
+    void *ptr = calloc(count, size);
+
+    if (ptr != NULL) {
+        s_lock_take();
+        s_record(ptr, count * size, file, line, ALLOC_CALLOC);
+        s_lock_give();
+    }
+    return ptr;
+}
+
+/**
+ * @brief realloc, counted on its call site, the old block is released from its own.
+ * @param ptr block to resize, NULL allowed.
+ * @param size new size in bytes.
+ * @param file source file of the call.
+ * @param line source line of the call.
+ * @return as realloc.
+ */
+void *alloc_trace_realloc(void *ptr, size_t size, const char *file, int line) {
+    void *new_ptr;
+
+    // the old block is released first, its address may be reused at once.
+    s_lock_take();
+    s_release(ptr);
+    s_lock_give();
+
+    new_ptr = realloc(ptr, size);
+
+    // on failure the old block stays, unknown to the table like a block of the C library.
+    if (new_ptr != NULL) {
+        s_lock_take();
+        s_record(new_ptr, size, file, line, ALLOC_REALLOC);
+        s_lock_give();
+    }
+    return new_ptr;
+}
+
+/**
+ * @brief strdup, counted on its call site.
+ * @param str string to copy.
+ * @param file source file of the call.
+ * @param line source line of the call.
+ * @return as strdup.
+ */
+char *alloc_trace_strdup(const char *str, const char *file, int line) {
+    char *copy = strdup(str);
+
+    if (copy != NULL) {
+        s_lock_take();
+        s_record(copy, strlen(copy) + 1, file, line, ALLOC_STRDUP);
+        s_lock_give();
+    }
+    return copy;
+}
+
+/**
+ * @brief free, the block is released from the site that allocated it.
+ * @param ptr block to free, NULL allowed, blocks of the C library are passed through.
+ */
+void alloc_trace_free(void *ptr) {
+    if (ptr == NULL)
+        return;
+
+    s_lock_take();
+    s_release(ptr);
+    s_lock_give();
+    free(ptr);
+}
+
+/**
+ * @brief count one allocation of a site, with the lock held.
+ * @param ptr the block allocated.
+ * @param size bytes of the block.
+ * @param file source file of the call.
+ * @param line source line of the call.
+ * @param function enum alloc_function.
+ */
+static void s_record(void *ptr, size_t size, const char *file, int line, int function) {
+    alloc_site_st *site;
+    alloc_block_st *block;
+    uintptr_t hash;
+    size_t slot;
+    int index;
+
+    if (!s_registered) {
+        s_registered = 1;
+        atexit(s_report);
+    }
+
+    // a site is one call in one file, __FILE__ is the same string all over the file.
+    hash = ((uintptr_t)file >> 3) * 31 + line;
+    index = (int)(hash * 2654435761u) & (ALLOC_TRACE_MAX_SITES - 1);
+    while (s_sites[index].file != NULL &&
+           (s_sites[index].file != file || s_sites[index].line != line ||
+            s_sites[index].function != function)) {
+        index = (index + 1) & (ALLOC_TRACE_MAX_SITES - 1);
+        // the table is full, an extra site adds up on the one it lands on.
+        if (s_site_count == ALLOC_TRACE_MAX_SITES)
+            break;
+    }
+    site = &(s_sites[index]);
+    if (site->file == NULL) {
+        site->file = file;
+        site->line = line;
+        site->function = function;
+        s_site_count++;
+    }
+
+    site->calls++;
+    site->bytes += size;
+    site->live++;
+    site->live_bytes += size;
+    if (site->live_bytes > site->peak_bytes)
+        site->peak_bytes = site->live_bytes;
+    s_live_bytes += size;
+    if (s_live_bytes > s_peak_bytes)
+        s_peak_bytes = s_live_bytes;
+
+    if ((s_block_used + 1) * 2 > s_block_capacity && s_block_grow() != 0)
+        return;
+    slot = s_block_slot(ptr);
+    block = &(s_blocks[slot]);
+    if (block->ptr == ptr) {
+        // allocated behind our back and freed the same way, drop the stale entry.
+        s_sites[block->site].live--;
+        s_sites[block->site].live_bytes -= block->size;
+        s_live_bytes -= block->size;
+    } else {
+        s_block_used++;
+    }
+    block->ptr = ptr;
+    block->size = size;
+    block->site = index;
+}
+
+/**
+ * @brief forget a block and release it from its site, with the lock held.
+ * @param ptr the block.
+ */
+static void s_release(void *ptr) {
+    alloc_block_st *block;
+
+    if (ptr == NULL || s_blocks == NULL)
+        return;
+
+    block = &(s_blocks[s_block_slot(ptr)]);
+    if (block->ptr != ptr)
+        return;
+
+    s_sites[block->site].live--;
+    s_sites[block->site].live_bytes -= block->size;
+    s_live_bytes -= block->size;
+    block->ptr = ALLOC_TRACE_TOMBSTONE;
+}
+
+/**
+ * @brief find the slot of a block, or the empty slot to put it.
+ * @param ptr the block.
+ * @return index of the slot.
+ */
+static size_t s_block_slot(void *ptr) {
+    size_t mask = s_block_capacity - 1;
+    size_t slot = (((uintptr_t)ptr >> 4) * 11400714819323198485ull) >> 20 & mask;
+    size_t tombstone = SIZE_MAX;
+
+    while (s_blocks[slot].ptr != NULL && s_blocks[slot].ptr != ptr) {
+        if (s_blocks[slot].ptr == ALLOC_TRACE_TOMBSTONE && tombstone == SIZE_MAX)
+            tombstone = slot;
+        slot = (slot + 1) & mask;
+    }
+    if (s_blocks[slot].ptr == NULL && tombstone != SIZE_MAX)
+        return tombstone;
+    return slot;
+}
+
+/**
+ * @brief double the block table, dropping the freed slots.
+ * @return 0 on success; otherwise ENOMEM.
+ */
+static int s_block_grow() {
+    alloc_block_st *old_blocks = s_blocks;
+    size_t old_capacity = s_block_capacity;
+    size_t live = 0;
+    size_t i;
+
+    for (i = 0; i < old_capacity; i++)
+        if (old_blocks[i].ptr != NULL && old_blocks[i].ptr != ALLOC_TRACE_TOMBSTONE)
+            live++;
+
+    s_block_capacity = old_capacity ? old_capacity : ALLOC_TRACE_MIN_BLOCKS;
+    while ((live + 1) * 4 > s_block_capacity)
+        s_block_capacity *= 2;
+    s_blocks = mmap(NULL, s_block_capacity * sizeof(alloc_block_st), PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (s_blocks == MAP_FAILED) {
+        s_blocks = old_blocks;
+        s_block_capacity = old_capacity;
+        return ENOMEM;
+    }
+
+    s_block_used = 0;
+    for (i = 0; i < old_capacity; i++) {
+        if (old_blocks[i].ptr == NULL || old_blocks[i].ptr == ALLOC_TRACE_TOMBSTONE)
+            continue;
+        s_blocks[s_block_slot(old_blocks[i].ptr)] = old_blocks[i];
+        s_block_used++;
+    }
+    if (old_blocks != NULL)
+        munmap(old_blocks, old_capacity * sizeof(alloc_block_st));
+    return 0;
+}
+
+/**
+ * @brief write the report at exit.
+ */
+static void s_report() {
+    alloc_site_st sites[ALLOC_TRACE_MAX_SITES];
+    const char *path = getenv(ALLOC_TRACE_REPORT_ENV);
+    FILE *fout = stderr;
+    uint64_t calls = 0;
+    uint64_t bytes = 0;
+    uint64_t live = 0;
+    char name[64];
+    int count = 0;
+    int i;
+
+    s_lock_take();
+    for (i = 0; i < ALLOC_TRACE_MAX_SITES; i++) {
+        if (s_sites[i].file == NULL)
+            continue;
+        sites[count++] = s_sites[i];
+        calls += s_sites[i].calls;
+        bytes += s_sites[i].bytes;
+        live += s_sites[i].live;
+    }
+    s_lock_give();
+    qsort(sites, count, sizeof(alloc_site_st), s_site_compare);
+
+    if (path != NULL && *path != '\0') {
+        fout = fopen(path, "a");
+        if (fout == NULL) {
+            fprintf(stderr, "alloc report %s failed: %s\n", path, strerror(errno));
+            return;
+        }
+    }
+
+    fprintf(fout, "allocations %" PRIu64 ", bytes %" PRIu64 ", peak bytes %" PRIu64
+                  ", outstanding %" PRIu64 " (%" PRIu64 " bytes), sites %d\n",
+            calls, bytes, s_peak_bytes, live, s_live_bytes, count);
+    fprintf(fout, "%12s %14s %12s %12s %14s  %s\n",
+            "calls", "bytes", "peak bytes", "outstanding", "out. bytes", "site");
+    for (i = 0; i < count; i++) {
+        snprintf(name, sizeof(name), "%s:%d", sites[i].file, sites[i].line);
+        fprintf(fout, "%12" PRIu64 " %14" PRIu64 " %12" PRIu64 " %12" PRIu64 " %14" PRIu64
+                      "  %s %s\n",
+                sites[i].calls, sites[i].bytes, sites[i].peak_bytes, sites[i].live,
+                sites[i].live_bytes, name, s_function_names[sites[i].function]);
+    }
+
+    if (fout != stderr)
+        fclose(fout);
+}
+
+/**
+ * @brief compare two sites by calls, then by bytes, both descending.
+ * @param a a site.
+ * @param b a site.
+ * @return the order.
+ */
+static int s_site_compare(const void *a, const void *b) {
+    const alloc_site_st *site_a = a;
+    const alloc_site_st *site_b = b;
+
+    if (site_a->calls != site_b->calls)
+        return site_a->calls < site_b->calls ? 1 : -1;
+    if (site_a->bytes != site_b->bytes)
+        return site_a->bytes < site_b->bytes ? 1 : -1;
+    return 0;
+}
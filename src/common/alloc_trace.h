@@ -0,0 +1,82 @@
+/**
+ * @file alloc_trace.h
+ * @brief Purpose: count the heap allocations of the compiler and the runtime
+ *        by call site, in an opt-in build.
+ *
+ * "make alloc" compiles every file with -DALLOC_TRACE and this header forced
+ * in (-include), so malloc, calloc, realloc, strdup and free of the sources
+ * go through the functions below with the file and line of the call. The
+ * report is written at exit, to stderr or appended to $TEN_ALLOC_REPORT.
+ * In the normal build the header defines nothing, and alloc_trace.c is not
+ * linked.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __ALLOC_TRACE_H__
+#define __ALLOC_TRACE_H__
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ALLOC_TRACE_REPORT_ENV      "TEN_ALLOC_REPORT" /**< environment variable of the report path */
+
+/**
+ * @brief malloc, counted on its call site.
+ * @param size bytes to allocate.
+ * @param file source file of the call.
+ * @param line source line of the call.
+ * @return as malloc.
+ */
+void *alloc_trace_malloc(size_t, const char *, int);
+
+/**
+ * @brief calloc, counted on its call site.
+ * @param count number of elements.
+ * @param size bytes of an element.
+ * @param file source file of the call.
+ * @param line source line of the call.
+ * @return as calloc.
+ */
+void *alloc_trace_calloc(size_t, size_t, const char *, int);
+
+/**
+ * @brief realloc, counted on its call site, the old block is released from its own.
+ * @param ptr block to resize, NULL allowed.
+ * @param size new size in bytes.
+ * @param file source file of the call.
+ * @param line source line of the call.
+ * @return as realloc.
+ */
+void *alloc_trace_realloc(void *, size_t, const char *, int);
+
+/**
+ * @brief strdup, counted on its call site.
+ * @param str string to copy.
+ * @param file source file of the call.
+ * @param line source line of the call.
+ * @return as strdup.
+ */
+char *alloc_trace_strdup(const char *, const char *, int);
+
+/**
+ * @brief free, the block is released from the site that allocated it.
+ * @param ptr block to free, NULL allowed, blocks of the C library are passed through.
+ */
+void alloc_trace_free(void *);
+
+#ifdef ALLOC_TRACE
+#undef malloc
+#undef calloc
+#undef realloc
+#undef strdup
+#undef free
+#define malloc(size)            alloc_trace_malloc((size), __FILE__, __LINE__)
+#define calloc(count, size)     alloc_trace_calloc((count), (size), __FILE__, __LINE__)
+#define realloc(ptr, size)      alloc_trace_realloc((ptr), (size), __FILE__, __LINE__)
+#define strdup(str)             alloc_trace_strdup((str), __FILE__, __LINE__)
+// object-like, so a free passed as a callback is counted too.
+#define free                    alloc_trace_free
+#endif
+
+#endif
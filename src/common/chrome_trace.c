@@ -0,0 +1,148 @@
+/**
+ * @file chrome_trace.c
+ * @brief Purpose: write a timeline in the Chrome trace-event format.
+ *
+ * Every span is a complete ("X") event with its start and duration, written
+ * as soon as it ends, so a span never waits in memory for its children:
+ *
+ *     {"traceEvents":[
+ *     {"name":"process_name","ph":"M",...},
+ *     {"name":"for1","cat":"loop","ph":"X","ts":12.000,"dur":3.500,...},
+ *     ...
+ *     ],"displayTimeUnit":"ms"}
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "chrome_trace.h"
+
+struct chrome_trace {
+    FILE *fout;                                     /**< the trace file */
+    struct timespec start;                          /**< zero of the timeline */
+    int pid;                                        /**< process of the events */
+};
+
+/**
+ * @brief write a string as a JSON string.
+ * @param fout output stream.
+ * @param str the string.
+ */
+static void s_write_string(FILE *, const char *);
+
+/**
+ * @brief create a trace file and start the clock of the timeline.
+ * @param path path of the trace file, truncated if exists.
+ * @param process name of the process shown by the viewer.
+ * @return NULL on failed, errno is set; otherwise a valid trace object.
+ */
+chrome_trace_st *chrome_trace_open(const char *path, const char *process) {
+    chrome_trace_st *trace;
+
+    if (path == NULL || process == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    trace = (chrome_trace_st *)calloc(1, sizeof(chrome_trace_st));
+    if (trace == NULL)
+        exit(ENOMEM);
+
+    trace->fout = fopen(path, "w");
+    if (trace->fout == NULL) {
+        free(trace);
+        return NULL;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &trace->start);
+    trace->pid = getpid();
+
+    fprintf(trace->fout, "{\"traceEvents\":[\n");
+    fprintf(trace->fout, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+                         "\"args\":{\"name\":", trace->pid, trace->pid);
+    s_write_string(trace->fout, process);
+    fprintf(trace->fout, "}}");
+    return trace;
+}
+
+/**
+ * @brief finish the trace file and clean up the trace object.
+ * @param trace a valid trace object.
+ * @return 0 on success; otherwise errno.
+ */
+int chrome_trace_close(chrome_trace_st *trace) {
+    int rc = 0;
+
+    if (trace == NULL)
+        return EINVAL;
+
+    fprintf(trace->fout, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    if (ferror(trace->fout))
+        rc = EIO;
+    if (fclose(trace->fout) != 0 && rc == 0)
+        rc = errno;
+
+    free(trace);
+    return rc;
+}
+
+/**
+ * @brief get the time on the timeline.
+ * @param trace a valid trace object.
+ * @return microseconds since the trace was opened.
+ */
+double chrome_trace_now(chrome_trace_st *trace) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - trace->start.tv_sec) * 1e6 +
+           (now.tv_nsec - trace->start.tv_nsec) / 1e3;
+}
+
+/**
+ * @brief write a span, spans nest by their times.
+ * @param trace a valid trace object.
+ * @param category category of the span, e.g. "phase".
+ * @param name name of the span.
+ * @param start start of the span, from chrome_trace_now.
+ * @param end end of the span, from chrome_trace_now.
+ * @param args body of the JSON object of arguments, e.g. "\"count\":3";
+ *        NULL for none.
+ */
+void chrome_trace_span(chrome_trace_st *trace, const char *category, const char *name,
+                       double start, double end, const char *args) {
+    if (trace == NULL)
+        return;
+
+    fprintf(trace->fout, ",\n{\"name\":");
+    s_write_string(trace->fout, name);
+    fprintf(trace->fout, ",\"cat\":");
+    s_write_string(trace->fout, category);
+    fprintf(trace->fout, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d",
+                         start, end > start ? end - start : 0.0, trace->pid, trace->pid);
+    if (args != NULL)
+        fprintf(trace->fout, ",\"args\":{%s}", args);
+    fprintf(trace->fout, "}");
+}
+
+/**
+ * @brief write a string as a JSON string.
+ * @param fout output stream.
+ * @param str the string.
+ */
+static void s_write_string(FILE *fout, const char *str) {
+    fputc('"', fout);
+    for (; *str != '\0'; str++) {
+        if (*str == '"' || *str == '\\')
+            fprintf(fout, "\\%c", *str);
+        else if ((unsigned char)*str < 0x20)
+            fprintf(fout, "\\u%04x", (unsigned char)*str);
+        else
+            fputc(*str, fout);
+    }
+    fputc('"', fout);
+}
@@ -0,0 +1,49 @@
+/**
+ * @file chrome_trace.h
+ * @brief Purpose: write a timeline in the Chrome trace-event format,
+ *        for chrome://tracing, Perfetto and speedscope.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __CHROME_TRACE_H__
+#define __CHROME_TRACE_H__
+
+typedef struct chrome_trace chrome_trace_st;
+struct chrome_trace;
+
+/**
+ * @brief create a trace file and start the clock of the timeline.
+ * @param path path of the trace file, truncated if exists.
+ * @param process name of the process shown by the viewer.
+ * @return NULL on failed, errno is set; otherwise a valid trace object.
+ */
+chrome_trace_st *chrome_trace_open(const char *, const char *);
+
+/**
+ * @brief finish the trace file and clean up the trace object.
+ * @param trace a valid trace object.
+ * @return 0 on success; otherwise errno.
+ */
+int chrome_trace_close(chrome_trace_st *);
+
+/**
+ * @brief get the time on the timeline.
+ * @param trace a valid trace object.
+ * @return microseconds since the trace was opened.
+ */
+double chrome_trace_now(chrome_trace_st *);
+
+/**
+ * @brief write a span, spans nest by their times.
+ * @param trace a valid trace object.
+ * @param category category of the span, e.g. "phase".
+ * @param name name of the span.
+ * @param start start of the span, from chrome_trace_now.
+ * @param end end of the span, from chrome_trace_now.
+ * @param args body of the JSON object of arguments, e.g. "\"count\":3";
+ *        NULL for none.
+ */
+void chrome_trace_span(chrome_trace_st *, const char *, const char *,
+                       double, double, const char *);
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * @file ten_sdt.h
+ * @brief Purpose: static tracepoints for bpftrace, perf and systemtap.
+ *
+ * A self-contained take on <sys/sdt.h>. A probe site is a single nop and a
+ * ".note.stapsdt" entry that describes where the arguments live; a tracer
+ * attaches by rewriting the nop, so the untraced cost is the nop and keeping
+ * the arguments in registers. Every probe has a semaphore, raised by the
+ * tracer while attached, for probes whose arguments cost more than that:
+ *
+ *     TEN_SDT_SEMAPHORE(ten, loop__enter);             at file scope
+ *     ...
+ *     if (TEN_SDT_ENABLED(ten, loop__enter))
+ *         TEN_SDT_PROBE3(ten, loop__enter, pc, label, depth);
+ *
+ * Arguments are passed as 8 bytes signed, pointers included, e.g.
+ *
+ *     bpftrace -e 'usdt:./runtime:ten:loop__enter { printf("%s\n", str(arg1)); }'
+ *
+ * On other architectures, or with TEN_SDT_DISABLE, probes compile to nothing.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __TEN_SDT_H__
+#define __TEN_SDT_H__
+
+/**
+ * @brief define the semaphore of a probe, once per program.
+ */
+#define TEN_SDT_SEMAPHORE(provider, name)                                   \
+    __extension__ volatile unsigned short provider##_##name##_semaphore     \
+        __attribute__((section(".probes")))
+
+#if (defined(__x86_64__) || defined(__aarch64__)) && !defined(TEN_SDT_DISABLE)
+
+#define TEN_SDT_ENABLED(provider, name)                                     \
+    __builtin_expect(provider##_##name##_semaphore != 0, 0)
+
+#define _TEN_SDT_ARG(x)             ((long)(x))
+#define _TEN_SDT_STR(x)             #x
+#define _TEN_SDT_XSTR(x)            _TEN_SDT_STR(x)
+
+/*
+ * note layout: namesz, descsz, type 3, "stapsdt", then the probe address,
+ * the link-time address of .stapsdt.base (to detect prelinking), the
+ * semaphore address, provider, name and argument descriptions.
+ */
+#define _TEN_SDT_ASM(provider, name, args)                                  \
+    "990:   nop\n"                                                          \
+    "       .pushsection .note.stapsdt,\"?\",\"note\"\n"                    \
+    "       .balign 4\n"                                                    \
+    "       .4byte 992f-991f, 994f-993f, 3\n"                               \
+    "991:   .asciz \"stapsdt\"\n"                                           \
+    "992:   .balign 4\n"                                                    \
+    "993:   .8byte 990b\n"                                                  \
+    "       .8byte _.stapsdt.base\n"                                        \
+    "       .8byte " _TEN_SDT_XSTR(provider##_##name##_semaphore) "\n"       \
+    "       .asciz \"" #provider "\"\n"                                     \
+    "       .asciz \"" #name "\"\n"                                         \
+    "       .asciz \"" args "\"\n"                                          \
+    "994:   .balign 4\n"                                                    \
+    "       .popsection\n"                                                  \
+    "       .ifndef _.stapsdt.base\n"                                       \
+    "       .pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+    "       .weak _.stapsdt.base\n"                                         \
+    "       .hidden _.stapsdt.base\n"                                       \
+    "_.stapsdt.base: .space 1\n"                                            \
+    "       .size _.stapsdt.base, 1\n"                                      \
+    "       .popsection\n"                                                  \
+    "       .endif\n"
+
+#define TEN_SDT_PROBE0(provider, name)                                      \
+    __asm__ __volatile__(_TEN_SDT_ASM(provider, name, ""))
+
+#define TEN_SDT_PROBE1(provider, name, a1)                                  \
+    __asm__ __volatile__(_TEN_SDT_ASM(provider, name, "-8@%[_sdt1]")        \
+                         :: [_sdt1] "nor" (_TEN_SDT_ARG(a1)))
+
+#define TEN_SDT_PROBE2(provider, name, a1, a2)                              \
+    __asm__ __volatile__(_TEN_SDT_ASM(provider, name, "-8@%[_sdt1] -8@%[_sdt2]") \
+                         :: [_sdt1] "nor" (_TEN_SDT_ARG(a1)),               \
+                            [_sdt2] "nor" (_TEN_SDT_ARG(a2)))
+
+#define TEN_SDT_PROBE3(provider, name, a1, a2, a3)                          \
+    __asm__ __volatile__(_TEN_SDT_ASM(provider, name,                       \
+                                      "-8@%[_sdt1] -8@%[_sdt2] -8@%[_sdt3]") \
+                         :: [_sdt1] "nor" (_TEN_SDT_ARG(a1)),               \
+                            [_sdt2] "nor" (_TEN_SDT_ARG(a2)),               \
+                            [_sdt3] "nor" (_TEN_SDT_ARG(a3)))
+
+#else
+
+#define TEN_SDT_ENABLED(provider, name)         (0)
+
+#define TEN_SDT_PROBE0(provider, name)          do { } while (0)
+#define TEN_SDT_PROBE1(provider, name, a1)      do { (void)(a1); } while (0)
+#define TEN_SDT_PROBE2(provider, name, a1, a2)  do { (void)(a1); (void)(a2); } while (0)
+#define TEN_SDT_PROBE3(provider, name, a1, a2, a3)                          \
+    do { (void)(a1); (void)(a2); (void)(a3); } while (0)
+
+#endif
+
+#endif
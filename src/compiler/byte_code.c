@@ -12,43 +12,35 @@
 
 #include "utils/link_list.h"
 #include "utils/symbol_table.h"
-#include "utils/parsing_tree.h"
+#include "utils/ast.h"
 
 #include "utils/error.h"
 
 #include "byte_code.h"
 
-static int handle_if_stmt_helper(parsing_tree_st *then_node);
-
 static void byte_code_new(link_list_st *, char *, char *, char *);
 
-static void handle_stmt_list(parsing_tree_st *, link_list_st *); 
-
-static void handle_stmt(parsing_tree_st *, link_list_st *); 
-
-static char *handle_boolean_value(parsing_tree_st *, link_list_st *);
-
-static char *handle_boolean_expr(parsing_tree_st *, link_list_st *);
+static void handle_stmt_list(ast_node_st *, link_list_st *); 
 
-static void handle_if_stmt(parsing_tree_st *, link_list_st *); 
+static void handle_stmt(ast_node_st *, link_list_st *); 
 
-static void handle_for_stmt(parsing_tree_st *, link_list_st *); 
+static int handle_boolean_expr(ast_node_st *, link_list_st *);
 
-static char *handle_expr(parsing_tree_st *, link_list_st *); 
+static void handle_if_stmt(ast_node_st *, link_list_st *); 
 
-static char *handle_term(parsing_tree_st *, link_list_st *); 
+static void handle_for_stmt(ast_node_st *, link_list_st *); 
 
-static void handle_decl_stmt(parsing_tree_st *, link_list_st *); 
+static char *handle_expr(ast_node_st *, link_list_st *); 
 
-static void handle_assign_stmt(parsing_tree_st *, link_list_st *); 
+static void handle_decl_stmt(ast_node_st *, link_list_st *); 
 
-static void handle_print_stmt(parsing_tree_st *, link_list_st *); 
+static void handle_assign_stmt(ast_node_st *, link_list_st *); 
 
-static char *handle_res1(parsing_tree_st *, link_list_st *, char *); 
+static void handle_print_stmt(ast_node_st *, link_list_st *); 
 
-static char *handle_factor(parsing_tree_st *, link_list_st *); 
+static char *handle_binary(ast_node_st *, link_list_st *); 
 
-static char *handle_res2(parsing_tree_st *, link_list_st *, char *);
+static void set_position(int, int);
 
 static int temp_id = 0;
 
@@ -58,6 +50,10 @@ static int if_id = 0;
 
 static int else_id = 0;
 
+static int current_line = 0;        /**< source line of the generated byte code */
+
+static int current_column = 0;      /**< source column of the generated byte code */
+
 /*
  * @brief get number of digits from an integer
  * @para int_num, an integer
@@ -73,141 +69,91 @@ int get_digits_num(int int_num) {
 }
 
 /**
- * @brief generate byte code from parsing tree and symbol table.
- * @param node, a valid tree node.
- * @param table, a valid symbol table object
+ * @brief generate byte code from the syntax tree.
+ * @param ast, a valid syntax tree.
  * @return NULL on failed, otherwise a valid link list.
  */
-link_list_st *semantic_analysis(parsing_tree_st *parsing_tree_node) {
+link_list_st *semantic_analysis(ast_st *ast) {
     link_list_st *byte_code = NULL;
 
-    char *program_data = NULL;
-
-    if (parsing_tree_node == NULL)
+    if (ast == NULL || ast_get_root(ast) == NULL)
         return NULL;
 
-    program_data = parsing_tree_get_data(parsing_tree_node);
-    if (strcmp(program_data, "program") != 0)
-        return NULL;
+    current_line = 0;
+    current_column = 0;
 
     byte_code = link_list_init();
-    parsing_tree_st *stmt_list_node = parsing_tree_get_child(parsing_tree_node);
-    char *stmt_list_data = parsing_tree_get_data(stmt_list_node);
-    if (strcmp(stmt_list_data, "stmt_list") == 0) {
-        handle_stmt_list(stmt_list_node, byte_code);
-    } else {
-        printf("program error");
-        return NULL;
-    }
+    handle_stmt_list(ast_get_root(ast), byte_code);
 
     return byte_code;
 }
 
 /**
- * @brief handle stmt_list from parsing tree.
- * @param node, a valid tree node.
+ * @brief handle a list of statements from the syntax tree.
+ * @param node, the first statement.
  * @param byte_code, a valid link list.
  */
-static void handle_stmt_list(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
-    parsing_tree_st *stmt_node = parsing_tree_get_child(parsing_tree_node);
-    char *stmt_data = parsing_tree_get_data(stmt_node);
-
-    while (1) {
-        if (strcmp(stmt_data, "stmt") == 0) {
-            handle_stmt(stmt_node, byte_code);
-        } else {
-            error_msg(__LINE__, "stmt_list error");
-        }
-
-        parsing_tree_st *semicolon_node = parsing_tree_get_sibling(stmt_node);
-        char *semicolon_data = parsing_tree_get_data(semicolon_node);
-        parsing_tree_st *stmt_list_node = parsing_tree_get_sibling(semicolon_node);
-
-        if (strcmp(semicolon_data, ";") == 0 && stmt_list_node == NULL) {
-            break;
-        }
-        char *stmt_list_data = parsing_tree_get_data(stmt_list_node);
-
-        if (strcmp(stmt_list_data, "stmt_list") == 0) {
-            stmt_node = parsing_tree_get_child(stmt_list_node);
-            stmt_data = parsing_tree_get_data(stmt_node);
-        }
-    }
+static void handle_stmt_list(ast_node_st *node, link_list_st *byte_code) {
+    for (; node != NULL; node = node->next)
+        handle_stmt(node, byte_code);
 }
 
 /**
- * @brief handle stmt from parsing tree.
- * @param node, a valid tree node.
+ * @brief handle stmt from the syntax tree.
+ * @param node, a valid statement.
  * @param byte_code, a valid link list.
  */
-static void handle_stmt(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
-    parsing_tree_st *sub_stmt_node = parsing_tree_get_child(parsing_tree_node);
-    char *sub_stmt_data = parsing_tree_get_data(sub_stmt_node);
-
-    if (strcmp(sub_stmt_data, "decl_stmt") == 0) {
-        handle_decl_stmt(sub_stmt_node, byte_code);
-    } else if (strcmp(sub_stmt_data, "assign_stmt") == 0) {
-        handle_assign_stmt(sub_stmt_node, byte_code);
-    } else if (strcmp(sub_stmt_data, "if_stmt") == 0) {
-        handle_if_stmt(sub_stmt_node, byte_code);
-    } else if (strcmp(sub_stmt_data, "for_stmt") == 0) {
-        handle_for_stmt(sub_stmt_node, byte_code);
-    } else if (strcmp(sub_stmt_data, "print_stmt") == 0) {
-        handle_print_stmt(sub_stmt_node, byte_code);
-    } else {
+static void handle_stmt(ast_node_st *node, link_list_st *byte_code) {
+    set_position(node->line, node->column);
+
+    switch (node->kind) {
+    case AST_DECL:
+        handle_decl_stmt(node, byte_code);
+        break;
+    case AST_ASSIGN:
+        handle_assign_stmt(node, byte_code);
+        break;
+    case AST_IF:
+        handle_if_stmt(node, byte_code);
+        break;
+    case AST_FOR:
+        handle_for_stmt(node, byte_code);
+        break;
+    case AST_PRINT:
+        handle_print_stmt(node, byte_code);
+        break;
+    default:
         error_msg(__LINE__, "stmt error");
     }
 }
 
 /**
- * @brief generate decl_stmt byte code from parsing tree.
- * @param node, a valid tree node
+ * @brief generate decl_stmt byte code from the syntax tree.
+ * @param node, a valid declare statement.
  * @param byte_code, a valid link list.
  */
-static void handle_decl_stmt(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
-    parsing_tree_st *var_node = parsing_tree_get_child(parsing_tree_node);
-    char *var_data = parsing_tree_get_data(var_node);
-    if (strcmp(var_data, "var") != 0) {
-        error_msg(__LINE__, "decl_stmt error");
-    }
-    parsing_tree_st *id_node = parsing_tree_get_sibling(var_node);
-    char *id_data = parsing_tree_get_data(id_node);
-
-    byte_code_new(byte_code, "DEC", id_data, "");
+static void handle_decl_stmt(ast_node_st *node, link_list_st *byte_code) {
+    byte_code_new(byte_code, "DEC", (char *)node->text, "");
 }
 
 /**
- * @brief generate assign_stmt byte code from parsing tree.
- * @param node, a valid tree node.
+ * @brief generate assign_stmt byte code from the syntax tree.
+ * @param node, a valid assignment statement.
  * @param byte_code, a valid link list.
  */
-static void handle_assign_stmt(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
-    parsing_tree_st *id_node = parsing_tree_get_child(parsing_tree_node);
-    parsing_tree_st *is_node = parsing_tree_get_sibling(id_node);
-    char *id_data = parsing_tree_get_data(id_node);
-    char *is_data = parsing_tree_get_data(is_node);
-    if (strcmp(is_data, "is") != 0) {
-        error_msg(__LINE__, "assign_stmt error");
-    }
-    parsing_tree_st *expr_node = parsing_tree_get_sibling(is_node);
+static void handle_assign_stmt(ast_node_st *node, link_list_st *byte_code) {
+    char *expr_data = handle_expr(node->expr, byte_code);
 
-    char *expr_data = parsing_tree_get_data(expr_node);
-    if (strcmp(expr_data, "expr") == 0) {
-        expr_data = handle_expr(expr_node, byte_code);
-    } else {
-        error_msg(__LINE__, "assign_stmt error");
-    }
-
-    byte_code_new(byte_code, "MOV", id_data, expr_data);
+    byte_code_new(byte_code, "MOV", (char *)node->text, expr_data);
     free(expr_data);
 }
 
 /**
- * @brief generate if_stmt byte code from parsing tree.
- * @param node, a valid tree node.
+ * @brief generate if_stmt byte code from the syntax tree.
+ * @param node, a valid if statement.
  * @param byte_code, a valid link list.
  */
-static void handle_if_stmt(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
+static void handle_if_stmt(ast_node_st *node, link_list_st *byte_code) {
     if_id++;
     else_id++;
 
@@ -242,86 +188,53 @@ static void handle_if_stmt(parsing_tree_st *parsing_tree_node, link_list_st *byt
     snprintf(else_label, else_length, "else%d", else_id);
     snprintf(else_label, else_length, "else%d:", else_id);
 
-    parsing_tree_st *if_node = parsing_tree_get_child(parsing_tree_node);
-    char *if_data = parsing_tree_get_data(if_node);
-
-    if (strcmp(if_data, "if") != 0) {
-        error_msg(__LINE__, "if_stmt error");
-    }
-
-    parsing_tree_st *brace_left_node = parsing_tree_get_sibling(if_node);
-    char *brace_left_data = parsing_tree_get_data(brace_left_node);
-    if (strcmp(brace_left_data, "(") != 0)
-        error_msg(__LINE__, "if_stmt error");
-
-    parsing_tree_st *boolean_node = parsing_tree_get_sibling(brace_left_node);
-    char *boolean_data = parsing_tree_get_data(boolean_node);
-    parsing_tree_st *brace_right_node = parsing_tree_get_sibling(boolean_node);
-    char *brace_right_data = parsing_tree_get_data(brace_right_node);
-    if (strcmp(boolean_data, "boolean_expr") != 0 || strcmp(brace_right_data, ")") != 0)
-        error_msg(__LINE__, "if_stmt error");
-
     byte_code_new(byte_code, if_label, "", "");
 
     char *target = NULL;
 
-    int has_else = handle_if_stmt_helper(parsing_tree_get_sibling(brace_right_node));
+    int has_else = node->else_body != NULL;
     if (has_else) {
         target = else_target;
     } else {
         target = if_end_target;
     }
 
-    boolean_data = handle_boolean_expr(boolean_node, byte_code);
-
-    if (strcmp(boolean_data, "=") == 0) {
+    switch (handle_boolean_expr(node->cond, byte_code)) {
+    case SYMBOL_EQUAL:
         byte_code_new(byte_code, "JNE", target, "");
-    } else if (strcmp(boolean_data, "<>") == 0) {
+        break;
+    case SYMBOL_NOT_EQUAL:
         byte_code_new(byte_code, "JE", target, "");
-    } else if (strcmp(boolean_data, ">") == 0) {
+        break;
+    case SYMBOL_GREATER:
         byte_code_new(byte_code, "JLE", target, "");
-    } else if (strcmp(boolean_data, ">=") == 0) {
+        break;
+    case SYMBOL_GREATER_EQUAL:
         byte_code_new(byte_code, "JL", target, "");
-    } else if (strcmp(boolean_data, "<") == 0) {
+        break;
+    case SYMBOL_LESS:
         byte_code_new(byte_code, "JGE", target, "");
-    } else if (strcmp(boolean_data, "<=") == 0) {
+        break;
+    case SYMBOL_LESS_EQUAL:
         byte_code_new(byte_code, "JG", target, "");
-    } else {
+        break;
+    default:
         error_msg(__LINE__, "boolean_expr error");
     }
 
-    parsing_tree_st *then_node = parsing_tree_get_sibling(brace_right_node);
-    parsing_tree_st *curlybrace_left_node = parsing_tree_get_sibling(then_node);
-    parsing_tree_st *stmt_list_node = parsing_tree_get_sibling(curlybrace_left_node);
-    char *stmt_list_data = parsing_tree_get_data(stmt_list_node);
-    parsing_tree_st *curlybrace_right_node = parsing_tree_get_sibling(stmt_list_node);
-    char *curlybrace_right_data = parsing_tree_get_data(curlybrace_right_node);
-    if (strcmp(stmt_list_data, "stmt_list") != 0 || strcmp(curlybrace_right_data, "}") != 0)
-        error_msg(__LINE__, "then_stmt error");
-
-    handle_stmt_list(stmt_list_node, byte_code);
+    handle_stmt_list(node->then_body, byte_code);
 
     if (has_else) {
+        set_position(node->else_line, node->else_column);
+
         byte_code_new(byte_code, "JMP", if_end_target, "");
 
         byte_code_new(byte_code, else_label, "", "");
 
-        parsing_tree_st *else_node = parsing_tree_get_sibling(curlybrace_right_node);
-        char *else_data = parsing_tree_get_data(else_node);
-        if (strcmp(else_data, "else") != 0)
-            error_msg(__LINE__, "else_stmt error");
-
-        curlybrace_left_node = parsing_tree_get_sibling(else_node);
-        stmt_list_node = parsing_tree_get_sibling(curlybrace_left_node);
-        stmt_list_data = parsing_tree_get_data(stmt_list_node);
-        curlybrace_right_node = parsing_tree_get_sibling(stmt_list_node);
-        curlybrace_right_data = parsing_tree_get_data(curlybrace_right_node);
-        if (strcmp(stmt_list_data, "stmt_list") != 0 || strcmp(curlybrace_right_data, "}") != 0)
-            error_msg(__LINE__, "else_stmt error");
-
-        handle_stmt_list(stmt_list_node, byte_code);
+        handle_stmt_list(node->else_body, byte_code);
     }
 
+    set_position(node->line, node->column);
     byte_code_new(byte_code, if_end_label, "", "");
 
     free(if_label);
@@ -332,11 +245,11 @@ static void handle_if_stmt(parsing_tree_st *parsing_tree_node, link_list_st *byt
 }
 
 /**
- * @brief generate for_stmt byte code from parsing tree.
- * @param node, a valid tree node.
+ * @brief generate for_stmt byte code from the syntax tree.
+ * @param node, a valid for statement.
  * @param byte_code, a valid link list.
  */
-static void handle_for_stmt(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
+static void handle_for_stmt(ast_node_st *node, link_list_st *byte_code) {
     loop_id++;
 
     int loop_length;
@@ -363,80 +276,30 @@ static void handle_for_stmt(parsing_tree_st *parsing_tree_node, link_list_st *by
     loop_target = (char *)malloc(loop_length);
     snprintf(loop_target, loop_target_len, "for%d", loop_id);
 
-    parsing_tree_st *for_node = parsing_tree_get_child(parsing_tree_node);
-    char *for_data = parsing_tree_get_data(for_node);
-
-    if (strcmp(for_data, "for") != 0)
-        error_msg(__LINE__, "for_stmt error");
-
-    parsing_tree_st *var_node = parsing_tree_get_sibling(for_node);
-    if (var_node == NULL)
-        error_msg(__LINE__, "var error");
-
-    char *var_data = parsing_tree_get_data(var_node);
-    parsing_tree_st *from_node = parsing_tree_get_sibling(var_node);
-
-    char *from_data = parsing_tree_get_data(from_node);
-    if (strcmp(from_data, "from") != 0)
-        error_msg(__LINE__, "from error");
+    char *var_data = (char *)node->text;
 
-    parsing_tree_st *expr1_node = parsing_tree_get_sibling(from_node);
-    char *expr1_data = parsing_tree_get_data(expr1_node);
-    if (strcmp(expr1_data, "expr") != 0)
-        error_msg(__LINE__, "expr1 error");
-
-    expr1_data = handle_expr(expr1_node, byte_code);
+    char *expr1_data = handle_expr(node->from, byte_code);
 
     byte_code_new(byte_code, "MOV", var_data, expr1_data);
 
-    parsing_tree_st *to_node = parsing_tree_get_sibling(expr1_node);
-    char *to_data = parsing_tree_get_data(to_node);
-    if (strcmp(to_data, "to") != 0 && strcmp(to_data, "downto") != 0)
-        error_msg(__LINE__, "to error");
-
-    parsing_tree_st *expr2_node = parsing_tree_get_sibling(to_node);
-    char *expr2_data = parsing_tree_get_data(expr2_node);
-    if (strcmp(expr2_data, "expr") != 0) 
-        error_msg(__LINE__, "expr2 error");
-    
-    expr2_data = handle_expr(expr2_node, byte_code);
+    char *expr2_data = handle_expr(node->to, byte_code);
 
     byte_code_new(byte_code, loop_string, "", "");
     byte_code_new(byte_code, "CMP", var_data, expr2_data);
-    if (strcmp(to_data, "to") == 0)
+    if (node->symbol == SYMBOL_TO)
         byte_code_new(byte_code, "JGE", loop_end_target, "");
     else
         byte_code_new(byte_code, "JLE", loop_end_target, "");
 
-    parsing_tree_st *step_node = parsing_tree_get_sibling(expr2_node);
-    char *step_data = parsing_tree_get_data(step_node);
-    if (strcmp(step_data, "step") != 0)
-        error_msg(__LINE__, "step error");
-
-
-    parsing_tree_st *expr3_node = parsing_tree_get_sibling(step_node);
-    char *expr3_data = parsing_tree_get_data(expr3_node);
-    if (strcmp(expr3_data, "expr") != 0)
-        error_msg(__LINE__, "expr3 error");
-
     byte_code_new(byte_code, "stmt_list:", "", "");
-    parsing_tree_st *curlybrace_left_node = parsing_tree_get_sibling(expr3_node);
-    char *curlybrace_left_data = parsing_tree_get_data(curlybrace_left_node);
-    parsing_tree_st *stmt_list_node = parsing_tree_get_sibling(curlybrace_left_node);
-    char *stmt_list_data = parsing_tree_get_data(stmt_list_node);
-    if (strcmp(stmt_list_data, "stmt_list")!= 0 || strcmp(curlybrace_left_data, "{") != 0)
-        error_msg(__LINE__, "stmt_list error");
-
-    handle_stmt_list(stmt_list_node, byte_code);
 
-    parsing_tree_st *curlybrace_right_node = parsing_tree_get_sibling(stmt_list_node);
-    char *curlybrace_right_data = parsing_tree_get_data(curlybrace_right_node);
-    if (strcmp(curlybrace_right_data, "}") != 0)
-        error_msg(__LINE__, "right curlybrace error");
+    handle_stmt_list(node->body, byte_code);
 
+    // the step belongs to the loop header, not to the last statement of the body.
+    set_position(node->step->line, node->step->column);
     byte_code_new(byte_code, "stmt_list_end:", "", "");
 
-    expr3_data = handle_expr(expr3_node, byte_code);
+    char *expr3_data = handle_expr(node->step, byte_code);
 
     byte_code_new(byte_code, "MOV", var_data, expr3_data);
     byte_code_new(byte_code, "JMP", loop_target, "");
@@ -452,136 +315,68 @@ static void handle_for_stmt(parsing_tree_st *parsing_tree_node, link_list_st *by
 }
 
 /**
- * @brief generate print_stmt byte code from parsing tree.
- * @param node, a valid tree node.
+ * @brief generate print_stmt byte code from the syntax tree.
+ * @param node, a valid print statement.
  * @param byte_code, a valid link list.
  */
-static void handle_print_stmt(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
-    parsing_tree_st *print_node = parsing_tree_get_child(parsing_tree_node);
-    char *print_data = parsing_tree_get_data(print_node);
-
-    if (strcmp(print_data, "print") != 0) {
-        error_msg(__LINE__, "print error");
-    }
-
-    parsing_tree_st *operand_node = parsing_tree_get_sibling(print_node);
-    char *operand = parsing_tree_get_data(operand_node);
-    if (strcmp(operand, "expr") != 0)
-        error_msg(__LINE__, "expr_stmt error");
-
-    operand = handle_expr(operand_node, byte_code);
+static void handle_print_stmt(ast_node_st *node, link_list_st *byte_code) {
+    char *operand = handle_expr(node->expr, byte_code);
 
     byte_code_new(byte_code, "OUT", operand, "");
     free(operand);
 }
 
 /**
- * @brief generate boolean_value byte code from parsing tree.
- * @param node, a valid tree node.
+ * @brief generate the comparison of a condition from the syntax tree,
+ *        true and false are compared with 1.
+ * @param node, a valid condition.
  * @param byte_code, a valid link list.
- * @return boolean value, "1" for true, "0" for false.
+ * @return symbol id of the boolean operator.
  */
-static char *handle_boolean_value(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
-    parsing_tree_st *value_node = parsing_tree_get_child(parsing_tree_node);
-    char *bool_value = parsing_tree_get_data(value_node);
-    if (strcmp(bool_value, "true") == 0)
-        return strdup("1");
-    return strdup("0");
-}
-
-/**
- * @brief generate boolean_expr byte code from parsing tree.
- * @param node, a valid tree node.
- * @param byte_code, a valid link list.
- * @return boolean operator.
- */
-static char *handle_boolean_expr(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
-    parsing_tree_st *expr1_node = parsing_tree_get_child(parsing_tree_node);
-    char *expr1_data = parsing_tree_get_data(expr1_node);
-    char *operator_data = NULL;
+static int handle_boolean_expr(ast_node_st *node, link_list_st *byte_code) {
+    char *expr1_data = NULL;
+    int operator_id = SYMBOL_UNKNOWN;
     char *expr2_data = NULL;
 
-    if (strcmp(expr1_data, "expr") != 0 && strcmp(expr1_data, "boolean_value") != 0)
-        error_msg(__LINE__, "boolean_expr error");
-
-    if (strcmp(expr1_data, "boolean_value") == 0) {
-        expr1_data = handle_boolean_value(expr1_node, byte_code);
-        operator_data = "=";
+    if (node->kind == AST_BOOLEAN) {
+        expr1_data = strdup(node->symbol == SYMBOL_TRUE ? "1" : "0");
+        operator_id = SYMBOL_EQUAL;
         expr2_data = strdup("1");
     } else {
-        expr1_data = handle_expr(expr1_node, byte_code);
-        parsing_tree_st *operator_node = parsing_tree_get_sibling(expr1_node);
-        operator_data = parsing_tree_get_data(operator_node);
-        parsing_tree_st *expr2_node = parsing_tree_get_sibling(operator_node);
-        expr2_data = parsing_tree_get_data(expr2_node);
-        if (strcmp(expr2_data, "expr") != 0)
-            error_msg(__LINE__, "boolean_expr error");
-            
-        expr2_data = handle_expr(expr2_node, byte_code);
+        expr1_data = handle_expr(node->left, byte_code);
+        operator_id = node->symbol;
+        expr2_data = handle_expr(node->right, byte_code);
     }
 
     byte_code_new(byte_code, "CMP", expr1_data, expr2_data);
 
     free(expr1_data);
     free(expr2_data);
-    return operator_data;
+    return operator_id;
 }
 
 /**
- * @brief handle expr form parsing tree and symbol table.
+ * @brief handle expr from the syntax tree.
+ * @param node, a valid expression.
  * @param byte_code, a valid link list.
- * @param node, a valid tree node.
- * @return NULL on failed, otherwise a char array.
+ * @return the operand holding the value, to be freed.
  */
-static char *handle_expr(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
-    parsing_tree_st *term_node = parsing_tree_get_child(parsing_tree_node);
-    char *term_data = parsing_tree_get_data(term_node);
-    parsing_tree_st *res1_node = parsing_tree_get_sibling(term_node);
-
-    char *rc;  //return code
-    if (strcmp(term_data, "term") != 0)
-        error_errno(EINVAL);
-
-    rc = handle_term(term_node, byte_code);
-       
-    if (parsing_tree_get_child(res1_node) != NULL) {
-        rc = handle_res1(res1_node, byte_code, rc);
-    }
-
-    return rc;
+static char *handle_expr(ast_node_st *node, link_list_st *byte_code) {
+    if (node->kind == AST_BINARY)
+        return handle_binary(node, byte_code);
+    return strdup(node->text);
 }
 
 /**
- * @brief handle term form parsing tree and symbol table.
+ * @brief generate a binary operator into a new temporary.
+ * @param node, a valid binary expression.
  * @param byte_code, a valid link list.
- * @param node, a valid tree node.
- * @return NULL on failed, otherwise a char array.
+ * @return the temporary, to be freed.
  */
-static char *handle_term(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
-    parsing_tree_st *factor_node = parsing_tree_get_child(parsing_tree_node);
-    char *factor_data = parsing_tree_get_data(factor_node);
-    parsing_tree_st *res2_node = parsing_tree_get_sibling(factor_node);
-
-    char *rc; //return code
-    if (strcmp(factor_data, "factor") != 0)
-        error_errno(EINVAL);
-    
-    rc = handle_factor(factor_node, byte_code);
-
-    if (parsing_tree_get_child(res2_node) != NULL) {
-        rc = handle_res2(res2_node, byte_code, rc);
-    }
-
-    return rc;
-}
+static char *handle_binary(ast_node_st *node, link_list_st *byte_code) {
+    char *left_data = handle_expr(node->left, byte_code);
 
-/**
- * @brief generate res1 byte code form link list and parsing tree.
- * @param byte_code, a valid link list.
- * @param node, a valid tree node.
- * @return NULL on failed, otherwise a char array.
- */
-static char *handle_res1(parsing_tree_st *parsing_tree_node, link_list_st *byte_code, char *terms_data) {
+    // the temporary is numbered before the right operand takes its own.
     temp_id++;
 
     int temp_length;
@@ -590,129 +385,34 @@ static char *handle_res1(parsing_tree_st *parsing_tree_node, link_list_st *byte_
     temp_string = (char *)malloc(temp_length);
     snprintf(temp_string, temp_length, "_temp%d", temp_id);
 
-    parsing_tree_st *operator_node = parsing_tree_get_child(parsing_tree_node);
-    if (operator_node == NULL) {
-        free(temp_string);
-        temp_id--;
-        return NULL;
-    }
-
-    parsing_tree_st *term_node = parsing_tree_get_sibling(operator_node);
-    char *operator_data = parsing_tree_get_data(operator_node);
-    char *term_data = parsing_tree_get_data(term_node);
-
-    if (strcmp(term_data, "term") == 0) {
-        term_data = handle_term(term_node, byte_code);
-    }
+    char *right_data = handle_expr(node->right, byte_code);
 
     byte_code_new(byte_code, "DEC", temp_string, "");
 
-    byte_code_new(byte_code, "MOV", temp_string, terms_data);
-
-    free(terms_data);
-    if (strcmp(operator_data, "+") == 0) {
-        byte_code_new(byte_code, "ADD", temp_string, term_data);
-    } else if (strcmp(operator_data, "-") == 0) {
-        byte_code_new(byte_code, "SUB", temp_string, term_data);
-    } else {
-        error_msg(__LINE__, "res1 error");
-    }
-
-    free(term_data);
-
-    parsing_tree_st *res1_node = parsing_tree_get_sibling(term_node);
-    char *ret_res1 = handle_res1(res1_node, byte_code, temp_string);
-
-    if (ret_res1 != NULL) {
-        temp_string = ret_res1;
-    }
-
-    return temp_string;
-}
-
-/**
- * @brief generate factor byte code form link list and parsing tree.
- * @param byte_code, a valid link list.
- * @param node, a valid tree node.
- * @return NULL on failed, otherwise a char array.
- */
-static char *handle_factor(parsing_tree_st *parsing_tree_node, link_list_st *byte_code) {
-
-    parsing_tree_st *operand_node = parsing_tree_get_child(parsing_tree_node);
-    char *operand_data = strdup(parsing_tree_get_data(operand_node));
-
-    if (strcmp(operand_data, "(") == 0) {
-        parsing_tree_st *expr_node = parsing_tree_get_sibling(operand_node);
-        char *expr_data = parsing_tree_get_data(expr_node);
-        parsing_tree_st *brace_node = parsing_tree_get_sibling(expr_node);
-        char *brace_data = parsing_tree_get_data(brace_node);
-        if (strcmp(expr_data, "expr") == 0 && strcmp(brace_data, ")") == 0) {
-            free(operand_data);
-            operand_data = handle_expr(expr_node, byte_code);
-        }
-    }
-
-    return operand_data;
-}
-
-/**
-* @brief generate res2 byte code form link list and parsing tree.
-* @param byte_code, a valid link list.
-* @param node, a valid tree node.
-* @return NULL on failed, otherwise a valid link list.
-*/
-
-static char *handle_res2(parsing_tree_st *parsing_tree_node, link_list_st *byte_code, char *factors_data) {
-    temp_id++;
-
-    int temp_length;
-    char *temp_string;
-    temp_length = strlen("_temp") + get_digits_num(temp_id) + 1;
-    temp_string = (char *)malloc(temp_length);
-    snprintf(temp_string, temp_length, "_temp%d", temp_id);
-
-    parsing_tree_st *operator_node = parsing_tree_get_child(parsing_tree_node);
-    if (operator_node == NULL) {
-        free(temp_string);
-        temp_id--;
-        return NULL;
-    }
-
-    parsing_tree_st *factor_node = parsing_tree_get_sibling(operator_node);
-    char *operator_data = parsing_tree_get_data(operator_node);
-    char *factor_data = parsing_tree_get_data(factor_node);
-
-    if (strcmp(factor_data, "factor") == 0) {
-        factor_data = handle_factor(factor_node, byte_code);
-    } else {
-        error_errno(EINVAL);
-    }
-
-    byte_code_new(byte_code, "DEC", temp_string, "");
-
-    byte_code_new(byte_code, "MOV", temp_string, factors_data);
-
-    free(factors_data);
-
-    if (strcmp(operator_data, "*") == 0) {
-        byte_code_new(byte_code, "MUL", temp_string, factor_data);
-    } else if (strcmp(operator_data, "/") == 0) {
-        byte_code_new(byte_code, "DIV", temp_string, factor_data);
-    } else if (strcmp(operator_data, "%") == 0) {
-        byte_code_new(byte_code, "MOD", temp_string, factor_data);
-    } else {
-        error_msg(__LINE__, "reds2 error");
-    }
-
-    free(factor_data);
-
-    parsing_tree_st *res2_node = parsing_tree_get_sibling(factor_node);
-    char *ret_res2 = handle_res2(res2_node, byte_code, temp_string);
-
-    if (ret_res2 != NULL) {
-        temp_string = ret_res2;
+    byte_code_new(byte_code, "MOV", temp_string, left_data);
+
+    free(left_data);
+    switch (node->symbol) {
+    case SYMBOL_ADD:
+        byte_code_new(byte_code, "ADD", temp_string, right_data);
+        break;
+    case SYMBOL_SUB:
+        byte_code_new(byte_code, "SUB", temp_string, right_data);
+        break;
+    case SYMBOL_MUL:
+        byte_code_new(byte_code, "MUL", temp_string, right_data);
+        break;
+    case SYMBOL_DIV:
+        byte_code_new(byte_code, "DIV", temp_string, right_data);
+        break;
+    case SYMBOL_MOD:
+        byte_code_new(byte_code, "MOD", temp_string, right_data);
+        break;
+    default:
+        error_msg(__LINE__, "binary error");
     }
 
+    free(right_data);
     return temp_string;
 }
 
@@ -729,48 +429,37 @@ static void byte_code_new(link_list_st *byte_code, char *op_code, char *first_op
     snprintf(bytecode, bytecode_len, "%s %s %s", op_code, first_oprand, second_oprand);
 
     new_node = link_node_new(bytecode, free);
+    link_node_set_position(new_node, current_line, current_column);
     link_list_append(byte_code, new_node);
 }
 
-static int handle_if_stmt_helper(parsing_tree_st *then_node) {
-    return  parsing_tree_get_sibling(
-                parsing_tree_get_sibling(
-                    parsing_tree_get_sibling(
-                        parsing_tree_get_sibling(
-                            then_node
-                        )
-                    )
-                )
-            ) != NULL;
+/**
+ * @brief take a source position for the byte code generated next.
+ * @param line, source line, 0 for unknown.
+ * @param column, source column.
+ */
+static void set_position(int line, int column) {
+    if (line > 0) {
+        current_line = line;
+        current_column = column;
+    }
 }
 
-
 #ifdef XTEST
 //tree structure
 
-parsing_tree_st *setup_expr_tree_with_number() {
-    parsing_tree_st *expr_node = parsing_tree_new("expr", NULL);
-    parsing_tree_st *node1 = NULL;
-    parsing_tree_st *node2 = NULL;
-    node1 = node2;
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_child(expr_node, node2);
-
-    node1 = parsing_tree_new("res1", NULL);
-    parsing_tree_set_sibling(node2, node1);
-
-    node1 = node2;
-    node2 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node2, node1);
-
-    node1 = node2;
-    node2 = parsing_tree_new("3", NULL);
-    parsing_tree_set_child(node1, node2);
+ast_node_st *new_leaf(ast_st *ast, int kind, const char *text) {
+    ast_node_st *node = ast_new_node(ast, kind, 1, 1);
+    node->text = ast_dup_text(ast, text, strlen(text));
+    return node;
+}
 
-    return expr_node;
+ast_node_st *new_binary(ast_st *ast, int symbol, ast_node_st *left, ast_node_st *right) {
+    ast_node_st *node = ast_new_node(ast, AST_BINARY, 1, 1);
+    node->symbol = symbol;
+    node->left = left;
+    node->right = right;
+    return node;
 }
 
 int print_byte_code(link_node_st *node, void *cb_data) {
@@ -784,549 +473,98 @@ int print_byte_code(link_node_st *node, void *cb_data) {
     return LINK_LIST_STOP;
 }
 
-int print_tree(parsing_tree_st *node, void *cb_data) {
-    printf("%s\n", (char *)parsing_tree_get_data(node));
-    return TREE_TRAVERSE_CONTINUE;
+void run_suite(const char *name, ast_st *ast, ast_node_st *root) {
+    link_list_st *byte_code = NULL;
+
+    printf("%s\n", name);
+    ast_set_root(ast, root);
+    byte_code = semantic_analysis(ast);
+    link_list_traverse(byte_code, print_byte_code, NULL);
+    ast_free(ast);
+    link_list_free(byte_code);
 }
 
 void test_suite_one() {
-    link_list_st *byte_code = NULL;
-
-    printf("test suite one\n");
+    ast_st *ast = ast_init();
 
     // Create syntax tree for "var i;" statement;
-
-    parsing_tree_st *root = parsing_tree_new("program", NULL);;
-    parsing_tree_st *node1 = parsing_tree_new("stmt_list", NULL);
-    parsing_tree_st *node2 = parsing_tree_new("stmt", NULL);
-    parsing_tree_set_child(root, node1);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new(";", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    node2 = parsing_tree_new("decl_stmt", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("var", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    byte_code = semantic_analysis(root, NULL);
-    link_list_traverse(byte_code, print_byte_code, NULL);
-    parsing_tree_free(root);
-    link_list_free(byte_code);
+    ast_node_st *decl = new_leaf(ast, AST_DECL, "i");
+    run_suite("test suite one", ast, decl);
 }
 
 void test_suite_two() {
-    link_list_st *byte_code = NULL;
-
-    printf("test suite two\n");
+    ast_st *ast = ast_init();
 
     // Create syntax tree for "print i;" statement;
-
-    parsing_tree_st *root = parsing_tree_new("program", NULL);;
-    parsing_tree_st *node1 = parsing_tree_new("stmt_list", NULL);
-    parsing_tree_st *node2 = parsing_tree_new("stmt", NULL);
-    parsing_tree_set_child(root, node1);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new(";", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    node2 = parsing_tree_new("print_stmt", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("print", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("expr", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    
-    node1 = node2;
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("res1", NULL);
-    parsing_tree_set_sibling(node2, node1);
-
-    node1 = node2;
-    node2 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node2, node1);
-
-    node1 = node2;
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node1, node2);
-    
-    byte_code = semantic_analysis(root, NULL);
-    link_list_traverse(byte_code, print_byte_code, NULL);
-
-    parsing_tree_free(root);
-    link_list_free(byte_code);
+    ast_node_st *print = ast_new_node(ast, AST_PRINT, 1, 1);
+    print->expr = new_leaf(ast, AST_VARIABLE, "i");
+    run_suite("test suite two", ast, print);
 }
 
 void test_suite_three() {
-    link_list_st *byte_code = NULL;
-
-    printf("test suite three\n");
+    ast_st *ast = ast_init();
 
     // Create syntax tree for "i is 3;" statement;
-
-    parsing_tree_st *root = parsing_tree_new("program", NULL);
-    parsing_tree_st *node1 = parsing_tree_new("stmt_list", NULL);
-    parsing_tree_st *node2 = parsing_tree_new("stmt", NULL);
-    parsing_tree_set_child(root, node1);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new(";", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    node2 = parsing_tree_new("assign_stmt", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("is", NULL);
-    parsing_tree_set_sibling(node2, node1);
-    node2 = setup_expr_tree_with_number();
-    parsing_tree_set_sibling(node1, node2);
-
-    byte_code = semantic_analysis(root, NULL);
-    link_list_traverse(byte_code, print_byte_code, NULL);
-
-    parsing_tree_free(root);
-    link_list_free(byte_code);
+    ast_node_st *assign = new_leaf(ast, AST_ASSIGN, "i");
+    assign->expr = new_leaf(ast, AST_NUMBER, "3");
+    run_suite("test suite three", ast, assign);
 }
 
 void test_suite_four() {
-    link_list_st *byte_code = NULL;
-
-    printf("test suite four\n");
+    ast_st *ast = ast_init();
 
     // Create syntax tree for "i is i + 3;" statement;
-
-    parsing_tree_st *root = parsing_tree_new("program", NULL);
-    parsing_tree_st *node1 = parsing_tree_new("stmt_list", NULL);
-    parsing_tree_st *node2 = parsing_tree_new("stmt", NULL);
-    parsing_tree_set_child(root, node1);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new(";", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    node2 = parsing_tree_new("assign_stmt", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("is", NULL);
-    parsing_tree_set_sibling(node2, node1);
-    node2 = parsing_tree_new("expr", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    parsing_tree_st *node3 = parsing_tree_new("res1", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node1 = node2;
-    node2 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node2, node1);
-    
-    node1 = node2;
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("-", NULL);
-    parsing_tree_set_child(node3, node1);
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node1, node2);
-    node3 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node1 = parsing_tree_new("3", NULL);
-    parsing_tree_set_child(node2, node1);
-
-    node2 = parsing_tree_new("*", NULL);
-    parsing_tree_set_child(node3, node2);
-    node1 = node2;
-    node2 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    node3 = parsing_tree_new("2", NULL);
-    parsing_tree_set_child(node2, node3);
-
-    byte_code = semantic_analysis(root, NULL);
-    link_list_traverse(byte_code, print_byte_code, NULL);
-
-    parsing_tree_free(root);
-    link_list_free(byte_code);
+    ast_node_st *assign = new_leaf(ast, AST_ASSIGN, "i");
+    assign->expr = new_binary(ast, SYMBOL_ADD, new_leaf(ast, AST_VARIABLE, "i"),
+                              new_leaf(ast, AST_NUMBER, "3"));
+    run_suite("test suite four", ast, assign);
 }
 
 void test_suite_five() {
-    link_list_st *byte_code = NULL;
-
-    printf("test suite five\n");
+    ast_st *ast = ast_init();
 
     // Create syntax tree for "i is i + 10 % i;" statement;
-
-    parsing_tree_st *root = parsing_tree_new("program", NULL);
-    parsing_tree_st *node1 = parsing_tree_new("stmt_list", NULL);
-    parsing_tree_st *node2 = parsing_tree_new("stmt", NULL);
-    parsing_tree_set_child(root, node1);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new(";", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    node2 = parsing_tree_new("assign_stmt", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("is", NULL);
-    parsing_tree_set_sibling(node2, node1);
-    node2 = parsing_tree_new("expr", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    parsing_tree_st *node3 = parsing_tree_new("res1", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node1 = node2;
-    node2 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node2, node1);
-
-    node1 = node2;
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("+", NULL);
-    parsing_tree_set_child(node3, node1);
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node1, node2);
-    node3 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node1 = node2;
-    node2 = parsing_tree_new("10", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node2 = parsing_tree_new("%", NULL);
-    parsing_tree_set_child(node3, node2);
-    node3 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node1 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node3, node1);
-
-    byte_code = semantic_analysis(root, NULL);
-    link_list_traverse(byte_code, print_byte_code, NULL);
-
-    parsing_tree_free(root);
-    link_list_free(byte_code);
+    ast_node_st *assign = new_leaf(ast, AST_ASSIGN, "i");
+    assign->expr = new_binary(ast, SYMBOL_ADD, new_leaf(ast, AST_VARIABLE, "i"),
+                              new_binary(ast, SYMBOL_MOD, new_leaf(ast, AST_NUMBER, "10"),
+                                         new_leaf(ast, AST_VARIABLE, "i")));
+    run_suite("test suite five", ast, assign);
 }
 
 void test_suite_six() {
-    printf("test suite six\n");
-
-    link_list_st *byte_code = NULL;
-    parsing_tree_st *root = parsing_tree_new("program", NULL);
-    parsing_tree_st *node1 = parsing_tree_new("stmt_list", NULL);
-    parsing_tree_st *node2 = parsing_tree_new("stmt", NULL);
-    parsing_tree_set_child(root, node1);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new(";", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    node2 = parsing_tree_new("if_stmt", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    parsing_tree_st *if_stmt = node2;
-    node1 = parsing_tree_new("if", NULL);
-    parsing_tree_set_child(if_stmt, node1);
-    node2 = parsing_tree_new("(", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    parsing_tree_st *bool_expr = parsing_tree_new("boolean_expr", NULL);
-    parsing_tree_set_sibling(node2, bool_expr);
-    node1 = setup_expr_tree_with_number();
-    parsing_tree_set_child(bool_expr, node1);
-    node2 = parsing_tree_new("=", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    node1 = setup_expr_tree_with_number();
-    parsing_tree_set_sibling(node2, node1);
-    node2 = parsing_tree_new(")", NULL);
-    parsing_tree_set_sibling(bool_expr, node2);
-    node1 = parsing_tree_new("then", NULL);
-    parsing_tree_set_sibling(node2, node1);
-    node2 = parsing_tree_new("{", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    parsing_tree_st *then_stmt = parsing_tree_new("stmt_list", NULL);
-    parsing_tree_set_sibling(node2, then_stmt);
-    node1 = parsing_tree_new("}", NULL);
-    parsing_tree_set_sibling(then_stmt, node1);
-    node2 = parsing_tree_new("stmt", NULL);
-    parsing_tree_set_child(then_stmt, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new(";", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    node2 = parsing_tree_new("assign_stmt", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("is", NULL);
-    parsing_tree_set_sibling(node2, node1);
-    node2 = parsing_tree_new("expr", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    parsing_tree_st *node3 = parsing_tree_new("res1", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node1 = node2;
-    node2 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node2, node1);
-
-    node1 = node2;
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("+", NULL);
-    parsing_tree_set_child(node3, node1);
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node1, node2);
-    node3 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node1 = node2;
-    node2 = parsing_tree_new("10", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node2 = parsing_tree_new("%", NULL);
-    parsing_tree_set_child(node3, node2);
-    node3 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node1 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node3, node1);
-
-    parsing_tree_prefix_traverse(root, print_tree, NULL);
-    byte_code = semantic_analysis(root, NULL);
-    link_list_traverse(byte_code, print_byte_code, NULL);
-
-    parsing_tree_free(root);
-    link_list_free(byte_code);
+    ast_st *ast = ast_init();
+
+    // Create syntax tree for "if (3 = 3) then { i is i + 10 % i; } else { print i; };" statement;
+    ast_node_st *if_stmt = ast_new_node(ast, AST_IF, 1, 1);
+    if_stmt->cond = ast_new_node(ast, AST_COMPARE, 1, 1);
+    if_stmt->cond->symbol = SYMBOL_EQUAL;
+    if_stmt->cond->left = new_leaf(ast, AST_NUMBER, "3");
+    if_stmt->cond->right = new_leaf(ast, AST_NUMBER, "3");
+    if_stmt->then_body = new_leaf(ast, AST_ASSIGN, "i");
+    if_stmt->then_body->expr = new_binary(ast, SYMBOL_ADD, new_leaf(ast, AST_VARIABLE, "i"),
+                                          new_binary(ast, SYMBOL_MOD,
+                                                     new_leaf(ast, AST_NUMBER, "10"),
+                                                     new_leaf(ast, AST_VARIABLE, "i")));
+    if_stmt->else_body = ast_new_node(ast, AST_PRINT, 1, 1);
+    if_stmt->else_body->expr = new_leaf(ast, AST_VARIABLE, "i");
+    run_suite("test suite six", ast, if_stmt);
 }
 
 void test_suite_seven() {
-    printf("test suite seven\n");
-
-    link_list_st *byte_code = NULL;
-    parsing_tree_st *root = parsing_tree_new("program", NULL);
-    parsing_tree_st *node1 = parsing_tree_new("stmt_list", NULL);
-    parsing_tree_st *node2 = parsing_tree_new("stmt", NULL);
-    parsing_tree_set_child(root, node1);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new(";", NULL);
-    parsing_tree_set_sibling(node1, node2);
-    parsing_tree_st *node3 = parsing_tree_new("stmt_list", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node2 = parsing_tree_new("decl_stmt", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("var", NULL);
-    parsing_tree_set_child(node2, node1);
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    node1 = parsing_tree_new("stmt", NULL);
-    parsing_tree_set_child(node3, node1);
-    node2 = parsing_tree_new(";", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    node3 = parsing_tree_new("for_stmt", NULL);
-    parsing_tree_set_child(node1, node3);
-
-    node2 = parsing_tree_new("for", NULL);
-    parsing_tree_set_child(node3, node2);
-
-    node1 = parsing_tree_new("i", NULL);
-    parsing_tree_set_sibling(node2, node1);
-    node2 = parsing_tree_new("from", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    parsing_tree_st *expr1_node = parsing_tree_new("expr", NULL);
-    parsing_tree_set_sibling(node2, expr1_node);
-
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_child(expr1_node, node2);
-
-    node3 = parsing_tree_new("res1", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node3 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node2, node3);
-
-    node1 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node3, node1);
-
-    node2 = parsing_tree_new("1", NULL);
-    parsing_tree_set_child(node3, node2);
-
-    node1 = parsing_tree_new("to", NULL);
-    parsing_tree_set_sibling(expr1_node, node1);
-
-    parsing_tree_st *expr2_node = parsing_tree_new("expr", NULL);
-    parsing_tree_set_sibling(node1, expr2_node);
-
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_child(expr2_node, node2);
-
-    node3 = parsing_tree_new("res1", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node3 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node2, node3);
-
-    node1 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node3, node1);
-
-    node2 = parsing_tree_new("10", NULL);
-    parsing_tree_set_child(node3, node2);
-
-    node2 = parsing_tree_new("step", NULL);
-    parsing_tree_set_sibling(expr2_node, node2);
-
-    parsing_tree_st *expr3_node = parsing_tree_new("expr", NULL);
-    parsing_tree_set_sibling(node2, expr3_node);
-
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_child(expr3_node, node2);
-
-    node3 = parsing_tree_new("res1", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node3 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node2, node3);
-
-    node1 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node3, node1);
-
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node3, node2);
-
-    node2 = parsing_tree_new("*", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node3 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node2 = parsing_tree_new("2", NULL);
-    parsing_tree_set_child(node3, node2);
-
-    node2 = parsing_tree_new("{", NULL);
-    parsing_tree_set_sibling(expr3_node, node2);
-
-    node3 = parsing_tree_new("stmt_list", NULL);
-    parsing_tree_set_sibling(node2, node3);
-
-    node1 = parsing_tree_new("stmt", NULL);
-    parsing_tree_set_child(node3, node1);
-    node2 = parsing_tree_new(";", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    node2 = parsing_tree_new("print_stmt", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("print", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("expr", NULL);
-    parsing_tree_set_sibling(node1, node2);
-
-    node1 = node2;
-    node2 = parsing_tree_new("term", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("res1", NULL);
-    parsing_tree_set_sibling(node2, node1);
-
-    node1 = node2;
-    node2 = parsing_tree_new("factor", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node1 = parsing_tree_new("res2", NULL);
-    parsing_tree_set_sibling(node2, node1);
-
-    node1 = node2;
-    node2 = parsing_tree_new("i", NULL);
-    parsing_tree_set_child(node1, node2);
-
-    node2 = parsing_tree_new("}", NULL);
-    parsing_tree_set_sibling(node3, node2);
-
-    fprintf(stderr, "This is the mocking input parsing tree: \n");
-    parsing_tree_prefix_traverse(root, print_tree, NULL);
-    byte_code = semantic_analysis(root, NULL);
-    fprintf(stderr, "This is the output byte code: \n");
-    link_list_traverse(byte_code, print_byte_code, NULL);
-
-    parsing_tree_free(root);
-    link_list_free(byte_code);
+    ast_st *ast = ast_init();
+
+    // Create syntax tree for "var i; for i from 0 to 3 step i + 1 { print i; };" statements;
+    ast_node_st *decl = new_leaf(ast, AST_DECL, "i");
+    ast_node_st *for_stmt = new_leaf(ast, AST_FOR, "i");
+    for_stmt->symbol = SYMBOL_TO;
+    for_stmt->from = new_leaf(ast, AST_NUMBER, "0");
+    for_stmt->to = new_leaf(ast, AST_NUMBER, "3");
+    for_stmt->step = new_binary(ast, SYMBOL_ADD, new_leaf(ast, AST_VARIABLE, "i"),
+                                new_leaf(ast, AST_NUMBER, "1"));
+    for_stmt->body = ast_new_node(ast, AST_PRINT, 1, 1);
+    for_stmt->body->expr = new_leaf(ast, AST_VARIABLE, "i");
+    decl->next = for_stmt;
+    run_suite("test suite seven", ast, decl);
 }
 
 int main() {
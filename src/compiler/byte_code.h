@@ -11,15 +11,15 @@
 
 #include "utils/link_list.h"
 #include "utils/symbol_table.h"
-#include "utils/parsing_tree.h"
+#include "utils/ast.h"
 
 #include "utils/error.h"
 
 /**
- * @brief generate byte code form parsing tree and symbol table.
- * @param node, a valid tree node.
+ * @brief generate byte code from the syntax tree.
+ * @param ast, a valid syntax tree.
  * @return NULL on failed, otherwise a valid link list.
  */
-link_list_st *semantic_analysis(parsing_tree_st *);
+link_list_st *semantic_analysis(ast_st *);
 
 #endif
\ No newline at end of file
@@ -7,19 +7,40 @@
  */
 #include <stdio.h>
 #include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <limits.h>
 
 #include "utils/link_list.h"
 #include "utils/symbol_table.h"
-#include "utils/parsing_tree.h"
+#include "utils/ast.h"
 
 #include "utils/error.h"
 
 #include "lexical.h"
 #include "parser.h"
 #include "byte_code.h"
+#include "emit_exe.h"
+#include "estimate.h"
+#include "time_report.h"
+
+#include "ten_sdt.h"
+#include "chrome_trace.h"
+
+/* static tracepoints, see ten_sdt.h, arg0 is the name of the phase. */
+TEN_SDT_SEMAPHORE(ten, phase__start);
+TEN_SDT_SEMAPHORE(ten, phase__end);
+
+static chrome_trace_st *s_trace;                    /**< chrome trace timeline, NULL for none */
+static const char *s_phase;                         /**< the running phase, NULL for none */
+static double s_phase_start;                        /**< when the running phase started */
+static double s_compile_start;                      /**< when the compilation started */
+static time_report_st *s_time_report;               /**< phase report, NULL for none */
+static char s_temp_path[PATH_MAX];                  /**< byte code of --emit-exe, "" for none */
 
 /**
  * @brief print out the data in the link list node.
@@ -37,6 +58,57 @@ int print_byte_code(link_node_st *node, void *cb_data)
     return LINK_LIST_STOP;
 }
 
+typedef struct line_table_cursor {
+    FILE *fout;                     /**< the line table file */
+    int pc;                         /**< address of the next instruction */
+} line_table_cursor_st;
+
+/**
+ * @brief print out one entry of the line table.
+ * @param node a valid link node.
+ * @param cb_data line table cursor.
+ * @return LINK_LIST_CONTINUE, next node.
+ */
+static int s_print_line_entry(link_node_st *, void *);
+
+/**
+ * @brief write the line table of the byte code into "<asm path>.lines".
+ * @param byte_code the generated byte code.
+ * @param asm_path path of the byte code.
+ * @param input_path path of the source.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_write_line_table(link_list_st *, const char *, const char *);
+
+/**
+ * @brief count a line of byte code into the time report.
+ * @param node a valid link node.
+ * @param cb_data counts, indexed by enum time_report_count.
+ * @return LINK_LIST_CONTINUE, next node.
+ */
+static int s_count_byte_code(link_node_st *, void *);
+
+/**
+ * @brief a compiler phase starts, on the tracepoint and the timeline.
+ * @param name name of the phase.
+ */
+static void s_phase_begin(const char *);
+
+/**
+ * @brief the running phase ends, on the tracepoint and the timeline.
+ */
+static void s_phase_end();
+
+/**
+ * @brief end the running phase and finish the timeline on exit, syntax errors included.
+ */
+static void s_trace_exit();
+
+/**
+ * @brief remove the temporary byte code of --emit-exe on exit, syntax errors included.
+ */
+static void s_temp_exit();
+
 /**
  * @brief output the usage information about the compiler
  */
@@ -51,52 +123,343 @@ static void s_usage();
 int main(int argc, char *argv[])
 {
     struct stat file_stat;
-    if (argc != 3) {
+    const char *input_path;
+    const char *output_path;
+    const char *tmp_dir;
+    const char *trace_path = NULL;
+    uint64_t counts[TIME_REPORT_COUNT];
+    char asm_path[PATH_MAX];
+    int emit_executable = 0;
+    int estimate = 0;
+    int line_table = 0;
+    int option;
+    int fd;
+    int rc;
+
+    static struct option long_options[] = {
+        {"emit-exe",  no_argument,       NULL, 'x'},
+        {"trace-out", required_argument, NULL, 'J'},
+        {"time-report", no_argument,     NULL, 'R'},
+        {"estimate",  no_argument,       NULL, 'E'},
+        {"line-table", no_argument,      NULL, 'L'},
+        {NULL,        0,                 NULL, 0}
+    };
+
+    while ((option = getopt_long(argc, argv, "xJ:REL", long_options, NULL)) != -1) {
+        switch (option) {
+            case 'x':
+                emit_executable = 1;
+                break;
+            case 'J':
+                trace_path = optarg;
+                break;
+            case 'R':
+                s_time_report = time_report_init();
+                break;
+            case 'E':
+                estimate = 1;
+                break;
+            case 'L':
+                line_table = 1;
+                break;
+            default:
+                s_usage();
+                return EINVAL;
+        }
+    }
+
+    // the estimate reads the program only, and writes to stdout.
+    // the executable has no byte code file for the line table to sit next to.
+    if (optind != argc - (estimate ? 1 : 2) || (estimate && emit_executable) ||
+        (line_table && (estimate || emit_executable))) {
         s_usage();
         return 0;
     }
+    input_path = argv[optind];
+    output_path = estimate ? NULL : argv[optind + 1];
 
-    if (stat(argv[1], &file_stat) != 0) {
+    if (stat(input_path, &file_stat) != 0) {
         error_errno(errno);
     }
 
-    freopen(argv[1], "r", stdin);
-    freopen(argv[2], "w", stdout);
+    // the byte code goes to a temporary file, then linked into the executable.
+    if (estimate) {
+        asm_path[0] = '\0';
+    } else if (emit_executable) {
+        tmp_dir = getenv("TMPDIR");
+        if (tmp_dir == NULL || *tmp_dir == '\0')
+            tmp_dir = "/tmp";
+        snprintf(asm_path, sizeof(asm_path), "%s/tenXXXXXX.asm", tmp_dir);
+        fd = mkstemps(asm_path, strlen(".asm"));
+        if (fd < 0)
+            error_errno(errno);
+        close(fd);
+        snprintf(s_temp_path, sizeof(s_temp_path), "%s", asm_path);
+        atexit(s_temp_exit);
+    } else {
+        snprintf(asm_path, sizeof(asm_path), "%s", output_path);
+    }
+
+    if (trace_path != NULL) {
+        s_trace = chrome_trace_open(trace_path, "compiler");
+        if (s_trace == NULL)
+            error_errno(errno);
+        s_compile_start = chrome_trace_now(s_trace);
+        atexit(s_trace_exit);
+    }
+
+    freopen(input_path, "r", stdin);
+    if (!estimate)
+        freopen(asm_path, "w", stdout);
 
     symbol_table_st *symbol_table = symbol_table_init();
     if (symbol_table == NULL)
         return ENOMEM;
 
-    link_list_st *token_list = lexical_analysis(symbol_table);
-    if (token_list == NULL)
+    s_phase_begin("lexical");
+    token_array_st *tokens = lexical_analysis(symbol_table);
+    s_phase_end();
+    if (tokens == NULL)
         return ENOMEM;
 
-    parsing_tree_st *parse_tree = syntax_analysis(token_list, symbol_table);
-    if (parse_tree == NULL)
+    if (s_time_report != NULL) {
+        counts[TIME_REPORT_TOKENS] = token_array_get_count(tokens);
+        time_report_set_count(s_time_report, TIME_REPORT_TOKENS, counts[TIME_REPORT_TOKENS]);
+    }
+
+    s_phase_begin("syntax");
+    ast_st *ast = syntax_analysis(tokens, symbol_table);
+    s_phase_end();
+    if (ast == NULL)
         return ENOMEM;
 
-    link_list_free(token_list);
+    if (s_time_report != NULL) {
+        counts[TIME_REPORT_NODES] = ast_get_node_count(ast);
+        time_report_set_count(s_time_report, TIME_REPORT_NODES, counts[TIME_REPORT_NODES]);
+    }
 
-    link_list_st *byte_code = semantic_analysis(parse_tree);
+    token_array_free(tokens);
+
+    if (estimate) {
+        s_phase_begin("estimate");
+        rc = estimate_write(ast, input_path, stdout);
+        s_phase_end();
+        ast_free(ast);
+        symbol_table_fini(symbol_table);
+        if (s_time_report != NULL) {
+            time_report_write(s_time_report, stderr);
+            time_report_fini(s_time_report);
+            s_time_report = NULL;
+        }
+        return rc < 0 ? EINVAL : 0;
+    }
+
+    s_phase_begin("semantic");
+    link_list_st *byte_code = semantic_analysis(ast);
+    s_phase_end();
     if (byte_code == NULL)
         return ENOMEM;
 
-    parsing_tree_free(parse_tree);
+    if (s_time_report != NULL) {
+        counts[TIME_REPORT_INSTRUCTIONS] = 0;
+        counts[TIME_REPORT_TEMPORARIES] = 0;
+        counts[TIME_REPORT_LABELS] = 0;
+        link_list_traverse(byte_code, s_count_byte_code, counts);
+        time_report_set_count(s_time_report, TIME_REPORT_INSTRUCTIONS,
+                              counts[TIME_REPORT_INSTRUCTIONS]);
+        time_report_set_count(s_time_report, TIME_REPORT_TEMPORARIES,
+                              counts[TIME_REPORT_TEMPORARIES]);
+        time_report_set_count(s_time_report, TIME_REPORT_LABELS, counts[TIME_REPORT_LABELS]);
+    }
+
+    ast_free(ast);
 
+    s_phase_begin("emit");
     link_list_traverse(byte_code, print_byte_code, NULL);
 
+    if (line_table) {
+        rc = s_write_line_table(byte_code, asm_path, input_path);
+        if (rc != 0)
+            fprintf(stderr, "%s.lines: %s\n", asm_path, strerror(rc));
+    }
+    // the byte code is written in this phase, not at exit.
+    if (fflush(stdout) != 0)
+        error_errno(errno);
+    s_phase_end();
+
     link_list_free(byte_code);
 
     symbol_table_fini(symbol_table);
 
+    if (emit_executable) {
+        s_phase_begin("link");
+        rc = emit_exe(asm_path, output_path, argv[0]);
+        s_phase_end();
+        s_temp_exit();
+    }
+
+    if (s_time_report != NULL) {
+        time_report_write(s_time_report, stderr);
+        time_report_fini(s_time_report);
+        s_time_report = NULL;
+    }
+
+    if (emit_executable)
+        return rc;
+
+    return 0;
+}
+
+/**
+ * @brief print out one entry of the line table.
+ * @param node a valid link node.
+ * @param cb_data line table cursor.
+ * @return LINK_LIST_CONTINUE, next node.
+ */
+static int s_print_line_entry(link_node_st *node, void *cb_data) {
+    line_table_cursor_st *cursor = cb_data;
+
+    fprintf(cursor->fout, "%d %d %d\n", cursor->pc++,
+                          link_node_get_line(node), link_node_get_column(node));
+    return LINK_LIST_CONTINUE;
+}
+
+/**
+ * @brief write the line table of the byte code into "<asm path>.lines".
+ *        The first line names the source, then one "pc line column" per
+ *        instruction, line 0 for code not from the source.
+ * @param byte_code the generated byte code.
+ * @param asm_path path of the byte code.
+ * @param input_path path of the source.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_write_line_table(link_list_st *byte_code, const char *asm_path,
+                              const char *input_path) {
+    char table_path[PATH_MAX + 8];
+    char source_path[PATH_MAX];
+    line_table_cursor_st cursor;
+
+    snprintf(table_path, sizeof(table_path), "%s.lines", asm_path);
+    if (realpath(input_path, source_path) == NULL)
+        snprintf(source_path, sizeof(source_path), "%s", input_path);
+
+    cursor.fout = fopen(table_path, "w");
+    if (cursor.fout == NULL)
+        return errno;
+    cursor.pc = 0;
+
+    fprintf(cursor.fout, "source %s\n", source_path);
+    link_list_traverse(byte_code, s_print_line_entry, &cursor);
+
+    if (fclose(cursor.fout) != 0)
+        return errno;
     return 0;
 }
 
+/**
+ * @brief count a line of byte code into the time report.
+ * @param node a valid link node.
+ * @param cb_data counts, indexed by enum time_report_count.
+ * @return LINK_LIST_CONTINUE, next node.
+ */
+static int s_count_byte_code(link_node_st *node, void *cb_data) {
+    uint64_t *counts = (uint64_t *)cb_data;
+    char *str = link_node_get_data(node);
+    size_t length;
+
+    if (str == NULL)
+        return LINK_LIST_CONTINUE;
+
+    counts[TIME_REPORT_INSTRUCTIONS]++;
+    if (strncmp(str, "DEC _temp", strlen("DEC _temp")) == 0)
+        counts[TIME_REPORT_TEMPORARIES]++;
+
+    // labels may be padded, e.g. "for1:  ".
+    length = strlen(str);
+    while (length > 0 && str[length - 1] == ' ')
+        length--;
+    if (length > 0 && str[length - 1] == ':')
+        counts[TIME_REPORT_LABELS]++;
+    return LINK_LIST_CONTINUE;
+}
+
+/**
+ * @brief a compiler phase starts, on the tracepoint and the timeline.
+ * @param name name of the phase.
+ */
+static void s_phase_begin(const char *name) {
+    TEN_SDT_PROBE1(ten, phase__start, name);
+
+    s_phase = name;
+    if (s_trace != NULL)
+        s_phase_start = chrome_trace_now(s_trace);
+    time_report_begin(s_time_report, name);
+}
+
+/**
+ * @brief the running phase ends, on the tracepoint and the timeline.
+ */
+static void s_phase_end() {
+    if (s_phase == NULL)
+        return;
+
+    TEN_SDT_PROBE1(ten, phase__end, s_phase);
+
+    time_report_end(s_time_report);
+
+    if (s_trace != NULL)
+        chrome_trace_span(s_trace, "phase", s_phase, s_phase_start,
+                          chrome_trace_now(s_trace), NULL);
+    s_phase = NULL;
+}
+
+/**
+ * @brief end the running phase and finish the timeline on exit, syntax errors included.
+ */
+static void s_trace_exit() {
+    int rc;
+
+    if (s_trace == NULL)
+        return;
+
+    s_phase_end();
+    chrome_trace_span(s_trace, "phase", "compile", s_compile_start,
+                      chrome_trace_now(s_trace), NULL);
+
+    rc = chrome_trace_close(s_trace);
+    if (rc != 0)
+        fprintf(stderr, "trace failed: %s\n", strerror(rc));
+    s_trace = NULL;
+}
+
+/**
+ * @brief remove the temporary byte code of --emit-exe on exit, syntax errors included.
+ */
+static void s_temp_exit() {
+    if (s_temp_path[0] == '\0')
+        return;
+
+    unlink(s_temp_path);
+    s_temp_path[0] = '\0';
+}
+
 /**
  * @brief output the usage information about the compiler
  */
 static void s_usage() {
     printf("Usage:\n");
-    printf("./compiler <input file> <output file>\n");
+    printf("./compiler [options] <input file> <output file>\n");
     printf("e.g ./compiler program1.ten program1.asm\n");
+    printf("./compiler --estimate <input file>\n");
+    printf("Options:\n");
+    printf("  --emit-exe                  output a self-contained executable,\n");
+    printf("                              e.g ./compiler --emit-exe program1.ten program1\n");
+    printf("  --trace-out <file>          write a timeline of the compiler phases\n");
+    printf("                              in Chrome trace format\n");
+    printf("  --time-report               write the time, heap allocations and peak memory\n");
+    printf("                              of each phase and the size of the program to stderr\n");
+    printf("  --estimate                  write the instructions the program executes and\n");
+    printf("                              the lines it prints, estimated without running it\n");
+    printf("  --line-table                also write <output file>.lines, the source line of\n");
+    printf("                              each instruction for the runtime --sample report\n");
 }
@@ -0,0 +1,170 @@
+/**
+ * @file emit_exe.c
+ * @brief Purpose: build a self-contained executable from the byte code.
+ *
+ * The runtime decodes the byte code and writes it as C arrays
+ * (runtime --emit-c), then the C compiler links them with the runtime
+ * library. The executable starts with the program already decoded.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "emit_exe.h"
+
+#define DEFAULT_CC          "cc"                    /**< C compiler if $CC is not set */
+#define DEFAULT_TMPDIR      "/tmp"                  /**< temporary directory if $TMPDIR is not set */
+
+/**
+ * @brief find the directory of the runtime.
+ * @param argv0 argv[0] of the compiler.
+ * @param dir [out] directory of the runtime.
+ * @param size size of dir.
+ */
+static void s_runtime_dir(const char *, char *, size_t);
+
+/**
+ * @brief run a command and wait for it.
+ * @param argv command and its arguments, NULL terminated.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_run(char *const []);
+
+/**
+ * @brief link the pre-decoded byte code with the runtime into an executable.
+ *        The runtime directory holds runtime, libtenrt.a and instruction.h,
+ *        it is $TEN_RUNTIME_DIR if set, otherwise the directory of the compiler.
+ * @param asm_path path of the byte code.
+ * @param exe_path path of the executable.
+ * @param argv0 argv[0] of the compiler.
+ * @return 0 on success; otherwise errno.
+ */
+int emit_exe(const char *asm_path, const char *exe_path, const char *argv0) {
+    char runtime_dir[PATH_MAX];
+    char runtime_path[PATH_MAX + 16];
+    char library_path[PATH_MAX + 16];
+    char include_flag[PATH_MAX + 2];
+    char source_path[PATH_MAX];
+    const char *tmp_dir;
+    char *cc;
+    int fd;
+    int rc;
+
+    if (asm_path == NULL || exe_path == NULL)
+        return EINVAL;
+
+    s_runtime_dir(argv0, runtime_dir, sizeof(runtime_dir));
+    snprintf(runtime_path, sizeof(runtime_path), "%s/runtime", runtime_dir);
+    snprintf(library_path, sizeof(library_path), "%s/libtenrt.a", runtime_dir);
+    snprintf(include_flag, sizeof(include_flag), "-I%s", runtime_dir);
+
+    if (access(runtime_path, X_OK) != 0 || access(library_path, R_OK) != 0) {
+        fprintf(stderr, "runtime not found in %s, set TEN_RUNTIME_DIR\n", runtime_dir);
+        return ENOENT;
+    }
+
+    tmp_dir = getenv("TMPDIR");
+    if (tmp_dir == NULL || *tmp_dir == '\0')
+        tmp_dir = DEFAULT_TMPDIR;
+    snprintf(source_path, sizeof(source_path), "%s/tenXXXXXX.c", tmp_dir);
+
+    fd = mkstemps(source_path, strlen(".c"));
+    if (fd < 0)
+        return errno;
+    close(fd);
+
+    cc = getenv("CC");
+    if (cc == NULL || *cc == '\0')
+        cc = DEFAULT_CC;
+
+    {
+        char *const decode_argv[] = { runtime_path, "--emit-c", source_path,
+                                      (char *)asm_path, NULL };
+        char *const link_argv[] = { cc, "-O2", "-o", (char *)exe_path, source_path,
+                                    include_flag, library_path, "-lpthread", NULL };
+
+        rc = s_run(decode_argv);
+        if (rc == 0)
+            rc = s_run(link_argv);
+    }
+
+#ifdef DEBUG
+    fprintf(stderr, "emit exe: %s -> %s via %s, rc %d\n", asm_path, exe_path, source_path, rc);
+#else
+    unlink(source_path);
+#endif
+    return rc;
+}
+
+/**
+ * @brief find the directory of the runtime.
+ * @param argv0 argv[0] of the compiler.
+ * @param dir [out] directory of the runtime.
+ * @param size size of dir.
+ */
+static void s_runtime_dir(const char *argv0, char *dir, size_t size) {
+    const char *env;
+    char *slash;
+    ssize_t length;
+
+    env = getenv("TEN_RUNTIME_DIR");
+    if (env != NULL && *env != '\0') {
+        snprintf(dir, size, "%s", env);
+        return;
+    }
+
+    // the runtime is installed next to the compiler.
+    length = readlink("/proc/self/exe", dir, size - 1);
+    if (length > 0) {
+        dir[length] = '\0';
+    } else {
+        snprintf(dir, size, "%s", argv0 ? argv0 : ".");
+    }
+
+    slash = strrchr(dir, '/');
+    if (slash == NULL)
+        snprintf(dir, size, ".");
+    else if (slash == dir)
+        dir[1] = '\0';
+    else
+        *slash = '\0';
+}
+
+/**
+ * @brief run a command and wait for it.
+ * @param argv command and its arguments, NULL terminated.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_run(char *const argv[]) {
+    pid_t pid;
+    int status;
+
+    fflush(NULL);
+    pid = fork();
+    if (pid < 0)
+        return errno;
+
+    if (pid == 0) {
+        execvp(argv[0], argv);
+        fprintf(stderr, "%s: %s\n", argv[0], strerror(errno));
+        _exit(127);
+    }
+
+    while (waitpid(pid, &status, 0) < 0) {
+        if (errno != EINTR)
+            return errno;
+    }
+
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+        return 0;
+
+    fprintf(stderr, "%s failed\n", argv[0]);
+    return ECANCELED;
+}
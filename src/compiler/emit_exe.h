@@ -0,0 +1,22 @@
+/**
+ * @file emit_exe.h
+ * @brief Purpose: build a self-contained executable from the byte code.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+
+#ifndef __EMIT_EXE_H__
+#define __EMIT_EXE_H__
+
+/**
+ * @brief link the pre-decoded byte code with the runtime into an executable.
+ *        The runtime directory holds runtime, libtenrt.a and instruction.h,
+ *        it is $TEN_RUNTIME_DIR if set, otherwise the directory of the compiler.
+ * @param asm_path path of the byte code.
+ * @param exe_path path of the executable.
+ * @param argv0 argv[0] of the compiler.
+ * @return 0 on success; otherwise errno.
+ */
+int emit_exe(const char *, const char *, const char *);
+
+#endif
@@ -0,0 +1,1111 @@
+/**
+ * @file estimate.c
+ * @brief Purpose: estimate the instructions a program executes and the lines
+ *        it prints, from its syntax tree, without running it.
+ *
+ * The cost of each statement is the byte code semantic_analysis() generates
+ * for it, counted as the runtime executes it, labels included. A for loop
+ * runs
+ *
+ *     entry:       init expr, bound expr, MOV, "forN:"
+ *     iteration:   CMP, Jcc, "stmt_list:", body, "stmt_list_end:", step expr, MOV, JMP
+ *     exit:        CMP, Jcc, "forN_end:"
+ *
+ * and its trip count is known when the bounds are known and the step is the
+ * loop variable plus a constant. Inside the body, the loop variable holds
+ * its mean over the iterations, so a bound affine in an outer variable, such
+ * as "for j from i to n", gives the exact total of a triangular nest. A
+ * condition that can't be decided averages the costs of its branches.
+ *
+ * Values are tracked through straight-line code; a variable assigned inside
+ * any loop body is unknown when read inside a loop, and in any loop bound.
+ * A value set in an undecided branch is kept with the branch, and resolved
+ * the next time the variable is used: dropped when its branch is a then
+ * branch whose else branch is being analysed, unknown when its if is over.
+ * Each node is visited once, the step expression three times, and each
+ * value is resolved once, so the analysis is linear in the size of the tree.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/error.h"
+#include "utils/symbol_table.h"
+
+#include "estimate.h"
+
+#define COST_OPERATOR           (3)                 /**< DEC, MOV and the operation of a binary operator */
+#define COST_STATEMENT          (1)                 /**< DEC, MOV or OUT of a simple statement */
+#define COST_COMPARE            (1)                 /**< CMP of a condition */
+#define COST_IF_HEAD            (2)                 /**< "ifN:" and the conditional jump */
+#define COST_IF_SKIP_ELSE       (1)                 /**< JMP over the else branch */
+#define COST_IF_END             (1)                 /**< "ifN_end:" */
+#define COST_FOR_ENTRY          (2)                 /**< MOV of the init value and "forN:" */
+#define COST_FOR_ITERATION      (6)                 /**< CMP, Jcc, both stmt_list labels, MOV, JMP */
+#define COST_FOR_EXIT           (3)                 /**< CMP, Jcc and "forN_end:" */
+#define DEFAULT_TABLE_SIZE      (64)                /**< slots of the variable table at first */
+#define RESIZE_FACTOR           (2)                 /**< resize factor of the dynamic arrays */
+#define MAX_NOTES               (16)                /**< notes kept for the report */
+#define NOTE_SIZE               (128)               /**< longest note */
+
+enum frame_state {
+    FRAME_OPEN = 0,                                 /**< holds the statement being analysed */
+    FRAME_DISCARDED,                                /**< then branch, its else branch is being analysed */
+    FRAME_MERGED,                                   /**< branch of a finished if, merged into its parent */
+};
+
+enum value_state {
+    VALUE_UNKNOWN = 0,                              /**< can't be told statically */
+    VALUE_EXACT,                                    /**< the value every time */
+    VALUE_MEAN,                                     /**< the mean over the iterations of a loop */
+};
+
+typedef struct value {
+    double number;                                  /**< the value, unless unknown */
+    int state;                                      /**< enum value_state */
+} value_st;
+
+typedef struct cost {
+    double instructions;                            /**< instructions executed */
+    double lines;                                   /**< lines printed */
+    int instructions_precision;                     /**< enum estimate_precision */
+    int lines_precision;                            /**< enum estimate_precision */
+} cost_st;
+
+typedef struct variable {
+    const char *name;                               /**< name, owned by the symbol table */
+    int top;                                        /**< entry of the latest value */
+    int loop_assigned;                              /**< 1 if assigned inside a loop body */
+} variable_st;
+
+typedef struct entry {
+    value_st value;                                 /**< value set in the branch */
+    int frame;                                      /**< branch that set it */
+    int below;                                      /**< entry of an enclosing branch, -1 for none */
+} entry_st;
+
+typedef struct frame {
+    int parent;                                     /**< enclosing branch, -1 for the program */
+    int state;                                      /**< enum frame_state */
+    int else_frame;                                 /**< else branch of a then branch, -1 for none */
+} frame_st;
+
+typedef struct estimate {
+    variable_st *variables;                         /**< all variables, by index */
+    int variable_count;                             /**< total of variables */
+    int variable_capacity;                          /**< capacity of variables */
+    int *slots;                                     /**< hash table of indexes, -1 for empty */
+    int slot_capacity;                              /**< slots of the table, a power of 2 */
+    entry_st *entries;                              /**< values of the variables, by branch */
+    int entry_count;                                /**< total of entries */
+    int entry_capacity;                             /**< capacity of entries */
+    frame_st *frames;                               /**< undecided branches, 0 for the program */
+    int frame_count;                                /**< total of frames */
+    int frame_capacity;                             /**< capacity of frames */
+    int frame;                                      /**< branch being analysed */
+    int depth;                                      /**< loops around the current statement */
+    char notes[MAX_NOTES][NOTE_SIZE];               /**< why a loop is not known */
+    int note_count;                                 /**< notes, kept or not */
+} estimate_st;
+
+static const char *s_precision_names[] = {
+    [ESTIMATE_EXACT]        = "exact",
+    [ESTIMATE_APPROXIMATE]  = "approximate",
+    [ESTIMATE_UNKNOWN]      = "unknown",
+    [ESTIMATE_UNBOUNDED]    = "unbounded",
+};
+
+/**
+ * @brief mark the variables assigned inside a loop body.
+ * @param estimate [in/out] the analysis.
+ * @param node the first statement of a list.
+ * @param depth loops around the list.
+ */
+static void s_mark(estimate_st *, ast_node_st *, int);
+
+/**
+ * @brief estimate a list of statements.
+ * @param estimate [in/out] the analysis.
+ * @param node the first statement of a list.
+ * @param cost [out] cost of the list.
+ */
+static void s_stmt_list(estimate_st *, ast_node_st *, cost_st *);
+
+/**
+ * @brief estimate a statement.
+ * @param estimate [in/out] the analysis.
+ * @param node a statement.
+ * @param cost [in/out] the cost is added up.
+ */
+static void s_stmt(estimate_st *, ast_node_st *, cost_st *);
+
+/**
+ * @brief estimate an if statement.
+ * @param estimate [in/out] the analysis.
+ * @param node an AST_IF node.
+ * @param cost [in/out] the cost is added up.
+ */
+static void s_if_stmt(estimate_st *, ast_node_st *, cost_st *);
+
+/**
+ * @brief estimate a for statement.
+ * @param estimate [in/out] the analysis.
+ * @param node an AST_FOR node.
+ * @param cost [in/out] the cost is added up.
+ */
+static void s_for_stmt(estimate_st *, ast_node_st *, cost_st *);
+
+/**
+ * @brief evaluate a condition.
+ * @param estimate [in/out] the analysis.
+ * @param node an AST_COMPARE or AST_BOOLEAN node.
+ * @param instructions [out] instructions of the condition, CMP included.
+ * @return 1 for true, 0 for false, -1 if it can't be told.
+ */
+static int s_boolean_expr(estimate_st *, ast_node_st *, double *);
+
+/**
+ * @brief evaluate an expression.
+ * @param estimate [in/out] the analysis.
+ * @param node an expression node.
+ * @param value [out] value of the expression.
+ * @return instructions of the expression.
+ */
+static double s_expr(estimate_st *, ast_node_st *, value_st *);
+
+/**
+ * @brief evaluate an operand, a number or a variable.
+ * @param estimate [in/out] the analysis.
+ * @param node an AST_NUMBER or AST_VARIABLE node.
+ * @param value [out] value of the operand.
+ * @return instructions of the operand.
+ */
+static double s_factor(estimate_st *, ast_node_st *, value_st *);
+
+/**
+ * @brief apply a binary operator the way the runtime does, on int.
+ * @param left left operand.
+ * @param operator symbol id, from SYMBOL_ADD to SYMBOL_MOD.
+ * @param right right operand.
+ * @return the result.
+ */
+static value_st s_operate(value_st, int, value_st);
+
+/**
+ * @brief find a variable, add it if new.
+ * @param estimate [in/out] the analysis.
+ * @param name name of the variable.
+ * @return index of the variable.
+ */
+static int s_variable(estimate_st *, const char *);
+
+/**
+ * @brief set a variable in the branch being analysed.
+ * @param estimate [in/out] the analysis.
+ * @param name name of the variable.
+ * @param value the new value.
+ */
+static void s_assign(estimate_st *, const char *, value_st);
+
+/**
+ * @brief set a variable in the branch being analysed.
+ * @param estimate [in/out] the analysis.
+ * @param index index of the variable.
+ * @param value the new value.
+ */
+static void s_set(estimate_st *, int, value_st);
+
+/**
+ * @brief get the value of a variable at this point of the program.
+ * @param estimate [in/out] the analysis.
+ * @param index index of the variable.
+ * @return the value.
+ */
+static value_st s_value(estimate_st *, int);
+
+/**
+ * @brief drop or merge the values a variable got in closed branches.
+ * @param estimate [in/out] the analysis.
+ * @param index index of the variable.
+ * @return the entry of the value, set in an open branch.
+ */
+static int s_resolve(estimate_st *, int);
+
+/**
+ * @brief add an entry on top of the values of a variable.
+ * @param estimate [in/out] the analysis.
+ * @param index index of the variable.
+ * @param frame branch setting the value.
+ * @param value the value.
+ */
+static void s_push(estimate_st *, int, int, value_st);
+
+/**
+ * @brief open a branch.
+ * @param estimate [in/out] the analysis.
+ * @param parent enclosing branch, -1 for the program.
+ * @return index of the branch.
+ */
+static int s_frame_open(estimate_st *, int);
+
+/**
+ * @brief find the branch a closed branch is merged into, shortening the way.
+ * @param estimate [in/out] the analysis.
+ * @param frame a branch.
+ * @return the first branch up that is open or discarded.
+ */
+static int s_frame_find(estimate_st *, int);
+
+/**
+ * @brief multiply a cost by a trip count.
+ * @param cost [in/out] the cost of one trip.
+ * @param trips trip count.
+ * @param precision enum estimate_precision of the trip count.
+ */
+static void s_cost_scale(cost_st *, double, int);
+
+/**
+ * @brief add a cost to another.
+ * @param total [in/out] the sum.
+ * @param cost the cost added.
+ */
+static void s_cost_add(cost_st *, const cost_st *);
+
+/**
+ * @brief keep a note for the report.
+ * @param estimate [in/out] the analysis.
+ * @param node the node the note is about.
+ * @param format printf format of the note.
+ */
+static void s_note(estimate_st *, ast_node_st *, const char *, ...);
+
+/**
+ * @brief write a number of the report with its precision.
+ * @param fout output stream.
+ * @param name name of the number.
+ * @param number the number.
+ * @param precision enum estimate_precision.
+ */
+static void s_write_number(FILE *, const char *, double, int);
+
+/**
+ * @brief estimate a program and write the report, in linear time over the tree.
+ * @param ast the syntax tree of the program.
+ * @param program name of the program in the report.
+ * @param fout output stream of the report.
+ * @return enum estimate_precision of the instruction count, -1 on an empty tree.
+ */
+int estimate_write(ast_st *ast, const char *program, FILE *fout) {
+    estimate_st estimate;
+    cost_st cost;
+    int i;
+
+    if (ast_get_root(ast) == NULL)
+        return -1;
+
+    memset(&estimate, 0, sizeof(estimate));
+    estimate.slot_capacity = DEFAULT_TABLE_SIZE;
+    estimate.slots = (int *)malloc(estimate.slot_capacity * sizeof(int));
+    if (estimate.slots == NULL)
+        error_errno(ENOMEM);
+    memset(estimate.slots, -1, estimate.slot_capacity * sizeof(int));
+    estimate.frame = s_frame_open(&estimate, -1);
+
+    s_mark(&estimate, ast_get_root(ast), 0);
+    s_stmt_list(&estimate, ast_get_root(ast), &cost);
+
+    fprintf(fout, "%-16s %s\n", "program", program);
+    s_write_number(fout, "instructions", cost.instructions, cost.instructions_precision);
+    s_write_number(fout, "output lines", cost.lines, cost.lines_precision);
+    for (i = 0; i < estimate.note_count && i < MAX_NOTES; i++)
+        fprintf(fout, "%-16s %s\n", "note", estimate.notes[i]);
+    if (estimate.note_count > MAX_NOTES)
+        fprintf(fout, "%-16s %d more\n", "note", estimate.note_count - MAX_NOTES);
+
+    free(estimate.variables);
+    free(estimate.slots);
+    free(estimate.entries);
+    free(estimate.frames);
+    return cost.instructions_precision;
+}
+
+/**
+ * @brief mark the variables assigned inside a loop body.
+ * @param estimate [in/out] the analysis.
+ * @param node the first statement of a list.
+ * @param depth loops around the list.
+ */
+static void s_mark(estimate_st *estimate, ast_node_st *node, int depth) {
+    int index;
+
+    for (; node != NULL; node = node->next) {
+        if (node->kind == AST_ASSIGN && depth > 0) {
+            index = s_variable(estimate, node->text);
+            estimate->variables[index].loop_assigned = 1;
+        } else if (node->kind == AST_IF) {
+            s_mark(estimate, node->then_body, depth);
+            s_mark(estimate, node->else_body, depth);
+        } else if (node->kind == AST_FOR) {
+            s_mark(estimate, node->body, depth + 1);
+        }
+    }
+}
+
+/**
+ * @brief estimate a list of statements.
+ * @param estimate [in/out] the analysis.
+ * @param node the first statement of a list.
+ * @param cost [out] cost of the list.
+ */
+static void s_stmt_list(estimate_st *estimate, ast_node_st *node, cost_st *cost) {
+    memset(cost, 0, sizeof(*cost));
+
+    for (; node != NULL; node = node->next)
+        s_stmt(estimate, node, cost);
+}
+
+/**
+ * @brief estimate a statement.
+ * @param estimate [in/out] the analysis.
+ * @param node a statement.
+ * @param cost [in/out] the cost is added up.
+ */
+static void s_stmt(estimate_st *estimate, ast_node_st *node, cost_st *cost) {
+    value_st value;
+
+    switch (node->kind) {
+        case AST_DECL:
+            value.state = VALUE_UNKNOWN;
+            s_assign(estimate, node->text, value);
+            cost->instructions += COST_STATEMENT;
+            break;
+        case AST_ASSIGN:
+            cost->instructions += s_expr(estimate, node->expr, &value) + COST_STATEMENT;
+            // inside a loop the value changes between iterations.
+            if (estimate->depth > 0)
+                value.state = VALUE_UNKNOWN;
+            s_assign(estimate, node->text, value);
+            break;
+        case AST_PRINT:
+            cost->instructions += s_expr(estimate, node->expr, &value) + COST_STATEMENT;
+            cost->lines += 1;
+            break;
+        case AST_IF:
+            s_if_stmt(estimate, node, cost);
+            break;
+        case AST_FOR:
+            s_for_stmt(estimate, node, cost);
+            break;
+    }
+}
+
+/**
+ * @brief estimate an if statement.
+ * @param estimate [in/out] the analysis.
+ * @param node an AST_IF node.
+ * @param cost [in/out] the cost is added up.
+ */
+static void s_if_stmt(estimate_st *estimate, ast_node_st *node, cost_st *cost) {
+    ast_node_st *else_list = node->else_body;
+    cost_st then_cost;
+    cost_st else_cost;
+    double instructions;
+    int parent;
+    int then_frame;
+    int else_frame;
+    int condition;
+
+    condition = s_boolean_expr(estimate, node->cond, &instructions);
+    cost->instructions += COST_IF_HEAD + instructions + COST_IF_END;
+
+    memset(&else_cost, 0, sizeof(else_cost));
+    if (condition == 1) {
+        s_stmt_list(estimate, node->then_body, &then_cost);
+        if (else_list != NULL)
+            then_cost.instructions += COST_IF_SKIP_ELSE;
+        s_cost_add(cost, &then_cost);
+        return;
+    }
+    if (condition == 0) {
+        if (else_list != NULL)
+            s_stmt_list(estimate, else_list, &else_cost);
+        s_cost_add(cost, &else_cost);
+        return;
+    }
+
+    // either branch may run, the variables set by any of them are unknown after.
+    parent = estimate->frame;
+    then_frame = s_frame_open(estimate, parent);
+    estimate->frame = then_frame;
+    s_stmt_list(estimate, node->then_body, &then_cost);
+    if (else_list != NULL)
+        then_cost.instructions += COST_IF_SKIP_ELSE;
+    // the else branch sees the values from before the if.
+    estimate->frames[then_frame].state = FRAME_DISCARDED;
+    else_frame = s_frame_open(estimate, parent);
+    estimate->frames[then_frame].else_frame = else_frame;
+    estimate->frame = else_frame;
+    if (else_list != NULL)
+        s_stmt_list(estimate, else_list, &else_cost);
+    estimate->frames[then_frame].state = FRAME_MERGED;
+    estimate->frames[else_frame].state = FRAME_MERGED;
+    estimate->frame = parent;
+
+    if (then_cost.instructions != else_cost.instructions ||
+        then_cost.instructions_precision != ESTIMATE_EXACT) {
+        then_cost.instructions = (then_cost.instructions + else_cost.instructions) / 2;
+        if (then_cost.instructions_precision < ESTIMATE_APPROXIMATE)
+            then_cost.instructions_precision = ESTIMATE_APPROXIMATE;
+    }
+    if (then_cost.lines != else_cost.lines) {
+        then_cost.lines = (then_cost.lines + else_cost.lines) / 2;
+        if (then_cost.lines_precision < ESTIMATE_APPROXIMATE)
+            then_cost.lines_precision = ESTIMATE_APPROXIMATE;
+    }
+    if (else_cost.instructions_precision > then_cost.instructions_precision)
+        then_cost.instructions_precision = else_cost.instructions_precision;
+    if (else_cost.lines_precision > then_cost.lines_precision)
+        then_cost.lines_precision = else_cost.lines_precision;
+    s_cost_add(cost, &then_cost);
+}
+
+/**
+ * @brief estimate a for statement.
+ * @param estimate [in/out] the analysis.
+ * @param node an AST_FOR node.
+ * @param cost [in/out] the cost is added up.
+ */
+static void s_for_stmt(estimate_st *estimate, ast_node_st *node, cost_st *cost) {
+    const char *name = node->text;
+    int downto = node->symbol == SYMBOL_DOWNTO;
+    ast_node_st *step = node->step;
+    variable_st *variable;
+    value_st start, bound, at[3], mean;
+    cost_st body;
+    double step_instructions;
+    double increment;
+    double trips = 0;
+    int precision = ESTIMATE_EXACT;
+    int index;
+    int i;
+
+    cost->instructions += s_expr(estimate, node->from, &start);
+    // a bound changed by the body is read again by every CMP.
+    estimate->depth++;
+    cost->instructions += s_expr(estimate, node->to, &bound);
+    estimate->depth--;
+    cost->instructions += COST_FOR_ENTRY;
+
+    // the step must be the loop variable plus a constant: f(x) = x + c.
+    index = s_variable(estimate, name);
+    mean = s_value(estimate, index);
+    estimate->depth++;
+    for (i = 0; i < 3; i++) {
+        at[i].number = i;
+        at[i].state = VALUE_EXACT;
+        s_set(estimate, index, at[i]);
+        step_instructions = s_expr(estimate, step, &at[i]);
+    }
+    estimate->depth--;
+    s_set(estimate, index, mean);
+    // the step may add variables, and move the table.
+    variable = &(estimate->variables[index]);
+    increment = at[0].number;
+
+    if (variable->loop_assigned) {
+        precision = ESTIMATE_UNKNOWN;
+        s_note(estimate, node, "for %s: the loop variable is assigned in the body", name);
+    } else if (at[0].state == VALUE_UNKNOWN || at[1].state == VALUE_UNKNOWN ||
+               at[2].state == VALUE_UNKNOWN ||
+               at[1].number - at[0].number != 1 || at[2].number - at[1].number != 1) {
+        precision = ESTIMATE_UNKNOWN;
+        s_note(estimate, node, "for %s: the step is not %s plus a constant", name, name);
+    } else if (start.state == VALUE_UNKNOWN || bound.state == VALUE_UNKNOWN) {
+        precision = ESTIMATE_UNKNOWN;
+        s_note(estimate, node, "for %s: a bound is not constant or affine", name);
+    } else {
+        // "to" runs while var < bound, "downto" while var > bound.
+        double distance = downto ? start.number - bound.number : bound.number - start.number;
+        double stride = downto ? -increment : increment;
+
+        if (start.state == VALUE_EXACT && bound.state == VALUE_EXACT &&
+            at[0].state == VALUE_EXACT) {
+            if (distance > 0 && stride <= 0) {
+                precision = ESTIMATE_UNBOUNDED;
+                s_note(estimate, node, "for %s: the step never reaches the bound", name);
+            } else {
+                trips = distance > 0 ?
+                        (double)(((int64_t)distance + (int64_t)stride - 1) / (int64_t)stride) : 0;
+            }
+        } else if (stride <= 0) {
+            precision = ESTIMATE_UNKNOWN;
+            s_note(estimate, node, "for %s: the step may never reach the bound", name);
+        } else {
+            trips = distance > 0 ? distance / stride : 0;
+            precision = ESTIMATE_APPROXIMATE;
+        }
+    }
+
+    // the body sees the mean of the loop variable over the iterations.
+    mean.state = VALUE_UNKNOWN;
+    if (precision <= ESTIMATE_APPROXIMATE && trips > 0) {
+        mean.number = start.number + increment * (trips - 1) / 2;
+        mean.state = (trips == 1 && precision == ESTIMATE_EXACT) ? VALUE_EXACT : VALUE_MEAN;
+    }
+    s_set(estimate, index, mean);
+
+    estimate->depth++;
+    if (precision == ESTIMATE_EXACT && trips == 0)
+        memset(&body, 0, sizeof(body));
+    else
+        s_stmt_list(estimate, node->body, &body);
+    estimate->depth--;
+
+    body.instructions += step_instructions + COST_FOR_ITERATION;
+    s_cost_scale(&body, trips, precision);
+    s_cost_add(cost, &body);
+    cost->instructions += COST_FOR_EXIT;
+
+    // the loop variable after the loop.
+    mean.state = VALUE_UNKNOWN;
+    if (precision <= ESTIMATE_APPROXIMATE) {
+        mean.number = start.number + increment * trips;
+        mean.state = precision == ESTIMATE_EXACT ? VALUE_EXACT : VALUE_MEAN;
+    }
+    s_assign(estimate, name, mean);
+}
+
+/**
+ * @brief evaluate a condition.
+ * @param estimate [in/out] the analysis.
+ * @param node an AST_COMPARE or AST_BOOLEAN node.
+ * @param instructions [out] instructions of the condition, CMP included.
+ * @return 1 for true, 0 for false, -1 if it can't be told.
+ */
+static int s_boolean_expr(estimate_st *estimate, ast_node_st *node, double *instructions) {
+    value_st left, right;
+
+    *instructions = COST_COMPARE;
+    if (node->kind == AST_BOOLEAN)
+        return node->symbol == SYMBOL_TRUE;
+
+    *instructions += s_expr(estimate, node->left, &left);
+    *instructions += s_expr(estimate, node->right, &right);
+    if (left.state != VALUE_EXACT || right.state != VALUE_EXACT)
+        return -1;
+
+    switch (node->symbol) {
+        case SYMBOL_EQUAL:
+            return left.number == right.number;
+        case SYMBOL_NOT_EQUAL:
+            return left.number != right.number;
+        case SYMBOL_GREATER:
+            return left.number > right.number;
+        case SYMBOL_GREATER_EQUAL:
+            return left.number >= right.number;
+        case SYMBOL_LESS:
+            return left.number < right.number;
+        case SYMBOL_LESS_EQUAL:
+            return left.number <= right.number;
+    }
+    return -1;
+}
+
+/**
+ * @brief evaluate an expression.
+ * @param estimate [in/out] the analysis.
+ * @param node an expression node.
+ * @param value [out] value of the expression.
+ * @return instructions of the expression.
+ */
+static double s_expr(estimate_st *estimate, ast_node_st *node, value_st *value) {
+    value_st right;
+    double instructions;
+
+    if (node->kind != AST_BINARY)
+        return s_factor(estimate, node, value);
+
+    instructions = s_expr(estimate, node->left, value);
+    instructions += s_expr(estimate, node->right, &right) + COST_OPERATOR;
+    *value = s_operate(*value, node->symbol, right);
+    return instructions;
+}
+
+/**
+ * @brief evaluate an operand, a number or a variable.
+ * @param estimate [in/out] the analysis.
+ * @param node an AST_NUMBER or AST_VARIABLE node.
+ * @param value [out] value of the operand.
+ * @return instructions of the operand.
+ */
+static double s_factor(estimate_st *estimate, ast_node_st *node, value_st *value) {
+    variable_st *variable;
+    int index;
+
+    if (node->kind == AST_NUMBER) {
+        value->number = (int)strtol(node->text, NULL, 10);
+        value->state = VALUE_EXACT;
+        return 0;
+    }
+
+    index = s_variable(estimate, node->text);
+    *value = s_value(estimate, index);
+    variable = &(estimate->variables[index]);
+    if (variable->loop_assigned && estimate->depth > 0)
+        value->state = VALUE_UNKNOWN;
+    return 0;
+}
+
+/**
+ * @brief apply a binary operator the way the runtime does, on int.
+ * @param left left operand.
+ * @param operator symbol id, from SYMBOL_ADD to SYMBOL_MOD.
+ * @param right right operand.
+ * @return the result.
+ */
+static value_st s_operate(value_st left, int operator, value_st right) {
+    value_st result;
+
+    result.number = 0;
+    result.state = VALUE_UNKNOWN;
+    if (left.state == VALUE_UNKNOWN || right.state == VALUE_UNKNOWN)
+        return result;
+
+    if (left.state == VALUE_EXACT && right.state == VALUE_EXACT) {
+        int32_t l = (int32_t)left.number;
+        int32_t r = (int32_t)right.number;
+
+        result.state = VALUE_EXACT;
+        switch (operator) {
+            case SYMBOL_ADD:
+                result.number = (int32_t)((uint32_t)l + (uint32_t)r);
+                break;
+            case SYMBOL_SUB:
+                result.number = (int32_t)((uint32_t)l - (uint32_t)r);
+                break;
+            case SYMBOL_MUL:
+                result.number = (int32_t)((uint32_t)l * (uint32_t)r);
+                break;
+            case SYMBOL_DIV:
+            case SYMBOL_MOD:
+                // the runtime fails on these, the estimate doesn't guess.
+                if (r == 0 || (l == INT32_MIN && r == -1))
+                    result.state = VALUE_UNKNOWN;
+                else
+                    result.number = operator == SYMBOL_DIV ? l / r : l % r;
+                break;
+            default:
+                result.state = VALUE_UNKNOWN;
+        }
+        return result;
+    }
+
+    // a mean stays a mean through affine operations only.
+    result.state = VALUE_MEAN;
+    switch (operator) {
+        case SYMBOL_ADD:
+            result.number = left.number + right.number;
+            break;
+        case SYMBOL_SUB:
+            result.number = left.number - right.number;
+            break;
+        case SYMBOL_MUL:
+            result.number = left.number * right.number;
+            break;
+        case SYMBOL_DIV:
+            if (right.state == VALUE_EXACT && right.number != 0)
+                result.number = left.number / right.number;
+            else
+                result.state = VALUE_UNKNOWN;
+            break;
+        default:
+            result.state = VALUE_UNKNOWN;
+    }
+    return result;
+}
+
+/**
+ * @brief find a variable, add it if new.
+ * @param estimate [in/out] the analysis.
+ * @param name name of the variable.
+ * @return index of the variable.
+ */
+static int s_variable(estimate_st *estimate, const char *name) {
+    uint32_t hash = 2166136261u;
+    const char *c;
+    int mask;
+    int slot;
+    int index;
+    int i;
+
+    for (c = name; *c != '\0'; c++)
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+
+    mask = estimate->slot_capacity - 1;
+    for (slot = hash & mask; estimate->slots[slot] != -1; slot = (slot + 1) & mask) {
+        index = estimate->slots[slot];
+        if (strcmp(estimate->variables[index].name, name) == 0)
+            return index;
+    }
+
+    if (estimate->variable_count == estimate->variable_capacity) {
+        estimate->variable_capacity = estimate->variable_capacity ?
+                                      estimate->variable_capacity * RESIZE_FACTOR :
+                                      DEFAULT_TABLE_SIZE;
+        estimate->variables = (variable_st *)realloc(estimate->variables,
+                                  estimate->variable_capacity * sizeof(variable_st));
+        if (estimate->variables == NULL)
+            error_errno(ENOMEM);
+    }
+    index = estimate->variable_count++;
+    memset(&(estimate->variables[index]), 0, sizeof(variable_st));
+    estimate->variables[index].name = name;
+    estimate->variables[index].top = -1;
+    estimate->slots[slot] = index;
+    // unknown before its declaration, in every branch.
+    s_push(estimate, index, 0, (value_st){ 0, VALUE_UNKNOWN });
+
+    // keep the table half empty, rehash into a larger one.
+    if (estimate->variable_count * 2 > estimate->slot_capacity) {
+        estimate->slot_capacity *= RESIZE_FACTOR;
+        estimate->slots = (int *)realloc(estimate->slots, estimate->slot_capacity * sizeof(int));
+        if (estimate->slots == NULL)
+            error_errno(ENOMEM);
+        memset(estimate->slots, -1, estimate->slot_capacity * sizeof(int));
+        mask = estimate->slot_capacity - 1;
+        for (i = 0; i < estimate->variable_count; i++) {
+            hash = 2166136261u;
+            for (c = estimate->variables[i].name; *c != '\0'; c++)
+                hash = (hash ^ (unsigned char)*c) * 16777619u;
+            for (slot = hash & mask; estimate->slots[slot] != -1; slot = (slot + 1) & mask)
+                ;
+            estimate->slots[slot] = i;
+        }
+    }
+    return index;
+}
+
+/**
+ * @brief set a variable in the branch being analysed.
+ * @param estimate [in/out] the analysis.
+ * @param name name of the variable.
+ * @param value the new value.
+ */
+static void s_assign(estimate_st *estimate, const char *name, value_st value) {
+    s_set(estimate, s_variable(estimate, name), value);
+}
+
+/**
+ * @brief set a variable in the branch being analysed.
+ * @param estimate [in/out] the analysis.
+ * @param index index of the variable.
+ * @param value the new value.
+ */
+static void s_set(estimate_st *estimate, int index, value_st value) {
+    int top = s_resolve(estimate, index);
+
+    if (estimate->entries[top].frame == estimate->frame)
+        estimate->entries[top].value = value;
+    else
+        s_push(estimate, index, estimate->frame, value);
+}
+
+/**
+ * @brief get the value of a variable at this point of the program.
+ * @param estimate [in/out] the analysis.
+ * @param index index of the variable.
+ * @return the value.
+ */
+static value_st s_value(estimate_st *estimate, int index) {
+    return estimate->entries[s_resolve(estimate, index)].value;
+}
+
+/**
+ * @brief drop or merge the values a variable got in closed branches.
+ * @param estimate [in/out] the analysis.
+ * @param index index of the variable.
+ * @return the entry of the value, set in an open branch.
+ */
+static int s_resolve(estimate_st *estimate, int index) {
+    variable_st *variable = &(estimate->variables[index]);
+    entry_st *entries = estimate->entries;
+    int frame;
+
+    // the entries of a variable are in the order the branches opened, so the
+    // ones of a closed branch and of the branches inside it are on top.
+    for (;;) {
+        frame = s_frame_find(estimate, entries[variable->top].frame);
+        if (estimate->frames[frame].state == FRAME_DISCARDED) {
+            // set in a then branch: the else branch sees the value from before
+            // the if, the else branch keeps it so it is unknown after the if.
+            while (entries[variable->top].frame >= frame)
+                variable->top = entries[variable->top].below;
+            s_push(estimate, index, estimate->frames[frame].else_frame,
+                   entries[variable->top].value);
+            return estimate->variables[index].top;
+        }
+        if (entries[variable->top].frame == frame)
+            return variable->top;
+
+        // set by an if that is over, either branch may have run.
+        while (entries[variable->top].frame > frame)
+            variable->top = entries[variable->top].below;
+        if (entries[variable->top].frame == frame) {
+            entries[variable->top].value.state = VALUE_UNKNOWN;
+            return variable->top;
+        }
+        s_push(estimate, index, frame, (value_st){ 0, VALUE_UNKNOWN });
+        return estimate->variables[index].top;
+    }
+}
+
+/**
+ * @brief add an entry on top of the values of a variable.
+ * @param estimate [in/out] the analysis.
+ * @param index index of the variable.
+ * @param frame branch setting the value.
+ * @param value the value.
+ */
+static void s_push(estimate_st *estimate, int index, int frame, value_st value) {
+    entry_st *entry;
+
+    if (estimate->entry_count == estimate->entry_capacity) {
+        estimate->entry_capacity = estimate->entry_capacity ?
+                                   estimate->entry_capacity * RESIZE_FACTOR : DEFAULT_TABLE_SIZE;
+        estimate->entries = (entry_st *)realloc(estimate->entries,
+                                estimate->entry_capacity * sizeof(entry_st));
+        if (estimate->entries == NULL)
+            error_errno(ENOMEM);
+    }
+    entry = &(estimate->entries[estimate->entry_count]);
+    entry->value = value;
+    entry->frame = frame;
+    entry->below = estimate->variables[index].top;
+    estimate->variables[index].top = estimate->entry_count++;
+}
+
+/**
+ * @brief open a branch.
+ * @param estimate [in/out] the analysis.
+ * @param parent enclosing branch, -1 for the program.
+ * @return index of the branch.
+ */
+static int s_frame_open(estimate_st *estimate, int parent) {
+    if (estimate->frame_count == estimate->frame_capacity) {
+        estimate->frame_capacity = estimate->frame_capacity ?
+                                   estimate->frame_capacity * RESIZE_FACTOR : DEFAULT_TABLE_SIZE;
+        estimate->frames = (frame_st *)realloc(estimate->frames,
+                               estimate->frame_capacity * sizeof(frame_st));
+        if (estimate->frames == NULL)
+            error_errno(ENOMEM);
+    }
+    estimate->frames[estimate->frame_count].parent = parent;
+    estimate->frames[estimate->frame_count].state = FRAME_OPEN;
+    estimate->frames[estimate->frame_count].else_frame = -1;
+    return estimate->frame_count++;
+}
+
+/**
+ * @brief find the branch a closed branch is merged into, shortening the way.
+ * @param estimate [in/out] the analysis.
+ * @param frame a branch.
+ * @return the first branch up that is open or discarded.
+ */
+static int s_frame_find(estimate_st *estimate, int frame) {
+    frame_st *frames = estimate->frames;
+    int found = frame;
+    int parent;
+
+    while (frames[found].state == FRAME_MERGED)
+        found = frames[found].parent;
+    while (frame != found) {
+        parent = frames[frame].parent;
+        frames[frame].parent = found;
+        frame = parent;
+    }
+    return found;
+}
+
+/**
+ * @brief multiply a cost by a trip count.
+ * @param cost [in/out] the cost of one trip.
+ * @param trips trip count.
+ * @param precision enum estimate_precision of the trip count.
+ */
+static void s_cost_scale(cost_st *cost, double trips, int precision) {
+    cost->instructions *= trips;
+    if (precision > cost->instructions_precision)
+        cost->instructions_precision = precision;
+
+    // a body printing nothing prints nothing, however often it runs.
+    if (cost->lines == 0 && cost->lines_precision == ESTIMATE_EXACT)
+        return;
+    cost->lines *= trips;
+    if (precision > cost->lines_precision)
+        cost->lines_precision = precision;
+}
+
+/**
+ * @brief add a cost to another.
+ * @param total [in/out] the sum.
+ * @param cost the cost added.
+ */
+static void s_cost_add(cost_st *total, const cost_st *cost) {
+    total->instructions += cost->instructions;
+    total->lines += cost->lines;
+    if (cost->instructions_precision > total->instructions_precision)
+        total->instructions_precision = cost->instructions_precision;
+    if (cost->lines_precision > total->lines_precision)
+        total->lines_precision = cost->lines_precision;
+}
+
+/**
+ * @brief keep a note for the report.
+ * @param estimate [in/out] the analysis.
+ * @param node the node the note is about.
+ * @param format printf format of the note.
+ */
+static void s_note(estimate_st *estimate, ast_node_st *node, const char *format, ...) {
+    va_list args;
+    int length;
+
+    if (estimate->note_count < MAX_NOTES) {
+        length = snprintf(estimate->notes[estimate->note_count], NOTE_SIZE, "line %d: ",
+                          node->line);
+        va_start(args, format);
+        vsnprintf(estimate->notes[estimate->note_count] + length, NOTE_SIZE - length,
+                  format, args);
+        va_end(args);
+    }
+    estimate->note_count++;
+}
+
+/**
+ * @brief write a number of the report with its precision.
+ * @param fout output stream.
+ * @param name name of the number.
+ * @param number the number.
+ * @param precision enum estimate_precision.
+ */
+static void s_write_number(FILE *fout, const char *name, double number, int precision) {
+    if (precision >= ESTIMATE_UNKNOWN)
+        fprintf(fout, "%-16s %s\n", name, s_precision_names[precision]);
+    else
+        fprintf(fout, "%-16s %.0f %s\n", name, number, s_precision_names[precision]);
+}
+
+#ifdef ESTIMATE_TEST
+#include <time.h>
+
+/**
+ * @brief build a leaf, a number or a variable.
+ * @param ast a valid tree.
+ * @param kind AST_NUMBER or AST_VARIABLE.
+ * @param text text of the leaf.
+ * @return the leaf.
+ */
+static ast_node_st *s_leaf(ast_st *ast, int kind, const char *text) {
+    ast_node_st *node = ast_new_node(ast, kind, 1, 1);
+    node->text = text;
+    return node;
+}
+
+/**
+ * @brief build "x is 3; if (y > 0) then { x is 0; if (y > 1) then { ... }; };
+ *        for i from 0 to x step i + 1 { print i; };", one if and one
+ *        assignment per level, with x or a variable per level.
+ * @param ast a valid tree.
+ * @param levels nested ifs.
+ * @param names names of the variables, NULL for x only.
+ * @return the first statement.
+ */
+static ast_node_st *s_nest(ast_st *ast, int levels, char (*names)[16]) {
+    ast_node_st *first = ast_new_node(ast, AST_ASSIGN, 1, 1);
+    ast_node_st *last = first;
+    ast_node_st **body = &(first->next);
+    ast_node_st *node;
+    int i;
+
+    first->text = "x";
+    first->expr = s_leaf(ast, AST_NUMBER, "3");
+    for (i = 0; i < levels; i++) {
+        node = ast_new_node(ast, AST_IF, i + 2, 1);
+        node->cond = ast_new_node(ast, AST_COMPARE, i + 2, 5);
+        node->cond->symbol = SYMBOL_GREATER;
+        node->cond->left = s_leaf(ast, AST_VARIABLE, "y");
+        node->cond->right = s_leaf(ast, AST_NUMBER, "0");
+        node->then_body = ast_new_node(ast, AST_ASSIGN, i + 3, 1);
+        node->then_body->text = names == NULL ? "x" : names[i];
+        node->then_body->expr = s_leaf(ast, AST_NUMBER, "0");
+        *body = node;
+        if (i == 0)
+            last = node;
+        body = &(node->then_body->next);
+    }
+
+    node = ast_new_node(ast, AST_FOR, levels + 2, 1);
+    node->text = "i";
+    node->symbol = SYMBOL_TO;
+    node->from = s_leaf(ast, AST_NUMBER, "0");
+    node->to = s_leaf(ast, AST_VARIABLE, "x");
+    node->step = ast_new_node(ast, AST_BINARY, levels + 2, 1);
+    node->step->symbol = SYMBOL_ADD;
+    node->step->left = s_leaf(ast, AST_VARIABLE, "i");
+    node->step->right = s_leaf(ast, AST_NUMBER, "1");
+    node->body = ast_new_node(ast, AST_PRINT, levels + 3, 1);
+    node->body->expr = s_leaf(ast, AST_VARIABLE, "i");
+    last->next = node;
+    return first;
+}
+
+/**
+ * @brief estimate nested ifs, report the time.
+ * @param levels nested ifs.
+ * @param distinct 1 for a variable per level, 0 for x only.
+ * @param fout output stream of the report, NULL for the time only.
+ * @return seconds of the estimate.
+ */
+static double s_run_nest(int levels, int distinct, FILE *fout) {
+    ast_st *ast = ast_init();
+    char (*names)[16] = NULL;
+    FILE *null = fopen("/dev/null", "w");
+    clock_t start;
+    double seconds;
+    int i;
+
+    if (distinct) {
+        names = malloc(levels * sizeof(*names));
+        for (i = 0; i < levels; i++)
+            snprintf(names[i], sizeof(*names), "v%d", i);
+    }
+    ast_set_root(ast, s_nest(ast, levels, names));
+    start = clock();
+    estimate_write(ast, "nest", fout != NULL ? fout : null);
+    seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    fclose(null);
+    free(names);
+    ast_free(ast);
+    return seconds;
+}
+
+int main() {
+    int levels;
+
+    printf("no if, should be 36 exact and 3 exact:\n");
+    s_run_nest(0, 0, stdout);
+    printf("two ifs setting x, should be unknown with a note on line 4:\n");
+    s_run_nest(2, 0, stdout);
+
+    // undecided ifs nested deep, the time should double with the depth.
+    for (levels = 8000; levels <= 32000; levels *= 2) {
+        printf("%6d levels: x %7.3f ms, a variable per level %7.3f ms\n", levels,
+               s_run_nest(levels, 0, NULL) * 1000, s_run_nest(levels, 1, NULL) * 1000);
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,34 @@
+/**
+ * @file estimate.h
+ * @brief Purpose: estimate the instructions a program executes and the lines
+ *        it prints, from its syntax tree, without running it.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __ESTIMATE_H__
+#define __ESTIMATE_H__
+
+#include <stdio.h>
+
+#include "utils/ast.h"
+
+/**
+ * @brief how much an estimated number can be trusted, worst last.
+ */
+enum estimate_precision {
+    ESTIMATE_EXACT = 0,                             /**< every loop and branch is known */
+    ESTIMATE_APPROXIMATE,                           /**< affine bounds or unknown branches, averaged */
+    ESTIMATE_UNKNOWN,                               /**< a loop runs an unknown number of times */
+    ESTIMATE_UNBOUNDED,                             /**< a loop never ends */
+};
+
+/**
+ * @brief estimate a program and write the report, in linear time over the tree.
+ * @param ast the syntax tree of the program.
+ * @param program name of the program in the report.
+ * @param fout output stream of the report.
+ * @return enum estimate_precision of the instruction count, -1 on an empty tree.
+ */
+int estimate_write(ast_st *, const char *, FILE *);
+
+#endif
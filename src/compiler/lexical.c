@@ -1,6 +1,12 @@
 /**
  * @file lexical.c
  * @brief Purpose: provide the lexical analysis for the code
+ *
+ * The whole source is mapped (or read, from a pipe) and scanned with a cursor.
+ * Runs of spaces, letters and digits are scanned 32 characters at a time with
+ * AVX2 or 16 with SSE2, chosen at run time; -DLEX_SCALAR, or a cpu without
+ * SSE2, scans one character at a time. The tokens are the same either way.
+ * They go into one token array, which points into the source and keeps it.
  * @version 1.0
  * @date 04.27.2017
  * @author Katie MacArthur
@@ -11,136 +17,541 @@
 #include <memory.h>
 #include <ctype.h>
 #include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#if defined(__SSE2__) && !defined(LEX_SCALAR)
+#include <immintrin.h>
+#define LEX_SIMD
+#endif
 
 #include "./utils/error.h" 
 #include "./utils/symbol_table.h"
-#include "./utils/link_list.h"
-#include "./utils/link_node.h"
+#include "./utils/token_array.h"
 
 #include "lexical.h"
 
-#define DEFAULT_TOKEN_BUFF_SIZE     (256)
+#define DEFAULT_SOURCE_SIZE         (65536)
 #define ENLARGE_FACTOR              (2)
 
-static void emit_token(link_list_st *token_list, char *token_buff) {
-    link_node_st* new_node = link_node_new(strdup(token_buff),free);
-    link_list_append(token_list, new_node);
+typedef struct source {
+    const char *begin;                      /**< first character of the source */
+    const char *end;                        /**< one past the last character */
+    const char *cursor;                     /**< next character to read */
+    int line_no;                            /**< line of the cursor */
+    size_t mapped;                          /**< bytes mapped, 0 if read into the heap */
+    token_array_st *tokens;                 /**< the tokens, and the start of each line */
+} source_st;
+
+/**
+ * @brief skip spaces, tabs and line breaks, keeping track of the line.
+ * @param source [in/out] the source, the cursor moves to the next character that is not a space.
+ */
+typedef void (*skip_space_fn)(source_st *);
+
+/**
+ * @brief find the end of a run of characters of one class.
+ * @param cursor first character of the run.
+ * @param end end of the source.
+ * @return one past the last character of the run.
+ */
+typedef const char *(*scan_fn)(const char *, const char *);
+
+static skip_space_fn skip_space;            /**< the widest skip_space of the cpu */
+static scan_fn scan_alpha;                  /**< the widest scan_alpha of the cpu */
+static scan_fn scan_digit;                  /**< the widest scan_digit of the cpu */
+
+/**
+* @brief check a character is a space, tab or line break.
+* @param char_in the character.
+* @return 1 if it is; otherwise 0.
+*/
+static inline int is_space(unsigned char char_in) {
+    return char_in == ' ' || char_in == '\t' || char_in == '\r' || char_in == '\n';
+}
+
+/**
+* @brief check a character is a letter, as isalpha() in the "C" locale.
+* @param char_in the character.
+* @return 1 if it is; otherwise 0.
+*/
+static inline int is_alpha(unsigned char char_in) {
+    return (unsigned char)((char_in | 0x20) - 'a') < 26;
+}
+
+/**
+* @brief check a character is a decimal digit.
+* @param char_in the character.
+* @return 1 if it is; otherwise 0.
+*/
+static inline int is_digit(unsigned char char_in) {
+    return (unsigned char)(char_in - '0') < 10;
+}
+
+/**
+* @brief skip spaces one character at a time, keeping track of the line.
+* @param source [in/out] the source.
+*/
+static void skip_space_scalar(source_st *source) {
+    const char *cursor = source->cursor;
+
+    while (cursor < source->end && is_space(*cursor)) {
+        if (*cursor == '\n') {
+            source->line_no++;
+            token_array_add_line(source->tokens, cursor + 1 - source->begin);
+        }
+        cursor++;
+    }
+    source->cursor = cursor;
+}
+
+/**
+* @brief find the end of a run of letters, one character at a time.
+* @param cursor first character of the run.
+* @param end end of the source.
+* @return one past the last letter.
+*/
+static const char *scan_alpha_scalar(const char *cursor, const char *end) {
+    while (cursor < end && is_alpha(*cursor))
+        cursor++;
+    return cursor;
+}
+
+/**
+* @brief find the end of a run of digits, one character at a time.
+* @param cursor first character of the run.
+* @param end end of the source.
+* @return one past the last digit.
+*/
+static const char *scan_digit_scalar(const char *cursor, const char *end) {
+    while (cursor < end && is_digit(*cursor))
+        cursor++;
+    return cursor;
+}
+
+#ifdef LEX_SIMD
+/**
+* @brief account the line breaks of a skipped block.
+* @param source [in/out] the source.
+* @param block first character of the block.
+* @param newlines bit i set if block[i] is a line break.
+*/
+static inline void count_newlines(source_st *source, const char *block, unsigned int newlines) {
+    while (newlines != 0) {
+        source->line_no++;
+        token_array_add_line(source->tokens, block + __builtin_ctz(newlines) + 1 - source->begin);
+        newlines &= newlines - 1;
+    }
+}
+
+/**
+* @brief skip spaces 16 characters at a time, keeping track of the line.
+* @param source [in/out] the source.
+*/
+static void skip_space_sse2(source_st *source) {
+    const char *cursor = source->cursor;
+    unsigned int spaces, newlines, length;
+    __m128i block, newline;
+
+    while (source->end - cursor >= 16) {
+        block = _mm_loadu_si128((const __m128i *)cursor);
+        newline = _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'));
+        spaces = _mm_movemask_epi8(_mm_or_si128(
+                     _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                                  _mm_cmpeq_epi8(block, _mm_set1_epi8('\t'))),
+                     _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\r')), newline)));
+        newlines = _mm_movemask_epi8(newline);
+        if (spaces != 0xFFFF) {
+            length = __builtin_ctz(~spaces);
+            count_newlines(source, cursor, newlines & ((1u << length) - 1));
+            source->cursor = cursor + length;
+            return;
+        }
+        count_newlines(source, cursor, newlines);
+        cursor += 16;
+    }
+    source->cursor = cursor;
+    skip_space_scalar(source);
+}
+
+/**
+* @brief find the end of a run of letters, 16 characters at a time.
+* @param cursor first character of the run.
+* @param end end of the source.
+* @return one past the last letter.
+*/
+static const char *scan_alpha_sse2(const char *cursor, const char *end) {
+    unsigned int letters;
+    __m128i offset;
+
+    while (end - cursor >= 16) {
+        // (c | 0x20) - 'a' <= 25, unsigned.
+        offset = _mm_sub_epi8(_mm_or_si128(_mm_loadu_si128((const __m128i *)cursor),
+                                           _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        letters = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(25)),
+                                                   offset));
+        if (letters != 0xFFFF)
+            return cursor + __builtin_ctz(~letters);
+        cursor += 16;
+    }
+    return scan_alpha_scalar(cursor, end);
+}
+
+/**
+* @brief find the end of a run of digits, 16 characters at a time.
+* @param cursor first character of the run.
+* @param end end of the source.
+* @return one past the last digit.
+*/
+static const char *scan_digit_sse2(const char *cursor, const char *end) {
+    unsigned int digits;
+    __m128i offset;
+
+    while (end - cursor >= 16) {
+        // c - '0' <= 9, unsigned.
+        offset = _mm_sub_epi8(_mm_loadu_si128((const __m128i *)cursor), _mm_set1_epi8('0'));
+        digits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(9)),
+                                                  offset));
+        if (digits != 0xFFFF)
+            return cursor + __builtin_ctz(~digits);
+        cursor += 16;
+    }
+    return scan_digit_scalar(cursor, end);
+}
+
+/**
+* @brief skip spaces 32 characters at a time, keeping track of the line.
+* @param source [in/out] the source.
+*/
+__attribute__((target("avx2")))
+static void skip_space_avx2(source_st *source) {
+    const char *cursor = source->cursor;
+    unsigned int spaces, newlines, length;
+    __m256i block, newline;
+
+    while (source->end - cursor >= 32) {
+        block = _mm256_loadu_si256((const __m256i *)cursor);
+        newline = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'));
+        spaces = _mm256_movemask_epi8(_mm256_or_si256(
+                     _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+                                     _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t'))),
+                     _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r')), newline)));
+        newlines = _mm256_movemask_epi8(newline);
+        if (spaces != 0xFFFFFFFF) {
+            length = __builtin_ctz(~spaces);
+            count_newlines(source, cursor, length ? newlines & (0xFFFFFFFFu >> (32 - length)) : 0);
+            source->cursor = cursor + length;
+            return;
+        }
+        count_newlines(source, cursor, newlines);
+        cursor += 32;
+    }
+    source->cursor = cursor;
+    skip_space_sse2(source);
+}
+
+/**
+* @brief find the end of a run of letters, 32 characters at a time.
+* @param cursor first character of the run.
+* @param end end of the source.
+* @return one past the last letter.
+*/
+__attribute__((target("avx2")))
+static const char *scan_alpha_avx2(const char *cursor, const char *end) {
+    unsigned int letters;
+    __m256i offset;
+
+    while (end - cursor >= 32) {
+        offset = _mm256_sub_epi8(_mm256_or_si256(_mm256_loadu_si256((const __m256i *)cursor),
+                                                 _mm256_set1_epi8(0x20)),
+                                 _mm256_set1_epi8('a'));
+        letters = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                      _mm256_min_epu8(offset, _mm256_set1_epi8(25)), offset));
+        if (letters != 0xFFFFFFFF)
+            return cursor + __builtin_ctz(~letters);
+        cursor += 32;
+    }
+    return scan_alpha_sse2(cursor, end);
+}
+
+/**
+* @brief find the end of a run of digits, 32 characters at a time.
+* @param cursor first character of the run.
+* @param end end of the source.
+* @return one past the last digit.
+*/
+__attribute__((target("avx2")))
+static const char *scan_digit_avx2(const char *cursor, const char *end) {
+    unsigned int digits;
+    __m256i offset;
+
+    while (end - cursor >= 32) {
+        offset = _mm256_sub_epi8(_mm256_loadu_si256((const __m256i *)cursor),
+                                 _mm256_set1_epi8('0'));
+        digits = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                     _mm256_min_epu8(offset, _mm256_set1_epi8(9)), offset));
+        if (digits != 0xFFFFFFFF)
+            return cursor + __builtin_ctz(~digits);
+        cursor += 32;
+    }
+    return scan_digit_sse2(cursor, end);
+}
+#endif
+
+/**
+* @brief pick the widest scanners the cpu runs.
+*/
+static void select_scanners() {
+    skip_space = skip_space_scalar;
+    scan_alpha = scan_alpha_scalar;
+    scan_digit = scan_digit_scalar;
+#ifdef LEX_SIMD
+    // SSE2 is part of x86-64, AVX2 is checked at run time.
+    skip_space = skip_space_sse2;
+    scan_alpha = scan_alpha_sse2;
+    scan_digit = scan_digit_sse2;
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        skip_space = skip_space_avx2;
+        scan_alpha = scan_alpha_avx2;
+        scan_digit = scan_digit_avx2;
+    }
+#endif
+}
+
+/**
+* @brief get the whole source from stdin, mapped if it is a file, read otherwise.
+* @param source [out] the source, cursor at the first character.
+* @return 0 on success; otherwise errno.
+*/
+static int source_load(source_st *source) {
+    struct stat file_stat;
+    char *buffer = NULL;
+    size_t capacity = 0;
+    size_t length = 0;
+    ssize_t rc;
+    int fd = fileno(stdin);
+
+    memset(source, 0, sizeof(source_st));
+    source->line_no = 1;
+
+    if (fstat(fd, &file_stat) == 0 && S_ISREG(file_stat.st_mode) && file_stat.st_size > 0) {
+        buffer = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (buffer != MAP_FAILED) {
+            madvise(buffer, file_stat.st_size, MADV_SEQUENTIAL);
+            source->mapped = file_stat.st_size;
+            source->begin = buffer;
+            source->end = buffer + file_stat.st_size;
+            source->cursor = source->begin;
+            return 0;
+        }
+        buffer = NULL;
+    }
+
+    // a pipe or a terminal.
+    for (;;) {
+        if (length == capacity) {
+            capacity = capacity ? capacity * ENLARGE_FACTOR : DEFAULT_SOURCE_SIZE;
+            buffer = (char *)realloc(buffer, capacity);
+            if (buffer == NULL)
+                return ENOMEM;
+        }
+        rc = read(fd, buffer + length, capacity - length);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc < 0) {
+            free(buffer);
+            return errno;
+        }
+        if (rc == 0)
+            break;
+        length += rc;
+    }
+    source->begin = buffer;
+    source->end = buffer + length;
+    source->cursor = source->begin;
+    return 0;
+}
+
+/**
+* @brief release a mapped source, with the tokens.
+* @param text the source.
+* @param size bytes mapped.
+*/
+static void source_unmap(const char *text, size_t size) {
+    munmap((void *)text, size);
+}
+
+/**
+* @brief release a source read into the heap, with the tokens.
+* @param text the source.
+* @param size bytes read.
+*/
+static void source_free(const char *text, size_t size) {
+    free((void *)text);
+}
+
+/**
+* @brief get the value of a number, wrapping around as the 32 bits of the machine.
+* @param text first character, '-' or a digit.
+* @param end one past the last digit.
+* @return the value.
+*/
+static int number_value(const char *text, const char *end) {
+    uint32_t value = 0;
+    int negative = (*text == '-');
+
+    for (text += negative; text < end; text++)
+        value = value * 10 + (*text - '0');
+    return (int32_t)(negative ? 0u - value : value);
 }
 
 static void emit_error() {
 
 }
 /**
-* @brief takes in symbol table and returns a linked list structure
+* @brief takes in symbol table and returns the array of tokens
 * @param symbol_table
-* @return link_list_st
+* @return token_array_st, it keeps the source the tokens point into
 */
-link_list_st *lexical_analysis(symbol_table_st *symbol_table) {
+token_array_st *lexical_analysis(symbol_table_st *symbol_table) {
 
     if (symbol_table == NULL) 
         return NULL;
 
-    char *token_buff = (char *)malloc(DEFAULT_TOKEN_BUFF_SIZE);
-    int token_buff_size = DEFAULT_TOKEN_BUFF_SIZE;
-    int token_length = 0;
+    const char *token_begin;
+    const char *run_end;
+    source_st source;
     int char_in;
+    int value;
+    int type;
+    int id;
+    int rc;
 
-    link_list_st* link_list = link_list_init();
+    rc = source_load(&source);
+    if (rc != 0)
+        error_errno(rc);
+    if (skip_space == NULL)
+        select_scanners();
 
-    while ((char_in = getchar()) != EOF) {
-        if (char_in == ' ' || char_in == '\t' || 
-            char_in == '\r' || char_in == '\n')
-            continue;
+    source.tokens = token_array_init(source.begin, source.end - source.begin,
+                                     source.mapped != 0 ? source_unmap : source_free);
 
-        if (char_in == '(' || char_in == ')' || 
-            char_in == '{' || char_in == '}' ||
-            char_in == ';') {
-            // Special symbols.
-            token_buff[token_length++] = char_in;
-            token_buff[token_length++] = '\0';
-
-            emit_token(link_list, token_buff);
-            token_length = 0;
-        } else if (isalpha(char_in)) {
-            // Starting from alpha, possible: KEYWORD or IDENTIFIER.
-            while (isalpha(char_in)) {
-                token_buff[token_length++] = char_in;
-                char_in = getchar();
-                if (token_length >= token_buff_size) {
-                    token_buff = realloc(token_buff,
-                                        sizeof(char) * token_buff_size * ENLARGE_FACTOR);
-                    if (token_buff == NULL)
-                        exit(ENOMEM);
-                    token_buff_size *= ENLARGE_FACTOR;
-                }
-            }
-            if (!isalpha(char_in))
-                ungetc(char_in, stdin);
-            token_buff[token_length++] = '\0';
-            if (symbol_table_lookup(symbol_table, token_buff) == NONE) {
-                symbol_table_insert(symbol_table, token_buff, IDENTIFIER);
-            }
-            emit_token(link_list, token_buff);
-            token_length = 0;
-        } else if (char_in == '=' || char_in == '<' || char_in == '>') {
-            token_buff[token_length++] = char_in;
-            char_in = getchar();
-            if (char_in == '=' || char_in == '<' || char_in == '>') {
-                token_buff[token_length++] = char_in;
-            } else {
-                ungetc(char_in, stdin);
+    while (source.cursor < source.end) {
+        if (is_space(*source.cursor)) {
+            skip_space(&source);
+            if (source.cursor == source.end)
+                break;
+        }
+        token_begin = source.cursor;
+        run_end = token_begin + 1;
+        char_in = (unsigned char)*token_begin;
+        id = SYMBOL_UNKNOWN;
+
+        switch (char_in) {
+        // Special symbols.
+        case '(':
+            type = OPEN_PARENTHESES;
+            id = SYMBOL_OPEN_PARENTHESIS;
+            break;
+        case ')':
+            type = CLOSE_PARENTHESES;
+            id = SYMBOL_CLOSE_PARENTHESIS;
+            break;
+        case '{':
+            type = OPEN_CURLY_BRACKETS;
+            id = SYMBOL_OPEN_CURLY_BRACKET;
+            break;
+        case '}':
+            type = CLOSE_CURLY_BRACKETS;
+            id = SYMBOL_CLOSE_CURLY_BRACKET;
+            break;
+        case ';':
+            type = DELIMITER;
+            id = SYMBOL_DELIMITER;
+            break;
+        case '+':
+            type = BIN_OP;
+            id = SYMBOL_ADD;
+            break;
+        case '%':
+            type = BIN_OP;
+            id = SYMBOL_MOD;
+            break;
+        case '*':
+            type = BIN_OP;
+            id = SYMBOL_MUL;
+            break;
+        case '/':
+            type = BIN_OP;
+            id = SYMBOL_DIV;
+            break;
+        case '-':
+            type = BIN_OP;
+            id = SYMBOL_SUB;
+            // a negative number goes on with its digits.
+            if (run_end < source.end && is_digit(*run_end)) {
+                run_end = scan_digit(run_end + 1, source.end);
+                type = NUMBER;
             }
-            token_buff[token_length++] = '\0';
-            if (symbol_table_lookup(symbol_table, token_buff) == NONE) {
+            break;
+        case '=':
+        case '<':
+        case '>':
+            if (run_end < source.end &&
+                (*run_end == '=' || *run_end == '<' || *run_end == '>'))
+                run_end++;
+            type = symbol_table_lookup_text(symbol_table, token_begin, run_end - token_begin,
+                                            &id);
+            if (type == NONE) {
                 emit_error();
             }
-            emit_token(link_list, token_buff);
-            token_length = 0;
-        } else if (char_in == '+' || char_in == '%' || 
-                   char_in == '*' || char_in == '/' ) {
-            token_buff[token_length++] = char_in;
-            token_buff[token_length++] = '\0';
-            emit_token(link_list, token_buff);
-            token_length = 0;
-        } else if (char_in == '-') {
-            int look_ahead = getchar();
-            token_buff[token_length++] = char_in;
-            if (!isdigit(look_ahead)) {
-                token_buff[token_length++] = '\0';
-                emit_token(link_list, token_buff);
-                token_length = 0;
-            }
-            ungetc(look_ahead, stdin);
-        } else if (isdigit(char_in)) {
-            while (isdigit(char_in)) {
-                token_buff[token_length++] = char_in;
-                char_in = getchar();
-                if (token_length >= token_buff_size) {
-                    token_buff = realloc(token_buff,
-                                         sizeof(char) * token_buff_size * ENLARGE_FACTOR);
-                    if (token_buff == NULL)
-                        exit(ENOMEM);
-                    token_buff_size *= ENLARGE_FACTOR;
+            break;
+        default:
+            if (is_alpha(char_in)) {
+                // Starting from alpha, possible: KEYWORD or IDENTIFIER.
+                run_end = scan_alpha(run_end, source.end);
+                type = symbol_table_lookup_text(symbol_table, token_begin, run_end - token_begin,
+                                                &id);
+                if (type == NONE) {
+                    id = symbol_table_insert_text(symbol_table, token_begin,
+                                                  run_end - token_begin, IDENTIFIER);
+                    type = IDENTIFIER;
                 }
+            } else if (is_digit(char_in)) {
+                run_end = scan_digit(run_end, source.end);
+                type = NUMBER;
+            } else {
+                source.cursor++;
+                continue;
             }
-            if (!isdigit(char_in))
-                ungetc(char_in, stdin);
-            token_buff[token_length++] = '\0';
-            emit_token(link_list, token_buff);
-            symbol_table_insert(symbol_table, token_buff, NUMBER);
-            token_length = 0;
+            break;
         }
-    }
-    free(token_buff);
 
-    return link_list;
+        // a number carries its value in place of the id.
+        value = id;
+        if (type == NUMBER)
+            value = number_value(token_begin, run_end);
+        token_array_append(source.tokens, type, token_begin - source.begin,
+                           run_end - token_begin, source.line_no, value);
+        source.cursor = run_end;
+    }
+    return source.tokens;
 }
 
 #ifdef XTEST
 
-int print_list(link_node_st *node, void *cb_data) {
-    printf("%s\n", (char *)link_node_get_data(node));
-    return LINK_LIST_CONTINUE;
+void print_tokens(token_array_st *tokens) {
+    const token_st *token;
+    char *text;
+    int i;
+
+    for (i = 0; (token = token_array_get(tokens, i)) != NULL; i++) {
+        text = token_array_dup_text(tokens, token);
+        printf("%s\n", text);
+        free(text);
+    }
 }
 
 void test_case_one(char *file_name) {
@@ -152,10 +563,10 @@ void test_case_two(char *file_name) {
     symbol_table_st *symbol_table;
     freopen(file_name, "r", stdin);
     symbol_table = symbol_table_init();
-    link_list_st *token_list = lexical_analysis(symbol_table);
-    link_list_traverse(token_list, print_list, NULL);
+    token_array_st *tokens = lexical_analysis(symbol_table);
+    print_tokens(tokens);
     symbol_table_fini(symbol_table);
-    link_list_free(token_list);
+    token_array_free(tokens);
 }
 
 
@@ -12,14 +12,14 @@
 #include <stdio.h>
 
 #include "utils/symbol_table.h"
-#include "utils/link_list.h"
+#include "utils/token_array.h"
 
 /**
- *@brief takes in symbol table and returns a linked list structure
+ *@brief takes in symbol table and returns the array of tokens
  * @param symbol_table
- * @return A linked list, NULL is symbol table is NULL
+ * @return A token array, NULL is symbol table is NULL
  */
-link_list_st *lexical_analysis(symbol_table_st *symbol_table);
+token_array_st *lexical_analysis(symbol_table_st *symbol_table);
 
 
 #endif
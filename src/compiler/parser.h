@@ -1,6 +1,6 @@
 /**
  * @file parser.h
- * @brief Purpose: generate a parsing tree using token list and symbol table 
+ * @brief Purpose: generate a syntax tree using token array and symbol table 
  * @version 1.0
  * @date 04.18.2017
  * @author Ximing
@@ -10,19 +10,19 @@
 #define __PARSER_H__
 
 
-#include "utils/parsing_tree.h"
+#include "utils/ast.h"
 #include "utils/symbol_table.h"
-#include "utils/link_list.h"
+#include "utils/token_array.h"
 
 
 
 
 /**
- * @brief: get the token_list and symbol_table parse it into a parsing tree 
- * @param: pointer to token list 
+ * @brief: get the token array and symbol_table parse it into a syntax tree 
+ * @param: pointer to token array 
  * @param: pointer to symbol table
- * @return: the pointer to generated parsing tree
+ * @return: the pointer to generated syntax tree, the names point into the symbol table
  */
-parsing_tree_st *syntax_analysis (link_list_st *token_list, symbol_table_st *symbol_table);
+ast_st *syntax_analysis (token_array_st *tokens, symbol_table_st *symbol_table);
 
 #endif
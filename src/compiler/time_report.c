@@ -0,0 +1,216 @@
+/**
+ * @file time_report.c
+ * @brief Purpose: time, heap allocations and peak memory of the compiler phases.
+ *
+ * Heap allocations are counted by wrapping the allocator at link time
+ * (-Wl,--wrap=malloc and friends, see the Makefile), so only the calls made
+ * by the compiler itself are counted, not those inside the C library. The
+ * wrappers cost one increment per call, whether the report is asked for or not.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "time_report.h"
+
+#define TIME_REPORT_MAX_PHASES  (8)                 /**< phases kept in a report */
+
+typedef struct phase_time {
+    const char *name;                               /**< name of the phase */
+    double wall_ms;                                 /**< elapsed time */
+    double cpu_ms;                                  /**< cpu time of the process */
+    uint64_t allocations;                           /**< heap allocations made */
+    long max_rss_kb;                                /**< peak resident set size at the end */
+} phase_time_st;
+
+struct time_report {
+    phase_time_st phases[TIME_REPORT_MAX_PHASES];   /**< phases ended, in order */
+    int phase_count;                                /**< phases ended */
+    const char *running;                            /**< the running phase, NULL for none */
+    struct timespec wall_start;                     /**< start of the running phase */
+    struct timespec cpu_start;                      /**< cpu time at the start */
+    uint64_t allocations_start;                     /**< allocations at the start */
+    uint64_t counts[TIME_REPORT_COUNT];             /**< sizes of the compilation */
+};
+
+static uint64_t s_allocations;                      /**< heap allocations so far */
+
+static const char *s_count_names[TIME_REPORT_COUNT] = {
+    [TIME_REPORT_TOKENS]        = "tokens",
+    [TIME_REPORT_NODES]         = "parse tree nodes",
+    [TIME_REPORT_INSTRUCTIONS]  = "instructions",
+    [TIME_REPORT_TEMPORARIES]   = "temporaries",
+    [TIME_REPORT_LABELS]        = "labels",
+};
+
+void *__real_malloc(size_t);
+void *__real_calloc(size_t, size_t);
+void *__real_realloc(void *, size_t);
+char *__real_strdup(const char *);
+
+/**
+ * @brief get the milliseconds since a point in time.
+ * @param clock the clock of the point.
+ * @param start the point in time.
+ * @return milliseconds elapsed.
+ */
+static double s_ms_since(clockid_t, const struct timespec *);
+
+/**
+ * @brief initialize an empty report.
+ * @return a valid report object.
+ */
+time_report_st *time_report_init() {
+    time_report_st *report;
+
+    report = (time_report_st *)calloc(1, sizeof(time_report_st));
+    if (report == NULL)
+        exit(ENOMEM);
+    return report;
+}
+
+/**
+ * @brief clean up the report object.
+ * @param report a valid report object.
+ */
+void time_report_fini(time_report_st *report) {
+    free(report);
+}
+
+/**
+ * @brief a phase starts.
+ * @param report a valid report object.
+ * @param name name of the phase, kept by reference.
+ */
+void time_report_begin(time_report_st *report, const char *name) {
+    if (report == NULL)
+        return;
+
+    report->running = name;
+    report->allocations_start = s_allocations;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &report->cpu_start);
+    clock_gettime(CLOCK_MONOTONIC, &report->wall_start);
+}
+
+/**
+ * @brief the running phase ends.
+ * @param report a valid report object.
+ */
+void time_report_end(time_report_st *report) {
+    phase_time_st *phase;
+    struct rusage usage;
+
+    if (report == NULL || report->running == NULL ||
+        report->phase_count >= TIME_REPORT_MAX_PHASES)
+        return;
+
+    phase = &(report->phases[report->phase_count++]);
+    phase->name = report->running;
+    phase->wall_ms = s_ms_since(CLOCK_MONOTONIC, &report->wall_start);
+    phase->cpu_ms = s_ms_since(CLOCK_PROCESS_CPUTIME_ID, &report->cpu_start);
+    phase->allocations = s_allocations - report->allocations_start;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        phase->max_rss_kb = usage.ru_maxrss;
+
+    report->running = NULL;
+}
+
+/**
+ * @brief set a size of the compilation.
+ * @param report a valid report object.
+ * @param which enum time_report_count.
+ * @param value the size.
+ */
+void time_report_set_count(time_report_st *report, int which, uint64_t value) {
+    if (report == NULL || which < 0 || which >= TIME_REPORT_COUNT)
+        return;
+    report->counts[which] = value;
+}
+
+/**
+ * @brief write the report, one line per phase then the sizes.
+ * @param report a valid report object.
+ * @param fout output stream.
+ */
+void time_report_write(time_report_st *report, FILE *fout) {
+    phase_time_st total;
+    phase_time_st *phase;
+    int i;
+
+    if (report == NULL || fout == NULL)
+        return;
+
+    memset(&total, 0, sizeof(total));
+    total.name = "total";
+
+    fprintf(fout, "%-10s %12s %12s %12s %14s\n",
+                  "phase", "wall ms", "cpu ms", "allocations", "peak rss KB");
+    for (i = 0; i <= report->phase_count; i++) {
+        if (i < report->phase_count) {
+            phase = &(report->phases[i]);
+            total.wall_ms += phase->wall_ms;
+            total.cpu_ms += phase->cpu_ms;
+            total.allocations += phase->allocations;
+            total.max_rss_kb = phase->max_rss_kb;
+        } else {
+            phase = &total;
+        }
+        fprintf(fout, "%-10s %12.3f %12.3f %12" PRIu64 " %14ld\n", phase->name,
+                      phase->wall_ms, phase->cpu_ms, phase->allocations, phase->max_rss_kb);
+    }
+
+    for (i = 0; i < TIME_REPORT_COUNT; i++)
+        fprintf(fout, "%-17s %" PRIu64 "\n", s_count_names[i], report->counts[i]);
+}
+
+/**
+ * @brief get the milliseconds since a point in time.
+ * @param clock the clock of the point.
+ * @param start the point in time.
+ * @return milliseconds elapsed.
+ */
+static double s_ms_since(clockid_t clock, const struct timespec *start) {
+    struct timespec now;
+
+    clock_gettime(clock, &now);
+    return (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**
+ * @brief count and forward malloc of the compiler.
+ */
+void *__wrap_malloc(size_t size) {
+    s_allocations++;
+    return __real_malloc(size);
+}
+
+/**
+ * @brief count and forward calloc of the compiler.
+ */
+void *__wrap_calloc(size_t count, size_t size) {
+    s_allocations++;
+    return __real_calloc(count, size);
+}
+
+/**
+ * @brief count and forward realloc of the compiler.
+ */
+void *__wrap_realloc(void *ptr, size_t size) {
+    s_allocations++;
+    return __real_realloc(ptr, size);
+}
+
+/**
+ * @brief count and forward strdup of the compiler.
+ */
+char *__wrap_strdup(const char *str) {
+    s_allocations++;
+    return __real_strdup(str);
+}
@@ -0,0 +1,68 @@
+/**
+ * @file time_report.h
+ * @brief Purpose: time, heap allocations and peak memory of the compiler phases.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __TIME_REPORT_H__
+#define __TIME_REPORT_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+/**
+ * @brief sizes of the compilation, reported under the phases.
+ */
+enum time_report_count {
+    TIME_REPORT_TOKENS = 0,                         /**< tokens from the lexer */
+    TIME_REPORT_NODES,                              /**< nodes of the syntax tree */
+    TIME_REPORT_INSTRUCTIONS,                       /**< lines of byte code, labels included */
+    TIME_REPORT_TEMPORARIES,                        /**< "_tempN" declared */
+    TIME_REPORT_LABELS,                             /**< labels */
+    TIME_REPORT_COUNT
+};
+
+typedef struct time_report time_report_st;
+struct time_report;
+
+/**
+ * @brief initialize an empty report.
+ * @return a valid report object.
+ */
+time_report_st *time_report_init();
+
+/**
+ * @brief clean up the report object.
+ * @param report a valid report object.
+ */
+void time_report_fini(time_report_st *);
+
+/**
+ * @brief a phase starts.
+ * @param report a valid report object.
+ * @param name name of the phase, kept by reference.
+ */
+void time_report_begin(time_report_st *, const char *);
+
+/**
+ * @brief the running phase ends.
+ * @param report a valid report object.
+ */
+void time_report_end(time_report_st *);
+
+/**
+ * @brief set a size of the compilation.
+ * @param report a valid report object.
+ * @param which enum time_report_count.
+ * @param value the size.
+ */
+void time_report_set_count(time_report_st *, int, uint64_t);
+
+/**
+ * @brief write the report, one line per phase then the sizes.
+ * @param report a valid report object.
+ * @param fout output stream.
+ */
+void time_report_write(time_report_st *, FILE *);
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ * @file ast.c
+ * @brief Purpose: implementation of the abstract syntax tree and its arena
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "error.h"
+#include "ast.h"
+
+#define DEFAULT_BLOCK_SIZE      (64 * 1024)     /**< bytes of a block, unless a text is larger */
+#define ARENA_ALIGN             (sizeof(void *))
+
+typedef struct ast_block ast_block_st;
+
+struct ast_block
+{
+    ast_block_st *next;             /**< the block filled before this one */
+    size_t size;                    /**< bytes of data */
+    size_t used;                    /**< bytes handed out */
+    char data[];                    /**< the nodes and the texts */
+};
+
+struct ast
+{
+    ast_block_st *block;            /**< the block being filled, the others follow */
+    ast_node_st *root;              /**< first statement of the program */
+    int node_count;                 /**< nodes created */
+    size_t size;                    /**< bytes of all the blocks */
+};
+
+/**
+ * @brief cut memory from the current block, starting a new block when it is full.
+ * @param ast, a valid tree.
+ * @param size, bytes wanted.
+ * @return the memory, aligned for a pointer.
+ */
+static void *arena_alloc(ast_st *ast, size_t size) {
+    ast_block_st *block = ast->block;
+    size_t block_size;
+    void *memory;
+
+    size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+    if (block == NULL || block->size - block->used < size) {
+        block_size = size > DEFAULT_BLOCK_SIZE ? size : DEFAULT_BLOCK_SIZE;
+        block = (ast_block_st *)malloc(sizeof(ast_block_st) + block_size);
+        if (block == NULL)
+            error_errno(ENOMEM);
+        block->next = ast->block;
+        block->size = block_size;
+        block->used = 0;
+        ast->block = block;
+        ast->size += block_size;
+    }
+    memory = block->data + block->used;
+    block->used += size;
+    return memory;
+}
+
+/**
+ * @brief initialize an empty tree.
+ * @return a valid tree.
+ */
+ast_st *ast_init() {
+    ast_st *ast = (ast_st *)malloc(sizeof(ast_st));
+    if (ast == NULL)
+        error_errno(ENOMEM);
+
+    ast->block = NULL;
+    ast->root = NULL;
+    ast->node_count = 0;
+    ast->size = 0;
+    return ast;
+}
+
+/**
+ * @brief free the tree, all its nodes and texts at once.
+ * @param ast, a valid tree.
+ */
+void ast_free(ast_st *ast) {
+    ast_block_st *block;
+    ast_block_st *next;
+
+    if (ast == NULL)
+        return;
+    for (block = ast->block; block != NULL; block = next) {
+        next = block->next;
+        free(block);
+    }
+    free(ast);
+}
+
+/**
+ * @brief create a node, its fields cleared.
+ * @param ast, a valid tree.
+ * @param kind, enum ast_kind.
+ * @param line, source line of the first token.
+ * @param column, source column of the first token.
+ * @return a valid node, owned by the tree.
+ */
+ast_node_st *ast_new_node(ast_st *ast, int kind, int line, int column) {
+    ast_node_st *node = (ast_node_st *)arena_alloc(ast, sizeof(ast_node_st));
+
+    memset(node, 0, sizeof(ast_node_st));
+    node->kind = kind;
+    node->line = line;
+    node->column = column;
+    ast->node_count++;
+    return node;
+}
+
+/**
+ * @brief copy a text into the tree.
+ * @param ast, a valid tree.
+ * @param text, first character of the text.
+ * @param length, characters of the text.
+ * @return a '\0' terminated copy, owned by the tree.
+ */
+const char *ast_dup_text(ast_st *ast, const char *text, size_t length) {
+    char *copy = (char *)arena_alloc(ast, length + 1);
+
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+/**
+ * @brief set the first statement of the program.
+ * @param ast, a valid tree.
+ * @param root, the first statement.
+ */
+void ast_set_root(ast_st *ast, ast_node_st *root) {
+    if (ast == NULL)
+        return;
+    ast->root = root;
+}
+
+/**
+ * @brief get the first statement of the program.
+ * @param ast, a valid tree.
+ * @return NULL on empty; otherwise the first statement.
+ */
+ast_node_st *ast_get_root(ast_st *ast) {
+    if (ast == NULL)
+        return NULL;
+    return ast->root;
+}
+
+/**
+ * @brief get the number of nodes.
+ * @param ast, a valid tree.
+ * @return the number of nodes created.
+ */
+int ast_get_node_count(ast_st *ast) {
+    if (ast == NULL)
+        return 0;
+    return ast->node_count;
+}
+
+/**
+ * @brief get the memory taken by the blocks.
+ * @param ast, a valid tree.
+ * @return bytes allocated.
+ */
+size_t ast_get_size(ast_st *ast) {
+    if (ast == NULL)
+        return 0;
+    return ast->size;
+}
+
+#ifdef AST_TEST
+int main() {
+    ast_st *ast = ast_init();
+    ast_node_st *print;
+    ast_node_st *node;
+    char *long_text;
+    int i;
+
+    // print x + 12;
+    print = ast_new_node(ast, AST_PRINT, 1, 1);
+    print->expr = ast_new_node(ast, AST_BINARY, 1, 7);
+    print->expr->left = ast_new_node(ast, AST_VARIABLE, 1, 7);
+    print->expr->left->text = ast_dup_text(ast, "x + 12", 1);
+    print->expr->right = ast_new_node(ast, AST_NUMBER, 1, 11);
+    print->expr->right->text = ast_dup_text(ast, "12;", 2);
+    ast_set_root(ast, print);
+
+    node = ast_get_root(ast)->expr;
+    printf("print %s, %s at line %d column %d\n", node->left->text, node->right->text,
+           node->right->line, node->right->column);
+
+    // a list longer than a block, and a text larger than a block.
+    for (i = 0; i < 10000; i++) {
+        node = ast_new_node(ast, AST_DECL, i + 2, 1);
+        node->next = print->next;
+        print->next = node;
+    }
+    long_text = (char *)malloc(2 * DEFAULT_BLOCK_SIZE);
+    memset(long_text, '7', 2 * DEFAULT_BLOCK_SIZE);
+    printf("long text length (should be %d): %zu\n", 2 * DEFAULT_BLOCK_SIZE,
+           strlen(ast_dup_text(ast, long_text, 2 * DEFAULT_BLOCK_SIZE)));
+    free(long_text);
+
+    printf("nodes (should be 10004): %d, size of a node %zu, bytes %zu\n",
+           ast_get_node_count(ast), sizeof(ast_node_st), ast_get_size(ast));
+    ast_free(ast);
+    return 0;
+}
+#endif
@@ -0,0 +1,124 @@
+/**
+ * @file ast.h
+ * @brief Purpose: the abstract syntax tree of a program.
+ *
+ * A node has a kind and the fields of that kind, such as the condition and
+ * the bodies of an if, or the bounds of a for. The concrete syntax, the
+ * keywords, parentheses, braces and delimiters, is not kept. The statements
+ * of a list are chained by next. The nodes and the text of the numbers are
+ * cut from a few large blocks, which are freed at once with the tree.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __AST_H__
+#define __AST_H__
+
+#include <stddef.h>
+
+typedef struct ast ast_st;
+struct ast;
+
+enum ast_kind {
+    AST_DECL = 0,               /**< var text */
+    AST_ASSIGN,                 /**< text is expr */
+    AST_PRINT,                  /**< print expr */
+    AST_IF,                     /**< if ( cond ) then { then_body } [else { else_body }] */
+    AST_FOR,                    /**< for text from from to|downto to step step { body } */
+    AST_COMPARE,                /**< left symbol right, symbol from SYMBOL_EQUAL to SYMBOL_GREATER_EQUAL */
+    AST_BOOLEAN,                /**< SYMBOL_TRUE or SYMBOL_FALSE */
+    AST_BINARY,                 /**< left symbol right, symbol from SYMBOL_ADD to SYMBOL_MOD */
+    AST_NUMBER,                 /**< text of the number */
+    AST_VARIABLE,               /**< text is the name */
+};
+
+typedef struct ast_node ast_node_st;
+
+struct ast_node {
+    int kind;                   /**< enum ast_kind */
+    int symbol;                 /**< symbol id of the operator, of to or downto, of true or false */
+    int line;                   /**< source line of the first token, 0 for unknown */
+    int column;                 /**< source column of the first token, 0 for unknown */
+    const char *text;           /**< name of the variable, of a number its text */
+    ast_node_st *next;          /**< next statement of the list, NULL for the last */
+    union {
+        ast_node_st *expr;                      /**< AST_ASSIGN, AST_PRINT */
+        struct {
+            ast_node_st *left;                  /**< AST_BINARY, AST_COMPARE */
+            ast_node_st *right;
+        };
+        struct {
+            ast_node_st *cond;                  /**< AST_IF */
+            ast_node_st *then_body;
+            ast_node_st *else_body;             /**< NULL without else */
+            int else_line;                      /**< source position of the else */
+            int else_column;
+        };
+        struct {
+            ast_node_st *from;                  /**< AST_FOR */
+            ast_node_st *to;
+            ast_node_st *step;
+            ast_node_st *body;
+        };
+    };
+};
+
+/**
+ * @brief initialize an empty tree.
+ * @return a valid tree.
+ */
+ast_st *ast_init();
+
+/**
+ * @brief free the tree, all its nodes and texts at once.
+ * @param ast, a valid tree.
+ */
+void ast_free(ast_st *);
+
+/**
+ * @brief create a node, its fields cleared.
+ * @param ast, a valid tree.
+ * @param kind, enum ast_kind.
+ * @param line, source line of the first token.
+ * @param column, source column of the first token.
+ * @return a valid node, owned by the tree.
+ */
+ast_node_st *ast_new_node(ast_st *, int, int, int);
+
+/**
+ * @brief copy a text into the tree.
+ * @param ast, a valid tree.
+ * @param text, first character of the text.
+ * @param length, characters of the text.
+ * @return a '\0' terminated copy, owned by the tree.
+ */
+const char *ast_dup_text(ast_st *, const char *, size_t);
+
+/**
+ * @brief set the first statement of the program.
+ * @param ast, a valid tree.
+ * @param root, the first statement.
+ */
+void ast_set_root(ast_st *, ast_node_st *);
+
+/**
+ * @brief get the first statement of the program.
+ * @param ast, a valid tree.
+ * @return NULL on empty; otherwise the first statement.
+ */
+ast_node_st *ast_get_root(ast_st *);
+
+/**
+ * @brief get the number of nodes.
+ * @param ast, a valid tree.
+ * @return the number of nodes created.
+ */
+int ast_get_node_count(ast_st *);
+
+/**
+ * @brief get the memory taken by the blocks.
+ * @param ast, a valid tree.
+ * @return bytes allocated.
+ */
+size_t ast_get_size(ast_st *);
+
+#endif
@@ -17,6 +17,8 @@ struct link_node
 {
     void *data;                     /**< Data inside the node */
     free_cb free_func;              /**< Call back function on free */
+    int line;                       /**< Line in the source, 0 for unknown */
+    int column;                     /**< Column in the source, 0 for unknown */
     link_node_st *next;             /**< Pointer to the next node */
 };
 
@@ -33,6 +35,8 @@ link_node_st *link_node_new(void *data, free_cb free_func ) {
 
     node->data = data;
     node->free_func = free_func;
+    node->line = 0;
+    node->column = 0;
     node->next = NULL;
     return node;
 }
@@ -64,6 +68,43 @@ void *link_node_get_data(link_node_st *node) {
     return NULL;
 }
 
+/**
+ * @brief set the source position of a node.
+ * @param node, a valid node.
+ * @param line, line number in the source, starting from 1.
+ * @param column, column number in the source, starting from 1.
+ */
+void link_node_set_position(link_node_st *node, int line, int column) {
+    if (node != NULL) {
+        node->line = line;
+        node->column = column;
+    }
+}
+
+/**
+ * @brief get the source line of a node.
+ * @param node, a valid node.
+ * @return 0 on unknown; otherwise the line number.
+ */
+int link_node_get_line(link_node_st *node) {
+    if (node != NULL) {
+        return node->line;
+    }
+    return 0;
+}
+
+/**
+ * @brief get the source column of a node.
+ * @param node, a valid node.
+ * @return 0 on unknown; otherwise the column number.
+ */
+int link_node_get_column(link_node_st *node) {
+    if (node != NULL) {
+        return node->column;
+    }
+    return 0;
+}
+
 /**
  * @brief append one node after the other.
  * @param node_prev, the previous node.
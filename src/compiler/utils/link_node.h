@@ -34,6 +34,28 @@ void link_node_free(link_node_st *);
  */
 void *link_node_get_data(link_node_st *);
 
+/**
+ * @brief set the source position of a node.
+ * @param node, a valid node.
+ * @param line, line number in the source, starting from 1.
+ * @param column, column number in the source, starting from 1.
+ */
+void link_node_set_position(link_node_st *, int, int);
+
+/**
+ * @brief get the source line of a node.
+ * @param node, a valid node.
+ * @return 0 on unknown; otherwise the line number.
+ */
+int link_node_get_line(link_node_st *);
+
+/**
+ * @brief get the source column of a node.
+ * @param node, a valid node.
+ * @return 0 on unknown; otherwise the column number.
+ */
+int link_node_get_column(link_node_st *);
+
 /**
  * @brief append one node after the other.
  * @param node_prev, the previous node.
@@ -1,36 +1,178 @@
 /**
  * @file symboltable.c
  * @brief purpose: to initialize and edit symbol table
+ *
+ * The keywords, operators and delimiters are fixed, they sit in a table
+ * indexed by a perfect hash of their first two characters and length,
+ * worked out at compile time. The identifiers go to an open addressing
+ * table. The numbers are not kept, the tokens carry their values, so
+ * classifying a token takes the same time however long the program is. Every symbol has
+ * a small integer id (enum symbol_id), the identifiers are numbered after
+ * the fixed symbols.
  * @version 1.0
  * @date 04.23.2017
  * @author Katie MacArthur
  */
- 
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "error.h"
 #include "symbol_table.h"
 
-#define DEFAULT_ARRAY_SIZE      (16)
+#define DEFAULT_ARRAY_SIZE      (64)    /**< a power of 2 */
 #define ENLARGE_FACTOR          (2)
+#define KEYWORD_ARRAY_SIZE      (128)   /**< a power of 2, the hash below is perfect for it */
+
+/**
+ * @brief slot of a fixed symbol, no two of them share one.
+ * @param c0 first character.
+ * @param c1 second character, '\0' for one character.
+ * @param length characters of the symbol.
+ */
+#define KEYWORD_SLOT(c0, c1, length) \
+    (((unsigned char)(c0) + 6 * (unsigned char)(c1) + 2 * (length)) & (KEYWORD_ARRAY_SIZE - 1))
+
+#define KEYWORD(text, c0, c1, type, id) \
+    [KEYWORD_SLOT(c0, c1, sizeof(text) - 1)] = { text, sizeof(text) - 1, type, id }
+
+typedef struct keyword
+{
+    const char* symbol;         /**< token string, NULL on an empty slot */
+    int length;                 /**< characters of the token */
+    int token_type;             /**< token type   */
+    int id;                     /**< symbol id */
+} keyword_st;
 
 typedef struct symbol
 {
-    char* symbol;               /**< token string */
+    char* symbol;               /**< token string, NULL on an empty slot */
+    int length;                 /**< characters of the token */
+    uint32_t hash;              /**< hash of the token */
     int token_type;             /**< token type   */
+    int id;                     /**< symbol id */
 } symbol_st;
 
 struct symbol_table
 {
-    symbol_st* symbol_array;    /**< symbol_array struct */
+    symbol_st* symbol_array;    /**< symbol_array struct, open addressing */
     int array_size;             /**< array size          */
     int table_size;             /**< table size          */
+    char** name_array;          /**< text of the identifiers, by id - SYMBOL_FIRST_IDENTIFIER */
+    int name_size;              /**< names allocated */
+};
+
+static const keyword_st keyword_array[KEYWORD_ARRAY_SIZE] = {
+    //delimiter
+    KEYWORD(";", ';', '\0', DELIMITER, SYMBOL_DELIMITER),
+
+    //keywords
+    KEYWORD("is", 'i', 's', KEYWORD, SYMBOL_IS),
+    KEYWORD("var", 'v', 'a', KEYWORD, SYMBOL_VAR),
+    KEYWORD("print", 'p', 'r', KEYWORD, SYMBOL_PRINT),
+    KEYWORD("if", 'i', 'f', KEYWORD, SYMBOL_IF),
+    KEYWORD("then", 't', 'h', KEYWORD, SYMBOL_THEN),
+    KEYWORD("else", 'e', 'l', KEYWORD, SYMBOL_ELSE),
+    KEYWORD("for", 'f', 'o', KEYWORD, SYMBOL_FOR),
+    KEYWORD("from", 'f', 'r', KEYWORD, SYMBOL_FROM),
+    KEYWORD("to", 't', 'o', KEYWORD, SYMBOL_TO),
+    KEYWORD("downto", 'd', 'o', KEYWORD, SYMBOL_DOWNTO),
+    KEYWORD("step", 's', 't', KEYWORD, SYMBOL_STEP),
+    KEYWORD("true", 't', 'r', KEYWORD, SYMBOL_TRUE),
+    KEYWORD("false", 'f', 'a', KEYWORD, SYMBOL_FALSE),
+
+    //binary operations
+    KEYWORD("+", '+', '\0', BIN_OP, SYMBOL_ADD),
+    KEYWORD("-", '-', '\0', BIN_OP, SYMBOL_SUB),
+    KEYWORD("*", '*', '\0', BIN_OP, SYMBOL_MUL),
+    KEYWORD("/", '/', '\0', BIN_OP, SYMBOL_DIV),
+    KEYWORD("%", '%', '\0', BIN_OP, SYMBOL_MOD),
+
+    //boolean operations
+    KEYWORD("=", '=', '\0', BOOLEAN_OP, SYMBOL_EQUAL),
+    KEYWORD("<>", '<', '>', BOOLEAN_OP, SYMBOL_NOT_EQUAL),
+    KEYWORD("<", '<', '\0', BOOLEAN_OP, SYMBOL_LESS),
+    KEYWORD(">", '>', '\0', BOOLEAN_OP, SYMBOL_GREATER),
+    KEYWORD("<=", '<', '=', BOOLEAN_OP, SYMBOL_LESS_EQUAL),
+    KEYWORD(">=", '>', '=', BOOLEAN_OP, SYMBOL_GREATER_EQUAL),
+
+    //parentheses
+    KEYWORD("(", '(', '\0', OPEN_PARENTHESES, SYMBOL_OPEN_PARENTHESIS),
+    KEYWORD(")", ')', '\0', CLOSE_PARENTHESES, SYMBOL_CLOSE_PARENTHESIS),
+
+    //curly brackets
+    KEYWORD("{", '{', '\0', OPEN_CURLY_BRACKETS, SYMBOL_OPEN_CURLY_BRACKET),
+    KEYWORD("}", '}', '\0', CLOSE_CURLY_BRACKETS, SYMBOL_CLOSE_CURLY_BRACKET),
 };
 
+static const char *fixed_name_array[SYMBOL_FIRST_IDENTIFIER] = {
+    [SYMBOL_DELIMITER] = ";",
+    [SYMBOL_IS] = "is",
+    [SYMBOL_VAR] = "var",
+    [SYMBOL_PRINT] = "print",
+    [SYMBOL_IF] = "if",
+    [SYMBOL_THEN] = "then",
+    [SYMBOL_ELSE] = "else",
+    [SYMBOL_FOR] = "for",
+    [SYMBOL_FROM] = "from",
+    [SYMBOL_TO] = "to",
+    [SYMBOL_DOWNTO] = "downto",
+    [SYMBOL_STEP] = "step",
+    [SYMBOL_TRUE] = "true",
+    [SYMBOL_FALSE] = "false",
+    [SYMBOL_ADD] = "+",
+    [SYMBOL_SUB] = "-",
+    [SYMBOL_MUL] = "*",
+    [SYMBOL_DIV] = "/",
+    [SYMBOL_MOD] = "%",
+    [SYMBOL_EQUAL] = "=",
+    [SYMBOL_NOT_EQUAL] = "<>",
+    [SYMBOL_LESS] = "<",
+    [SYMBOL_GREATER] = ">",
+    [SYMBOL_LESS_EQUAL] = "<=",
+    [SYMBOL_GREATER_EQUAL] = ">=",
+    [SYMBOL_OPEN_PARENTHESIS] = "(",
+    [SYMBOL_CLOSE_PARENTHESIS] = ")",
+    [SYMBOL_OPEN_CURLY_BRACKET] = "{",
+    [SYMBOL_CLOSE_CURLY_BRACKET] = "}",
+};
+
+/**
+ * @brief hash a token, FNV-1a.
+ * @param symbol the token.
+ * @param length characters of the token.
+ * @return the hash.
+ */
+static uint32_t hash_symbol(const char *, int);
+
+/**
+ * @brief find the slot of a token in the open addressing table.
+ * @param symbol_table a valid symbol table object.
+ * @param symbol the token.
+ * @param length characters of the token.
+ * @param hash hash of the token.
+ * @return the slot of the token, or the empty slot it goes to.
+ */
+static int find_slot(symbol_table_st *, const char *, int, uint32_t);
+
+/**
+ * @brief double the open addressing table.
+ * @param symbol_table a valid symbol table object.
+ */
+static void enlarge_symbols(symbol_table_st *);
+
+/**
+ * @brief tell a number token.
+ * @param symbol the token.
+ * @param length characters of the token.
+ * @return true if the token is a number; otherwise false.
+ */
+static bool is_number(const char *, int);
+
 /**
  * @brief initialize the symbol table.
  * @return a valid symbol table object.
@@ -41,7 +183,7 @@ symbol_table_st *symbol_table_init()
     if (symbol_table == NULL)
         error_errno(ENOMEM);
 
-    symbol_st *symbol_array = (symbol_st *)malloc(sizeof(symbol_st) * DEFAULT_ARRAY_SIZE);
+    symbol_st *symbol_array = (symbol_st *)calloc(DEFAULT_ARRAY_SIZE, sizeof(symbol_st));
     if (symbol_array == NULL)
         error_errno(ENOMEM);
 
@@ -51,46 +193,12 @@ symbol_table_st *symbol_table_init()
 
     symbol_table->table_size = 0;
 
-    //delimiter
-    symbol_table_insert(symbol_table, ";", DELIMITER);
-
-    //keywords
-    symbol_table_insert(symbol_table, "is", KEYWORD);
-    symbol_table_insert(symbol_table, "var", KEYWORD);
-    symbol_table_insert(symbol_table, "print", KEYWORD);
-    symbol_table_insert(symbol_table, "if", KEYWORD);
-    symbol_table_insert(symbol_table, "then", KEYWORD);
-    symbol_table_insert(symbol_table, "else", KEYWORD);
-    symbol_table_insert(symbol_table, "for", KEYWORD);
-    symbol_table_insert(symbol_table, "from", KEYWORD);
-    symbol_table_insert(symbol_table, "to", KEYWORD);
-    symbol_table_insert(symbol_table, "downto", KEYWORD);    
-    symbol_table_insert(symbol_table, "step", KEYWORD);
-    symbol_table_insert(symbol_table, "true", KEYWORD);
-    symbol_table_insert(symbol_table, "false", KEYWORD);
-
-    //binary operations
-    symbol_table_insert(symbol_table, "+", BIN_OP);
-    symbol_table_insert(symbol_table, "-", BIN_OP);
-    symbol_table_insert(symbol_table, "*", BIN_OP);
-    symbol_table_insert(symbol_table, "/", BIN_OP);
-    symbol_table_insert(symbol_table, "%", BIN_OP);
-
-    //boolean operations
-    symbol_table_insert(symbol_table, "=", BOOLEAN_OP);
-    symbol_table_insert(symbol_table, "<>", BOOLEAN_OP);
-    symbol_table_insert(symbol_table, "<", BOOLEAN_OP);
-    symbol_table_insert(symbol_table, ">", BOOLEAN_OP);
-    symbol_table_insert(symbol_table, "<=", BOOLEAN_OP);
-    symbol_table_insert(symbol_table, ">=", BOOLEAN_OP);
+    symbol_table->name_array = (char **)malloc(sizeof(char *) * DEFAULT_ARRAY_SIZE / 2);
+    if (symbol_table->name_array == NULL)
+        error_errno(ENOMEM);
 
-    //parentheses
-    symbol_table_insert(symbol_table, "(", OPEN_PARENTHESES);
-    symbol_table_insert(symbol_table, ")", CLOSE_PARENTHESES);
+    symbol_table->name_size = DEFAULT_ARRAY_SIZE / 2;
 
-    //curly brackets
-    symbol_table_insert(symbol_table, "{", OPEN_CURLY_BRACKETS);
-    symbol_table_insert(symbol_table, "}", CLOSE_CURLY_BRACKETS);
     return symbol_table;
 
 }
@@ -105,11 +213,12 @@ void symbol_table_fini(symbol_table_st *symbol_table)
         return;
 
     int i;
-    for (i = 0; i < symbol_table->table_size; i++) {
+    for (i = 0; i < symbol_table->array_size; i++) {
         free(symbol_table->symbol_array[i].symbol);
     }
 
     free(symbol_table->symbol_array);
+    free(symbol_table->name_array);
     free(symbol_table);
 }
 
@@ -117,63 +226,229 @@ void symbol_table_fini(symbol_table_st *symbol_table)
  * @brief look up the symbol on symbol table
  * @param table a valid symbol table object.
  * @param symbol a symbol going to look up.
- * @return -1, not found; otherwise the index in symbol table.
+ * @return -1, not found; otherwise the type of the symbol.
  */
 int symbol_table_lookup(symbol_table_st *symbol_table, char *symbol) {
 
     if (symbol_table == NULL || symbol == NULL)
         return -1;
 
-    if (symbol_table->table_size == 0)
+    return symbol_table_lookup_text(symbol_table, symbol, strlen(symbol), NULL);
+}
+
+/**
+ * @brief look up a symbol that is not '\0' terminated.
+ * @param table a valid symbol table object.
+ * @param symbol first character of the symbol.
+ * @param length characters of the symbol.
+ * @param id [out] the symbol id, SYMBOL_UNKNOWN if not found; can be NULL.
+ * @return -1, not found; otherwise the type of the symbol.
+ */
+int symbol_table_lookup_text(symbol_table_st *symbol_table, const char *symbol, int length,
+                             int *id) {
+    const keyword_st *keyword;
+    symbol_st *entry;
+    int unused;
+
+    if (id == NULL)
+        id = &unused;
+    *id = SYMBOL_UNKNOWN;
+
+    if (symbol_table == NULL || symbol == NULL || length <= 0)
         return -1;
 
-    int index = 0;
-    while (index < symbol_table->table_size) {
-        if (strcmp(symbol,symbol_table->symbol_array[index].symbol) == 0) {
-            return symbol_table->symbol_array[index].token_type;
-        } else {
-            index++;
-        }
+    keyword = &keyword_array[KEYWORD_SLOT(symbol[0], length > 1 ? symbol[1] : '\0', length)];
+    if (keyword->length == length && memcmp(keyword->symbol, symbol, length) == 0) {
+        *id = keyword->id;
+        return keyword->token_type;
     }
 
-    return -1;
-
+    if (is_number(symbol, length)) {
+        *id = SYMBOL_NUMBER;
+        return NUMBER;
+    }
 
+    entry = &symbol_table->symbol_array[find_slot(symbol_table, symbol, length,
+                                                  hash_symbol(symbol, length))];
+    if (entry->symbol == NULL)
+        return -1;
+    *id = entry->id;
+    return entry->token_type;
 }
 
 /**
  * @brief insert the symbol to symbol table
  * @param table a valid symbol table object.
  * @param symbol a symbol going to insert.
- * @param token_val the value of the token.
- * @return -1, failed; otherwise the index inserted in symbol table.
+ * @param token_type the type of the token.
+ * @return -1, failed; otherwise the symbol id, SYMBOL_NUMBER for a number.
  */
 int symbol_table_insert(symbol_table_st *symbol_table, char *symbol, int token_type) {
-    int index = -1;
- 
-    if (symbol_table == NULL)
+
+    if (symbol_table == NULL || symbol == NULL)
         return -1;
 
-    if ((index = symbol_table_lookup(symbol_table,symbol)) == -1) {
-        index = symbol_table->table_size;
+    return symbol_table_insert_text(symbol_table, symbol, strlen(symbol), token_type);
+}
+
+/**
+ * @brief insert a symbol that is not '\0' terminated, the numbers are not kept.
+ * @param table a valid symbol table object.
+ * @param symbol first character of the symbol.
+ * @param length characters of the symbol.
+ * @param token_type the type of the token.
+ * @return -1, failed; otherwise the symbol id, SYMBOL_NUMBER for a number.
+ */
+int symbol_table_insert_text(symbol_table_st *symbol_table, const char *symbol, int length,
+                             int token_type) {
+    const keyword_st *keyword;
+    symbol_st *entry;
+    uint32_t hash;
+    int index;
+
+    if (symbol_table == NULL || symbol == NULL || length <= 0)
+        return -1;
 
-        if (symbol_table->table_size >= symbol_table->array_size) {
-            symbol_table->symbol_array = realloc(symbol_table->symbol_array,
-                                                  sizeof(symbol_st) * symbol_table->array_size * ENLARGE_FACTOR);
-            if (symbol_table->symbol_array == NULL)
-                exit(ENOMEM);
+    keyword = &keyword_array[KEYWORD_SLOT(symbol[0], length > 1 ? symbol[1] : '\0', length)];
+    if (keyword->length == length && memcmp(keyword->symbol, symbol, length) == 0)
+        return keyword->id;
 
-            symbol_table->array_size *= ENLARGE_FACTOR;
-        }
+    if (is_number(symbol, length))
+        return SYMBOL_NUMBER;
 
-        symbol_table->symbol_array[index].symbol = strdup(symbol);
+    hash = hash_symbol(symbol, length);
+    index = find_slot(symbol_table, symbol, length, hash);
+    if (symbol_table->symbol_array[index].symbol != NULL)
+        return symbol_table->symbol_array[index].id;
 
-        symbol_table->symbol_array[index].token_type = token_type;
+    // keep at most half of the slots in use.
+    if ((symbol_table->table_size + 1) * 2 > symbol_table->array_size) {
+        enlarge_symbols(symbol_table);
+        index = find_slot(symbol_table, symbol, length, hash);
+    }
 
-        symbol_table->table_size++;
+    entry = &symbol_table->symbol_array[index];
+    entry->symbol = (char *)malloc(length + 1);
+    if (entry->symbol == NULL)
+        error_errno(ENOMEM);
+    memcpy(entry->symbol, symbol, length);
+    entry->symbol[length] = '\0';
+    entry->length = length;
+    entry->hash = hash;
+    entry->token_type = token_type;
+    entry->id = SYMBOL_FIRST_IDENTIFIER + symbol_table->table_size;
+
+    if (symbol_table->table_size == symbol_table->name_size) {
+        symbol_table->name_array = (char **)realloc(symbol_table->name_array,
+                                   sizeof(char *) * symbol_table->name_size * ENLARGE_FACTOR);
+        if (symbol_table->name_array == NULL)
+            error_errno(ENOMEM);
+        symbol_table->name_size *= ENLARGE_FACTOR;
     }
+    symbol_table->name_array[symbol_table->table_size] = entry->symbol;
+
+    symbol_table->table_size++;
+
+    return entry->id;
+}
+
+/**
+ * @brief get the text of a symbol id.
+ * @param table a valid symbol table object.
+ * @param id a symbol id, not SYMBOL_NUMBER.
+ * @return NULL, unknown id; otherwise the text, owned by the table.
+ */
+const char *symbol_table_get_name(symbol_table_st *symbol_table, int id) {
+    if (id > SYMBOL_UNKNOWN && id < SYMBOL_FIRST_IDENTIFIER)
+        return fixed_name_array[id];
+    if (symbol_table == NULL || id < SYMBOL_FIRST_IDENTIFIER ||
+        id - SYMBOL_FIRST_IDENTIFIER >= symbol_table->table_size)
+        return NULL;
+    return symbol_table->name_array[id - SYMBOL_FIRST_IDENTIFIER];
+}
+
+/**
+ * @brief hash a token, FNV-1a.
+ * @param symbol the token.
+ * @param length characters of the token.
+ * @return the hash.
+ */
+static uint32_t hash_symbol(const char *symbol, int length) {
+    uint32_t hash = 2166136261u;
+    int i;
 
-    return index;
+    for (i = 0; i < length; i++) {
+        hash ^= (unsigned char)symbol[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief find the slot of a token in the open addressing table.
+ * @param symbol_table a valid symbol table object.
+ * @param symbol the token.
+ * @param length characters of the token.
+ * @param hash hash of the token.
+ * @return the slot of the token, or the empty slot it goes to.
+ */
+static int find_slot(symbol_table_st *symbol_table, const char *symbol, int length,
+                     uint32_t hash) {
+    int mask = symbol_table->array_size - 1;
+    int index = hash & mask;
+    symbol_st *entry;
+
+    for (;;) {
+        entry = &symbol_table->symbol_array[index];
+        if (entry->symbol == NULL)
+            return index;
+        if (entry->hash == hash && entry->length == length &&
+            memcmp(entry->symbol, symbol, length) == 0)
+            return index;
+        index = (index + 1) & mask;
+    }
+}
+
+/**
+ * @brief double the open addressing table.
+ * @param symbol_table a valid symbol table object.
+ */
+static void enlarge_symbols(symbol_table_st *symbol_table) {
+    symbol_st *old_array = symbol_table->symbol_array;
+    int old_size = symbol_table->array_size;
+    int i;
+
+    symbol_table->array_size *= ENLARGE_FACTOR;
+    symbol_table->symbol_array = (symbol_st *)calloc(symbol_table->array_size, sizeof(symbol_st));
+    if (symbol_table->symbol_array == NULL)
+        error_errno(ENOMEM);
+
+    for (i = 0; i < old_size; i++) {
+        if (old_array[i].symbol != NULL)
+            symbol_table->symbol_array[find_slot(symbol_table, old_array[i].symbol,
+                                                 old_array[i].length,
+                                                 old_array[i].hash)] = old_array[i];
+    }
+    free(old_array);
+}
+
+/**
+ * @brief tell a number token.
+ * @param symbol the token.
+ * @param length characters of the token.
+ * @return true if the token is a number; otherwise false.
+ */
+static bool is_number(const char *symbol, int length) {
+    bool negative = (symbol[0] == '-');
+    int i;
+
+    if (length == negative)
+        return false;
+    for (i = negative; i < length; i++) {
+        if ((unsigned char)(symbol[i] - '0') >= 10)
+            return false;
+    }
+    return true;
 }
 
 #ifdef SYMBOL_TABLE_TEST
@@ -181,12 +456,14 @@ int symbol_table_insert(symbol_table_st *symbol_table, char *symbol, int token_t
 void test_case_one();
 void test_case_two();
 void test_case_three();
+void test_case_four();
 
 int main() {
 
     test_case_one();
     test_case_two();
     test_case_three();
+    test_case_four();
 
     return 0;
 }
@@ -194,23 +471,54 @@ int main() {
 void test_case_one() {
 
     symbol_table_st* table = symbol_table_init();
-    printf("Index of + symbol (should return 2): %d\n", symbol_table_lookup(table,"+"));
+    printf("Type of + symbol (should return 2): %d\n", symbol_table_lookup(table,"+"));
     symbol_table_fini(table);
 }
 
 void test_case_two() {
 
     symbol_table_st* table = symbol_table_init();
-    printf("Index of 'the'(should return -1): %d\n", symbol_table_lookup(table,"the"));
+    printf("Type of 'the'(should return -1): %d\n", symbol_table_lookup(table,"the"));
     symbol_table_fini(table);
 }
 
 void test_case_three() {
 
     symbol_table_st* table = symbol_table_init();
-    printf("Table size (should be 26): %d\n",table->table_size);
+    printf("Table size (should be 0): %d\n",table->table_size);
     symbol_table_insert(table, "var", KEYWORD);
     printf("Table size after attempt to put in 'var' again: %d\n",table->table_size);
+    symbol_table_insert(table, "x", IDENTIFIER);
+    symbol_table_insert(table, "x", IDENTIFIER);
+    printf("Table size after putting in 'x' twice (should be 1): %d\n",table->table_size);
+    printf("Name of the first identifier (should be x): %s\n",
+           symbol_table_get_name(table, SYMBOL_FIRST_IDENTIFIER));
+    symbol_table_fini(table);
+}
+
+void test_case_four() {
+
+    symbol_table_st* table = symbol_table_init();
+    int fixed = 0;
+    int id;
+    int i;
+    // every fixed symbol is found in its own slot, none is overwritten.
+    for (i = 0; i < KEYWORD_ARRAY_SIZE; i++) {
+        if (keyword_array[i].symbol == NULL)
+            continue;
+        fixed++;
+        if (symbol_table_lookup_text(table, keyword_array[i].symbol,
+                                     keyword_array[i].length, &id) != keyword_array[i].token_type ||
+            strcmp(symbol_table_get_name(table, id), keyword_array[i].symbol) != 0)
+            printf("Fixed symbol '%s' is not found\n", keyword_array[i].symbol);
+    }
+    printf("Fixed symbols (should be 29): %d\n", fixed);
+    // the numbers are classified, not kept.
+    id = symbol_table_insert(table, "12", NUMBER);
+    symbol_table_insert(table, "012", NUMBER);
+    printf("Id of 12 (should be %d): %d, type of -3 (should be 3): %d\n",
+           SYMBOL_NUMBER, id, symbol_table_lookup(table, "-3"));
+    printf("Identifiers after the numbers (should be 0): %d\n", table->table_size);
     symbol_table_fini(table);
 }
 
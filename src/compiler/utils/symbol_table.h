@@ -26,6 +26,48 @@ enum type {
     CLOSE_CURLY_BRACKETS = 10,
 };
 
+/**
+ * @brief small integer ids of the symbols, given once by the lexer and
+ *        carried by the tokens and the nodes of the ast.
+ */
+enum symbol_id {
+    SYMBOL_UNKNOWN = 0,                 /**< not interned, or the end of the tokens */
+
+    // fixed symbols.
+    SYMBOL_DELIMITER,                   /**< ";" */
+    SYMBOL_IS,
+    SYMBOL_VAR,
+    SYMBOL_PRINT,
+    SYMBOL_IF,
+    SYMBOL_THEN,
+    SYMBOL_ELSE,
+    SYMBOL_FOR,
+    SYMBOL_FROM,
+    SYMBOL_TO,
+    SYMBOL_DOWNTO,
+    SYMBOL_STEP,
+    SYMBOL_TRUE,
+    SYMBOL_FALSE,
+    SYMBOL_ADD,                         /**< "+" */
+    SYMBOL_SUB,                         /**< "-" */
+    SYMBOL_MUL,                         /**< "*" */
+    SYMBOL_DIV,                         /**< "/" */
+    SYMBOL_MOD,                         /**< "%" */
+    SYMBOL_EQUAL,                       /**< "=" */
+    SYMBOL_NOT_EQUAL,                   /**< "<>" */
+    SYMBOL_LESS,                        /**< "<" */
+    SYMBOL_GREATER,                     /**< ">" */
+    SYMBOL_LESS_EQUAL,                  /**< "<=" */
+    SYMBOL_GREATER_EQUAL,               /**< ">=" */
+    SYMBOL_OPEN_PARENTHESIS,            /**< "(" */
+    SYMBOL_CLOSE_PARENTHESIS,           /**< ")" */
+    SYMBOL_OPEN_CURLY_BRACKET,          /**< "{" */
+    SYMBOL_CLOSE_CURLY_BRACKET,         /**< "}" */
+
+    SYMBOL_NUMBER,                      /**< any number, the value is kept apart */
+    SYMBOL_FIRST_IDENTIFIER,            /**< the identifiers follow, in order of insertion */
+};
+
 /**
  * @brief initialize the symbol table.
  * @return a valid symbol table object.
@@ -42,17 +84,45 @@ void symbol_table_fini(symbol_table_st *);
  * @brief look up the symbol on symbol table
  * @param table a valid symbol table object.
  * @param symbol a symbol going to look up.
- * @return -1, not found; otherwise the index in symbol table.
+ * @return -1, not found; otherwise the type of the symbol.
  */
 int symbol_table_lookup(symbol_table_st *, char *symbol);
 
+/**
+ * @brief look up a symbol that is not '\0' terminated.
+ * @param table a valid symbol table object.
+ * @param symbol first character of the symbol.
+ * @param length characters of the symbol.
+ * @param id [out] the symbol id, SYMBOL_UNKNOWN if not found; can be NULL.
+ * @return -1, not found; otherwise the type of the symbol.
+ */
+int symbol_table_lookup_text(symbol_table_st *, const char *symbol, int length, int *id);
+
 /**
  * @brief insert the symbol to symbol table
  * @param table a valid symbol table object.
  * @param symbol a symbol going to insert.
  * @param token_type the type of the token.
- * @return -1, failed; otherwise the index inserted in symbol table.
+ * @return -1, failed; otherwise the symbol id, SYMBOL_NUMBER for a number.
  */
 int symbol_table_insert(symbol_table_st *, char *symbol, int token_type);
 
+/**
+ * @brief insert a symbol that is not '\0' terminated, the numbers are not kept.
+ * @param table a valid symbol table object.
+ * @param symbol first character of the symbol.
+ * @param length characters of the symbol.
+ * @param token_type the type of the token.
+ * @return -1, failed; otherwise the symbol id, SYMBOL_NUMBER for a number.
+ */
+int symbol_table_insert_text(symbol_table_st *, const char *symbol, int length, int token_type);
+
+/**
+ * @brief get the text of a symbol id.
+ * @param table a valid symbol table object.
+ * @param id a symbol id, not SYMBOL_NUMBER.
+ * @return NULL, unknown id; otherwise the text, owned by the table.
+ */
+const char *symbol_table_get_name(symbol_table_st *, int id);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,238 @@
+/**
+ * @file token_array.c
+ * @brief Purpose: implementation of token_array data structure
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "error.h"
+#include "symbol_table.h"
+#include "token_array.h"
+
+#define DEFAULT_ARRAY_SIZE      (1024)
+#define ENLARGE_FACTOR          (2)
+#define SOURCE_PER_TOKEN        (8)     /**< characters per token guessed for the first size */
+
+struct token_array
+{
+    token_st *token_array;          /**< the tokens */
+    int array_size;                 /**< tokens allocated */
+    int token_count;                /**< tokens appended */
+    uint32_t *line_array;           /**< offset of the start of each line */
+    int line_size;                  /**< lines allocated */
+    int line_count;                 /**< lines recorded */
+    const char *source;             /**< the source text */
+    size_t source_size;             /**< characters of the source */
+    free_source_cb free_func;       /**< Call back function on free */
+};
+
+/**
+ * @brief initialize the token array of a source.
+ * @param source, the source text, it is owned by the array from now on.
+ * @param size, characters of the source.
+ * @param free_func, the function to free the source, can be NULL.
+ * @return a valid token array.
+ */
+token_array_st *token_array_init(const char *source, size_t size, free_source_cb free_func) {
+    token_array_st *tokens = (token_array_st *)malloc(sizeof(token_array_st));
+    if (tokens == NULL)
+        error_errno(ENOMEM);
+
+    tokens->array_size = DEFAULT_ARRAY_SIZE;
+    if (size / SOURCE_PER_TOKEN > DEFAULT_ARRAY_SIZE && size / SOURCE_PER_TOKEN < INT32_MAX)
+        tokens->array_size = size / SOURCE_PER_TOKEN;
+    tokens->token_array = (token_st *)malloc(sizeof(token_st) * tokens->array_size);
+    if (tokens->token_array == NULL)
+        error_errno(ENOMEM);
+    tokens->token_count = 0;
+
+    tokens->line_size = DEFAULT_ARRAY_SIZE;
+    tokens->line_array = (uint32_t *)malloc(sizeof(uint32_t) * tokens->line_size);
+    if (tokens->line_array == NULL)
+        error_errno(ENOMEM);
+    // line 1 starts the source.
+    tokens->line_array[0] = 0;
+    tokens->line_count = 1;
+
+    tokens->source = source;
+    tokens->source_size = size;
+    tokens->free_func = free_func;
+    return tokens;
+}
+
+/**
+ * @brief free the token array and its source.
+ * @param tokens, a valid token array.
+ */
+void token_array_free(token_array_st *tokens) {
+    if (tokens == NULL)
+        return;
+    if (tokens->free_func != NULL && tokens->source != NULL)
+        tokens->free_func(tokens->source, tokens->source_size);
+    free(tokens->token_array);
+    free(tokens->line_array);
+    free(tokens);
+}
+
+/**
+ * @brief append a token.
+ * @param tokens, a valid token array.
+ * @param type, enum type of the token.
+ * @param offset, first character in the source.
+ * @param length, characters of the token.
+ * @param line, source line of the token.
+ * @param value, value of a NUMBER; otherwise the symbol id.
+ */
+void token_array_append(token_array_st *tokens, int type, size_t offset, size_t length,
+                        int line, int value) {
+    token_st *token;
+
+    if (tokens->token_count == tokens->array_size) {
+        tokens->token_array = (token_st *)realloc(tokens->token_array,
+                              sizeof(token_st) * tokens->array_size * ENLARGE_FACTOR);
+        if (tokens->token_array == NULL)
+            error_errno(ENOMEM);
+        tokens->array_size *= ENLARGE_FACTOR;
+    }
+    // the offsets and the lengths are 32 and 24 bits wide.
+    if (offset > UINT32_MAX || length > 0xFFFFFF)
+        error_errno(EFBIG);
+
+    token = &tokens->token_array[tokens->token_count++];
+    token->offset = offset;
+    token->line = line;
+    token->value = value;
+    token->type = type;
+    token->length = length;
+}
+
+/**
+ * @brief record the start of the next line, in order.
+ * @param tokens, a valid token array.
+ * @param offset, first character of the line in the source.
+ */
+void token_array_add_line(token_array_st *tokens, size_t offset) {
+    if (tokens->line_count == tokens->line_size) {
+        tokens->line_array = (uint32_t *)realloc(tokens->line_array,
+                             sizeof(uint32_t) * tokens->line_size * ENLARGE_FACTOR);
+        if (tokens->line_array == NULL)
+            error_errno(ENOMEM);
+        tokens->line_size *= ENLARGE_FACTOR;
+    }
+    tokens->line_array[tokens->line_count++] = offset;
+}
+
+/**
+ * @brief get the number of tokens.
+ * @param tokens, a valid token array.
+ * @return the number of tokens.
+ */
+int token_array_get_count(token_array_st *tokens) {
+    if (tokens == NULL)
+        return 0;
+    return tokens->token_count;
+}
+
+/**
+ * @brief get a token.
+ * @param tokens, a valid token array.
+ * @param index, index of the token.
+ * @return NULL past the last token; otherwise the token.
+ */
+const token_st *token_array_get(token_array_st *tokens, int index) {
+    if (tokens == NULL || index < 0 || index >= tokens->token_count)
+        return NULL;
+    return &tokens->token_array[index];
+}
+
+/**
+ * @brief get the source the tokens point into.
+ * @param tokens, a valid token array.
+ * @return the source text, not '\0' terminated.
+ */
+const char *token_array_get_source(token_array_st *tokens) {
+    if (tokens == NULL)
+        return NULL;
+    return tokens->source;
+}
+
+/**
+ * @brief get the enum type of a token.
+ * @param token, a valid token.
+ * @return the enum type, NONE included.
+ */
+int token_get_type(const token_st *token) {
+    return (int8_t)token->type;
+}
+
+/**
+ * @brief get the source column of a token.
+ * @param tokens, a valid token array.
+ * @param token, a token of the array.
+ * @return 0 on unknown; otherwise the column number, starting from 1.
+ */
+int token_array_get_column(token_array_st *tokens, const token_st *token) {
+    if (token->line == 0 || (int)token->line > tokens->line_count)
+        return 0;
+    return token->offset - tokens->line_array[token->line - 1] + 1;
+}
+
+/**
+ * @brief get the symbol id of a token.
+ * @param token, a valid token.
+ * @return the symbol id, SYMBOL_NUMBER for a number.
+ */
+int token_get_id(const token_st *token) {
+    if ((int8_t)token->type == NUMBER)
+        return SYMBOL_NUMBER;
+    return token->value;
+}
+
+/**
+ * @brief copy the text of a token.
+ * @param tokens, a valid token array.
+ * @param token, a token of the array.
+ * @return a '\0' terminated copy, to be freed.
+ */
+char *token_array_dup_text(token_array_st *tokens, const token_st *token) {
+    char *text = (char *)malloc(token->length + 1);
+    if (text == NULL)
+        error_errno(ENOMEM);
+    memcpy(text, tokens->source + token->offset, token->length);
+    text[token->length] = '\0';
+    return text;
+}
+
+#ifdef TOKEN_ARRAY_TEST
+int main() {
+    const char *source = "var i;\n  i is 12;";
+    token_array_st *tokens = token_array_init(source, strlen(source), NULL);
+    const token_st *token;
+    char *text;
+    int i;
+
+    token_array_append(tokens, KEYWORD, 0, 3, 1, SYMBOL_VAR);
+    token_array_append(tokens, IDENTIFIER, 4, 1, 1, SYMBOL_FIRST_IDENTIFIER);
+    token_array_append(tokens, DELIMITER, 5, 1, 1, SYMBOL_DELIMITER);
+    token_array_add_line(tokens, 7);
+    token_array_append(tokens, IDENTIFIER, 9, 1, 2, SYMBOL_FIRST_IDENTIFIER);
+    token_array_append(tokens, KEYWORD, 11, 2, 2, SYMBOL_IS);
+    token_array_append(tokens, NUMBER, 14, 2, 2, 12);
+    token_array_append(tokens, DELIMITER, 16, 1, 2, SYMBOL_DELIMITER);
+
+    for (i = 0; (token = token_array_get(tokens, i)) != NULL; i++) {
+        text = token_array_dup_text(tokens, token);
+        printf("%s type %d id %d line %u column %d value %d\n", text, token_get_type(token),
+               token_get_id(token), token->line, token_array_get_column(tokens, token),
+               token->value);
+        free(text);
+    }
+    printf("count %d, size %zu\n", token_array_get_count(tokens), sizeof(token_st));
+    token_array_free(tokens);
+    return 0;
+}
+#endif
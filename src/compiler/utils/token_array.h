@@ -0,0 +1,115 @@
+/**
+ * @file token_array.h
+ * @brief Purpose: the tokens of a source, in one contiguous array.
+ *
+ * A token does not hold its text, it points into the source by offset and
+ * length, so the array keeps the source alive until it is freed. The column
+ * of a token comes from the start of its line, recorded once per line.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __TOKEN_ARRAY_H__
+#define __TOKEN_ARRAY_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct token_array token_array_st;
+struct token_array;
+
+typedef struct token {
+    uint32_t offset;            /**< first character in the source */
+    uint32_t line;              /**< source line, starting from 1; 0 past the last token */
+    int32_t value;              /**< value of a NUMBER; otherwise the symbol id */
+    uint32_t type : 8;          /**< enum type of symbol_table.h, NONE stored as 0xFF */
+    uint32_t length : 24;       /**< characters of the token */
+} token_st;
+
+typedef void (*free_source_cb)(const char *, size_t);      /**< Call back function on free */
+
+/**
+ * @brief initialize the token array of a source.
+ * @param source, the source text, it is owned by the array from now on.
+ * @param size, characters of the source.
+ * @param free_func, the function to free the source, can be NULL.
+ * @return a valid token array.
+ */
+token_array_st *token_array_init(const char *, size_t, free_source_cb);
+
+/**
+ * @brief free the token array and its source.
+ * @param tokens, a valid token array.
+ */
+void token_array_free(token_array_st *);
+
+/**
+ * @brief append a token.
+ * @param tokens, a valid token array.
+ * @param type, enum type of the token.
+ * @param offset, first character in the source.
+ * @param length, characters of the token.
+ * @param line, source line of the token.
+ * @param value, value of a NUMBER; otherwise the symbol id.
+ */
+void token_array_append(token_array_st *, int, size_t, size_t, int, int);
+
+/**
+ * @brief record the start of the next line, in order.
+ * @param tokens, a valid token array.
+ * @param offset, first character of the line in the source.
+ */
+void token_array_add_line(token_array_st *, size_t);
+
+/**
+ * @brief get the number of tokens.
+ * @param tokens, a valid token array.
+ * @return the number of tokens.
+ */
+int token_array_get_count(token_array_st *);
+
+/**
+ * @brief get a token.
+ * @param tokens, a valid token array.
+ * @param index, index of the token.
+ * @return NULL past the last token; otherwise the token.
+ */
+const token_st *token_array_get(token_array_st *, int);
+
+/**
+ * @brief get the source the tokens point into.
+ * @param tokens, a valid token array.
+ * @return the source text, not '\0' terminated.
+ */
+const char *token_array_get_source(token_array_st *);
+
+/**
+ * @brief get the enum type of a token.
+ * @param token, a valid token.
+ * @return the enum type, NONE included.
+ */
+int token_get_type(const token_st *);
+
+/**
+ * @brief get the source column of a token.
+ * @param tokens, a valid token array.
+ * @param token, a token of the array.
+ * @return 0 on unknown; otherwise the column number, starting from 1.
+ */
+int token_array_get_column(token_array_st *, const token_st *);
+
+/**
+ * @brief get the symbol id of a token.
+ * @param token, a valid token.
+ * @return the symbol id, SYMBOL_NUMBER for a number.
+ */
+int token_get_id(const token_st *);
+
+/**
+ * @brief copy the text of a token.
+ * @param tokens, a valid token array.
+ * @param token, a token of the array.
+ * @return a '\0' terminated copy, to be freed.
+ */
+char *token_array_dup_text(token_array_st *, const token_st *);
+
+#endif
@@ -0,0 +1,306 @@
+/**
+ * @file checkpoint.c
+ * @brief Purpose: snapshot and restore the state of a running program.
+ *
+ * Layout of the checkpoint file, all fields in native byte order:
+ *
+ *     header                      fixed size, see checkpoint_header_st
+ *     scope boundaries            int32_t[current_scope + 1]
+ *     variables                   checkpoint_variable_st[variable_count]
+ *     string pool                 variable names, '\0' terminated
+ *
+ * Every section is 4 bytes aligned, so the file can be mapped and read in place.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "checkpoint.h"
+
+#define CHECKPOINT_MAGIC        "TENCKPT"           /**< magic string, with '\0' fills 8 bytes */
+#define CHECKPOINT_VERSION      (1)                 /**< version of the file layout */
+
+typedef struct checkpoint_header {
+    char magic[8];                                  /**< CHECKPOINT_MAGIC */
+    uint32_t version;                               /**< CHECKPOINT_VERSION */
+    uint32_t header_size;                           /**< sizeof(checkpoint_header_st) */
+    uint64_t program_hash;                          /**< identity of the program */
+    int32_t program_counter;                        /**< program counter(PC) */
+    int32_t flag_register;                          /**< flag register for cmp result */
+    int32_t current_scope;                          /**< scope level */
+    uint32_t variable_count;                        /**< number of variables */
+    uint64_t string_pool_size;                      /**< size of the string pool */
+} checkpoint_header_st;
+
+typedef struct checkpoint_variable {
+    uint32_t name_offset;                           /**< offset of the name in string pool */
+    int32_t value;                                  /**< value of the variable */
+    int32_t scope;                                  /**< scope of the variable */
+} checkpoint_variable_st;
+
+/**
+ * @brief write the whole buffer into a file descriptor.
+ * @param fd a valid file descriptor.
+ * @param buffer data going to write.
+ * @param size size of the data.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_write_all(int, const char *, size_t);
+
+/**
+ * @brief write a snapshot of the virtual machine into a file.
+ *        The file is replaced atomically, a crash while writing keeps the old one.
+ * @param file_path path of the checkpoint file.
+ * @param instructions a valid instruction set object.
+ * @param machine_store a valid machine_store.
+ * @return 0 on success; otherwise errno.
+ */
+int checkpoint_save(const char *file_path, instruction_set_st *instructions,
+                    machine_memory_st *machine_store) {
+    checkpoint_header_st *header;
+    checkpoint_variable_st *variables;
+    int32_t *boundaries;
+    memory_st *variable;
+    char *buffer;
+    char *pool;
+    char *tmp_path;
+    size_t tmp_len;
+    size_t total;
+    size_t offset;
+    size_t name_len;
+    int scope;
+    int count;
+    int fd;
+    int rc;
+    int i;
+
+    if (file_path == NULL || instructions == NULL || machine_store == NULL)
+        return EINVAL;
+
+    scope = machine_memory_get_scope(machine_store);
+    count = machine_memory_get_count(machine_store);
+
+    total = sizeof(checkpoint_header_st) +
+            (scope + 1) * sizeof(int32_t) +
+            count * sizeof(checkpoint_variable_st);
+    for (i = 0; i < count; i++) {
+        variable = machine_memory_get_address(machine_store, i);
+        total += strlen(memory_get_name(variable)) + 1;
+    }
+
+    buffer = (char *)calloc(1, total);
+    if (buffer == NULL)
+        return ENOMEM;
+
+    header = (checkpoint_header_st *)buffer;
+    boundaries = (int32_t *)(buffer + sizeof(checkpoint_header_st));
+    variables = (checkpoint_variable_st *)(boundaries + scope + 1);
+    pool = (char *)(variables + count);
+
+    memcpy(header->magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    header->version = CHECKPOINT_VERSION;
+    header->header_size = sizeof(checkpoint_header_st);
+    header->program_hash = instruction_set_get_hash(instructions);
+    header->program_counter = instruction_set_get_pc(instructions);
+    header->flag_register = instruction_set_get_flag(instructions);
+    header->current_scope = scope;
+    header->variable_count = count;
+
+    for (i = 0; i <= scope; i++)
+        boundaries[i] = machine_memory_get_scope_boundary(machine_store, i);
+
+    offset = 0;
+    for (i = 0; i < count; i++) {
+        variable = machine_memory_get_address(machine_store, i);
+        name_len = strlen(memory_get_name(variable)) + 1;
+        memcpy(pool + offset, memory_get_name(variable), name_len);
+        variables[i].name_offset = offset;
+        variables[i].value = memory_get_value(variable);
+        variables[i].scope = memory_get_scope(variable);
+        offset += name_len;
+    }
+    header->string_pool_size = offset;
+
+    // write into a temporary file, then rename it to replace the old snapshot.
+    tmp_len = strlen(file_path) + strlen(".tmp") + 1;
+    tmp_path = (char *)malloc(tmp_len);
+    if (tmp_path == NULL) {
+        free(buffer);
+        return ENOMEM;
+    }
+    snprintf(tmp_path, tmp_len, "%s.tmp", file_path);
+
+    fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        rc = errno;
+        free(tmp_path);
+        free(buffer);
+        return rc;
+    }
+
+    rc = s_write_all(fd, buffer, total);
+    if (rc == 0 && fsync(fd) != 0)
+        rc = errno;
+    if (close(fd) != 0 && rc == 0)
+        rc = errno;
+    if (rc == 0 && rename(tmp_path, file_path) != 0)
+        rc = errno;
+    if (rc != 0)
+        unlink(tmp_path);
+
+#ifdef DEBUG
+    fprintf(stderr, "checkpoint: pc %d, scope %d, %d variables, %zu bytes, rc %d\n",
+                    header->program_counter, scope, count, total, rc);
+#endif
+    free(tmp_path);
+    free(buffer);
+    return rc;
+}
+
+/**
+ * @brief restore the virtual machine from a snapshot file.
+ *        The instruction set must hold the same program the snapshot taken from,
+ *        the machine_store must be freshly initialized.
+ * @param file_path path of the checkpoint file.
+ * @param instructions [in/out] a valid instruction set object.
+ * @param machine_store [in/out] a valid machine_store.
+ * @return 0 on success; otherwise errno.
+ */
+int checkpoint_restore(const char *file_path, instruction_set_st *instructions,
+                       machine_memory_st *machine_store) {
+    const checkpoint_header_st *header;
+    const checkpoint_variable_st *variables;
+    const int32_t *boundaries;
+    const char *pool;
+    struct stat file_stat;
+    size_t expected;
+    void *mapped;
+    int scope;
+    int fd;
+    int rc = 0;
+    uint32_t i;
+
+    if (file_path == NULL || instructions == NULL || machine_store == NULL)
+        return EINVAL;
+
+    if (machine_memory_get_count(machine_store) != 0 ||
+        machine_memory_get_scope(machine_store) != 0)
+        return EINVAL;
+
+    fd = open(file_path, O_RDONLY);
+    if (fd < 0)
+        return errno;
+
+    if (fstat(fd, &file_stat) != 0) {
+        rc = errno;
+        close(fd);
+        return rc;
+    }
+
+    if ((size_t)file_stat.st_size < sizeof(checkpoint_header_st)) {
+        close(fd);
+        return EINVAL;
+    }
+
+    mapped = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return errno;
+
+    header = (const checkpoint_header_st *)mapped;
+    if (memcmp(header->magic, CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC)) != 0 ||
+        header->version != CHECKPOINT_VERSION ||
+        header->header_size != sizeof(checkpoint_header_st) ||
+        header->current_scope < 0) {
+        fprintf(stderr, "%s: not a checkpoint file\n", file_path);
+        rc = EINVAL;
+        goto out;
+    }
+
+    if (header->program_hash != instruction_set_get_hash(instructions)) {
+        fprintf(stderr, "%s: checkpoint belongs to a different program\n", file_path);
+        rc = EINVAL;
+        goto out;
+    }
+
+    expected = sizeof(checkpoint_header_st) +
+               ((size_t)header->current_scope + 1) * sizeof(int32_t) +
+               (size_t)header->variable_count * sizeof(checkpoint_variable_st) +
+               header->string_pool_size;
+    if (expected != (size_t)file_stat.st_size) {
+        fprintf(stderr, "%s: truncated checkpoint file\n", file_path);
+        rc = EINVAL;
+        goto out;
+    }
+
+    boundaries = (const int32_t *)((const char *)mapped + sizeof(checkpoint_header_st));
+    variables = (const checkpoint_variable_st *)(boundaries + header->current_scope + 1);
+    pool = (const char *)(variables + header->variable_count);
+    if (header->string_pool_size > 0 && pool[header->string_pool_size - 1] != '\0') {
+        fprintf(stderr, "%s: corrupted checkpoint file\n", file_path);
+        rc = EINVAL;
+        goto out;
+    }
+
+    // replay the declarations, open each scope when reaching its boundary.
+    scope = 0;
+    for (i = 0; i < header->variable_count; i++) {
+        while (scope < header->current_scope && (uint32_t)boundaries[scope + 1] == i) {
+            machine_memory_open_scope(machine_store);
+            scope++;
+        }
+        if (variables[i].scope != scope ||
+            variables[i].name_offset >= header->string_pool_size) {
+            fprintf(stderr, "%s: corrupted checkpoint file\n", file_path);
+            rc = EINVAL;
+            goto out;
+        }
+        machine_memory_set_variable(machine_store, (char *)pool + variables[i].name_offset,
+                                    variables[i].value, MEMORY_CURRENT_SCOPE);
+    }
+    while (scope < header->current_scope) {
+        machine_memory_open_scope(machine_store);
+        scope++;
+    }
+
+    instruction_set_set_pc(instructions, header->program_counter);
+    instruction_set_set_flag(instructions, header->flag_register);
+#ifdef DEBUG
+    fprintf(stderr, "restore: pc %d, scope %d, %u variables\n",
+                    header->program_counter, scope, header->variable_count);
+#endif
+
+out:
+    munmap(mapped, file_stat.st_size);
+    return rc;
+}
+
+/**
+ * @brief write the whole buffer into a file descriptor.
+ * @param fd a valid file descriptor.
+ * @param buffer data going to write.
+ * @param size size of the data.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_write_all(int fd, const char *buffer, size_t size) {
+    ssize_t written;
+
+    while (size > 0) {
+        written = write(fd, buffer, size);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return errno;
+        }
+        buffer += written;
+        size -= written;
+    }
+    return 0;
+}
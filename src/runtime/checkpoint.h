@@ -0,0 +1,34 @@
+/**
+ * @file checkpoint.h
+ * @brief Purpose: snapshot and restore the state of a running program.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __CHECKPOINT_H__
+#define __CHECKPOINT_H__
+
+#include "storage.h"
+#include "instruction.h"
+
+/**
+ * @brief write a snapshot of the virtual machine into a file.
+ *        The file is replaced atomically, a crash while writing keeps the old one.
+ * @param file_path path of the checkpoint file.
+ * @param instructions a valid instruction set object.
+ * @param machine_store a valid machine_store.
+ * @return 0 on success; otherwise errno.
+ */
+int checkpoint_save(const char *, instruction_set_st *, machine_memory_st *);
+
+/**
+ * @brief restore the virtual machine from a snapshot file.
+ *        The instruction set must hold the same program the snapshot taken from,
+ *        the machine_store must be freshly initialized.
+ * @param file_path path of the checkpoint file.
+ * @param instructions [in/out] a valid instruction set object.
+ * @param machine_store [in/out] a valid machine_store.
+ * @return 0 on success; otherwise errno.
+ */
+int checkpoint_restore(const char *, instruction_set_st *, machine_memory_st *);
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file inspect.c
+ * @brief Purpose: describe where a running program is, for a look at a long run
+ *        without stopping it.
+ *
+ * The report is plain text, one item per line:
+ *
+ *     inspect pid 1234
+ *     pc 19 CMP y _temp2
+ *     executed 123456
+ *     loop for1: at 4
+ *     loop for2: at 19
+ *     variable x 37 scope 1
+ *
+ * The loops are listed outermost first. Variables hidden by a variable of the
+ * same name in an inner scope are left out.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "inspect.h"
+
+/**
+ * @brief write the loops around an address, outermost first.
+ * @param fout output stream.
+ * @param instructions a valid instruction set object.
+ * @param pc the address.
+ */
+static void s_write_loops(FILE *, instruction_set_st *, int);
+
+/**
+ * @brief write the program counter, the loops around it, the instructions executed
+ *        so far and the visible variables.
+ * @param fout output stream.
+ * @param instructions a valid instruction set object.
+ * @param machine_store a valid machine_store.
+ * @param executed instructions executed so far.
+ * @return 0 on success; otherwise errno.
+ */
+int inspect_write(FILE *fout, instruction_set_st *instructions,
+                  machine_memory_st *machine_store, uint64_t executed) {
+    instruction_st *instruction;
+    memory_st *variable;
+    char *name;
+    int count;
+    int pc;
+    int i;
+
+    if (fout == NULL || instructions == NULL || machine_store == NULL)
+        return EINVAL;
+
+    pc = instruction_set_get_pc(instructions);
+    fprintf(fout, "inspect pid %d\n", (int)getpid());
+    instruction = instruction_set_get_address(instructions, pc);
+    fprintf(fout, "pc %d", pc);
+    if (instruction != NULL) {
+        fprintf(fout, " %s", instruction_get_op_code(instruction));
+        if (instruction_get_op_first(instruction) != NULL)
+            fprintf(fout, " %s", instruction_get_op_first(instruction));
+        if (instruction_get_op_second(instruction) != NULL)
+            fprintf(fout, " %s", instruction_get_op_second(instruction));
+    }
+    fprintf(fout, "\n");
+    fprintf(fout, "executed %" PRIu64 "\n", executed);
+
+    s_write_loops(fout, instructions, pc);
+
+    count = machine_memory_get_count(machine_store);
+    for (i = 0; i < count; i++) {
+        variable = machine_memory_get_address(machine_store, i);
+        name = memory_get_name(variable);
+        if (machine_memory_peek_variable(machine_store, name) != variable)
+            continue;
+        fprintf(fout, "variable %s %d scope %d\n", name, memory_get_value(variable),
+                memory_get_scope(variable));
+    }
+
+    if (fflush(fout) != 0)
+        return errno;
+    return 0;
+}
+
+/**
+ * @brief write the loops around an address, outermost first.
+ * @param fout output stream.
+ * @param instructions a valid instruction set object.
+ * @param pc the address.
+ */
+static void s_write_loops(FILE *fout, instruction_set_st *instructions, int pc) {
+    instruction_st *instruction;
+    int *loops;
+    int closed = 0;
+    int count = 0;
+    int address;
+    int i;
+
+    loops = (int *)malloc((pc + 1) * sizeof(int));
+    if (loops == NULL)
+        return;
+
+    // walk back to the start, skipping every scope closed before the address.
+    for (address = pc - 1; address >= 0; address--) {
+        instruction = instruction_set_get_address(instructions, address);
+        if (instruction_get_op_type(instruction) == OP_SCOPE_CLOSE) {
+            closed++;
+        } else if (instruction_get_op_type(instruction) == OP_SCOPE_OPEN) {
+            // "elseN:" is jumped over, it has no "_end:" of its own.
+            if (strncmp(instruction_get_op_code(instruction), "else", 4) == 0)
+                continue;
+            if (closed > 0)
+                closed--;
+            else if (strncmp(instruction_get_op_code(instruction), "for", 3) == 0)
+                loops[count++] = address;
+        }
+    }
+
+    for (i = count - 1; i >= 0; i--)
+        fprintf(fout, "loop %s at %d\n",
+                instruction_get_op_code(instruction_set_get_address(instructions, loops[i])),
+                loops[i]);
+    free(loops);
+}
@@ -0,0 +1,28 @@
+/**
+ * @file inspect.h
+ * @brief Purpose: describe where a running program is, for a look at a long run
+ *        without stopping it.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __INSPECT_H__
+#define __INSPECT_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "storage.h"
+#include "instruction.h"
+
+/**
+ * @brief write the program counter, the loops around it, the instructions executed
+ *        so far and the visible variables.
+ * @param fout output stream.
+ * @param instructions a valid instruction set object.
+ * @param machine_store a valid machine_store.
+ * @param executed instructions executed so far.
+ * @return 0 on success; otherwise errno.
+ */
+int inspect_write(FILE *, instruction_set_st *, machine_memory_st *, uint64_t);
+
+#endif
@@ -1,36 +1,77 @@
 /**
  * @file instruction.c
  * @brief Purpose: implemetation of the machine instruction.
+ *
+ * The program text is read into one buffer. A first pass indexes the offset
+ * of each line and collects the labels, then each line is decoded in place
+ * (tokens point into the buffer) either right away or, in lazy mode, the
+ * first time the program counter reaches it.
+ *
+ * Large programs are split into chunks at line boundaries. Both passes run
+ * on one thread per chunk, labels collected per chunk are merged in program
+ * order between them, so the result doesn't depend on the thread count.
  * @version 1.0
  * @date 04.23.2017
  * @author Xiangyu Guo
  */
 #include <stdio.h>
+#include <ctype.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "instruction.h"
 
-#define BUFFER_SIZE         (255)                   /**< input buffer size */
 #define DEFAULT_ARRAY_SIZE  (64)                    /**< dynamic array default size */
 #define RESIZE_FACTOR       (2)                     /**< resize factor when dynamic array is too small */
+#define FNV_OFFSET_BASIS    (14695981039346656037ULL) /**< FNV-1a 64 bits offset basis */
+#define FNV_PRIME           (1099511628211ULL)      /**< FNV-1a 64 bits prime */
+#define SEPARATORS          " \t\r\n"               /**< separators between tokens */
+#define MAX_LOAD_THREADS    (64)                    /**< upper bound of loading threads */
+#define MIN_CHUNK_SIZE      (1 << 20)               /**< smallest chunk worth a thread, in bytes */
 
 typedef struct label_info {
-    char *label_name;                               /**< label name without ":" */
+    const char *label_name;                         /**< label name without ":", not '\0' terminated */
+    int label_length;                               /**< length of the label name */
     unsigned int address;                           /**< the address of the label */
 } label_st;
 
 typedef struct label_table {
-    int label_table_capacity;                       /**< the capacity of label table */
+    int label_table_capacity;                       /**< the capacity of label table, power of 2 */
     int label_table_size;                           /**< the current size of label table */
-    label_st *label_table;                          /**< label table object */
+    label_st *label_table;                          /**< open addressing hash table */
 } label_table_st;
 
+typedef struct chunk_label {
+    const char *label_name;                         /**< label name without ":" */
+    int label_length;                               /**< length of the label name */
+    int address;                                    /**< address of the label, relative to chunk */
+} chunk_label_st;
+
+typedef struct load_chunk {
+    instruction_set_st *instructions;               /**< instruction set being loaded */
+    size_t begin;                                   /**< first byte of the chunk in text */
+    size_t end;                                     /**< one past the last byte of the chunk */
+    int mode;                                       /**< INSTRUCTION_LOAD_EAGER or INSTRUCTION_LOAD_LAZY */
+    int base;                                       /**< address of the first instruction */
+    size_t *line_offsets;                           /**< offset of each instruction in text */
+    int count;                                      /**< total of instructions in chunk */
+    int capacity;                                   /**< capacity of line_offsets */
+    chunk_label_st *labels;                         /**< labels in chunk, in program order */
+    int label_count;                                /**< total of labels in chunk */
+    int label_capacity;                             /**< capacity of labels */
+} load_chunk_st;
+
 struct instruction {
     char *op_code;                                  /**< operation code */
     char *op_first;                                 /**< first operands */
     char *op_second;                                /**< second operands */
+    int op_type;                                    /**< decoded operation code */
+    int target;                                     /**< resolved jump target */
+    int kinds[2];                                   /**< decoded kind of operands */
+    int values[2];                                  /**< decoded value of immediate operands */
+    int decoded;                                    /**< 1 after decoding */
 };
 
 struct instruction_set {
@@ -39,38 +80,126 @@ struct instruction_set {
     int count;                                      /**< total of instructions */
     int program_counter;                            /**< program counter(PC) */
     int flag_register;                              /**< flag register for cmp result */
+    uint64_t hash;                                  /**< identity of the program, 0 before computed */
+    char *text;                                     /**< program text, tokens point into it */
+    size_t *line_offsets;                           /**< offset of each instruction in text */
 };
 
+static const char *s_op_names[OP_COUNT] = { "DEC", "MOV", "OUT", "ADD", "SUB",
+                                            "MUL", "DIV", "MOD", "CMP", "JE",
+                                            "JNE", "JL", "JLE", "JG", "JGE",
+                                            "JMP", "LABEL", "LABEL_END" };
+
 /**
- * @brief load an ASM program into the runtime.
- * @param file_path ASM file path. 
- * @param instruct_set [out] loaded instruction sequence.
- * @return total count of instructions.
+ * @brief read the ASM program into memory.
+ * @param file_path ASM file path.
+ * @param size [out] size of the program text.
+ * @return program text, '\0' terminated.
+ */
+static char *s_read_program(const char *, size_t *);
+
+/**
+ * @brief index the offset of each instruction in a chunk and collect the labels.
+ *        Thread entry of the first pass.
+ * @param chunk [in/out] chunk going to index, load_chunk_st.
+ * @return NULL.
+ */
+static void *s_index_chunk(void *);
+
+/**
+ * @brief publish the offsets of a chunk and decode it in eager mode.
+ *        Thread entry of the second pass.
+ * @param chunk [in/out] indexed chunk, load_chunk_st.
+ * @return NULL.
  */
-static int s_load_program(const char *, instruction_set_st *);
+static void *s_decode_chunk(void *);
 
 /**
- * @brief replace label in ASM program into real address.
- * @param instruct_set [in/out] instructions going to replace.
- * @param labels [in] label table with real address.
+ * @brief run a pass on all chunks, one thread per chunk.
+ * @param chunks chunks going to process.
+ * @param count total of chunks.
+ * @param pass thread entry of the pass.
  */
-static void s_replace_label(instruction_set_st *, label_table_st *);
+static void s_run_pass(load_chunk_st *, int, void *(*)(void *));
 
 /**
- * @brief insert a label into label table.
+ * @brief decode one instruction into its fast form.
+ * @param instruct_set [in/out] instructions going to decode.
+ * @param address address of the instruction.
+ */
+static void s_decode(instruction_set_st *, int);
+
+/**
+ * @brief decode one operand.
+ * @param instruction [in/out] instruction going to decode.
+ * @param which OPERAND_FIRST or OPERAND_SECOND.
+ * @param operand text of the operand, can be NULL.
+ */
+static void s_decode_operand(instruction_st *, int, const char *);
+
+/**
+ * @brief insert a label into label table, the later one wins on duplicate.
  * @param label_table a valid label table.
- * @param label the label string.
+ * @param label the label string, without ":".
+ * @param length length of the label string.
  * @param addr the address of the label.
  */
-static void s_insert_label(label_table_st *, char *, unsigned int);
+static void s_insert_label(label_table_st *, const char *, int, unsigned int);
+
+/**
+ * @brief find a label in label table.
+ * @param label_table a valid label table.
+ * @param label the label string, without ":".
+ * @param length length of the label string.
+ * @return NULL if the label doesn't exist; otherwise the label.
+ */
+static label_st *s_find_label(label_table_st *, const char *, int);
+
+/**
+ * @brief hash all instructions, used as the identity of the program.
+ * @param instruct_set [in] loaded instruction sequence.
+ * @return hash value.
+ */
+static uint64_t s_hash_program(instruction_set_st *);
+
+/**
+ * @brief feed a string into FNV-1a hash.
+ * @param hash current hash value.
+ * @param str string going to hash, NULL is treated as an empty string.
+ * @return new hash value.
+ */
+static uint64_t s_hash_string(uint64_t, const char *);
+
+/**
+ * @brief FNV-1a hash of a sized string.
+ * @param str string going to hash.
+ * @param length length of the string.
+ * @return hash value.
+ */
+static uint64_t s_hash_bytes(const char *, int);
+
+/**
+ * @brief write a string as a C string literal.
+ * @param fout output stream.
+ * @param str string going to write, NULL is written as 0.
+ */
+static void s_emit_string(FILE *, const char *);
 
 /**
  * @brief load an ASM program into the runtime.
  * @param file_path path of asm file.
+ * @param mode INSTRUCTION_LOAD_EAGER or INSTRUCTION_LOAD_LAZY.
+ * @param threads most threads used for loading, 1 for loading on the caller.
  * @return instruct_set loaded instruction sequence.
  */
-instruction_set_st *instruction_load_program(const char *file_path) {
+instruction_set_st *instruction_load_program(const char *file_path, int mode, int threads) {
     instruction_set_st *instructions = NULL;
+    load_chunk_st *chunks = NULL;
+    chunk_label_st *label;
+    size_t size = 0;
+    size_t split;
+    int chunk_count;
+    int i, j;
 
     if (file_path == NULL)
         return NULL;
@@ -79,17 +208,115 @@ instruction_set_st *instruction_load_program(const char *file_path) {
     if (instructions == NULL)
         exit(ENOMEM);
 
-    instructions->instructs = (instruction_st *)malloc(DEFAULT_ARRAY_SIZE *
+    instructions->labels = (label_table_st *)malloc(sizeof(label_table_st));
+    if (instructions->labels == NULL)
+        exit(ENOMEM);
+
+    instructions->labels->label_table = (label_st *)calloc(DEFAULT_ARRAY_SIZE,
+                                                           sizeof(label_st));
+    if (instructions->labels->label_table == NULL)
+        exit(ENOMEM);
+
+    instructions->labels->label_table_capacity = DEFAULT_ARRAY_SIZE;
+
+    instructions->labels->label_table_size = 0;
+
+    instructions->program_counter = 0;
+
+    instructions->flag_register = 0;
+
+    instructions->hash = 0;
+
+    instructions->text = s_read_program(file_path, &size);
+
+    // small chunks cost more on threads than they save.
+    chunk_count = size / MIN_CHUNK_SIZE;
+    if (chunk_count > threads)
+        chunk_count = threads;
+    if (chunk_count > MAX_LOAD_THREADS)
+        chunk_count = MAX_LOAD_THREADS;
+    if (chunk_count < 1)
+        chunk_count = 1;
+
+    chunks = (load_chunk_st *)calloc(chunk_count, sizeof(load_chunk_st));
+    if (chunks == NULL)
+        exit(ENOMEM);
+
+    // split at line boundaries.
+    for (i = 0; i < chunk_count; i++) {
+        chunks[i].instructions = instructions;
+        chunks[i].mode = mode;
+        chunks[i].begin = (i == 0) ? 0 : chunks[i - 1].end;
+        split = size / chunk_count * (i + 1);
+        if (i == chunk_count - 1 || split <= chunks[i].begin) {
+            split = (i == chunk_count - 1) ? size : chunks[i].begin;
+        } else {
+            while (split < size && instructions->text[split - 1] != '\n')
+                split++;
+        }
+        chunks[i].end = split;
+    }
+
+    s_run_pass(chunks, chunk_count, s_index_chunk);
+
+    // merge labels in program order, the later one wins on duplicate.
+    instructions->count = 0;
+    for (i = 0; i < chunk_count; i++) {
+        chunks[i].base = instructions->count;
+        for (j = 0; j < chunks[i].label_count; j++) {
+            label = &(chunks[i].labels[j]);
+            s_insert_label(instructions->labels, label->label_name, label->label_length,
+                           chunks[i].base + label->address);
+        }
+        instructions->count += chunks[i].count;
+    }
+
+    instructions->line_offsets = (size_t *)malloc((instructions->count + 1) * sizeof(size_t));
+    if (instructions->line_offsets == NULL)
+        exit(ENOMEM);
+
+    instructions->instructs = (instruction_st *)calloc(instructions->count + 1,
                                                        sizeof(instruction_st));
     if (instructions->instructs == NULL)
         exit(ENOMEM);
 
+    // jump targets are resolved on decoding, the label table is read only now.
+    s_run_pass(chunks, chunk_count, s_decode_chunk);
+
+    for (i = 0; i < chunk_count; i++) {
+        free(chunks[i].line_offsets);
+        free(chunks[i].labels);
+    }
+    free(chunks);
+
+    return instructions;
+}
+
+/**
+ * @brief load a pre-decoded program image, nothing is parsed.
+ * @param image a valid program image.
+ * @return instruct_set loaded instruction sequence.
+ */
+instruction_set_st *instruction_load_image(const instruction_image_st *image) {
+    instruction_set_st *instructions = NULL;
+    const instruction_image_entry_st *entry;
+    instruction_st *instruction;
+    int i;
+
+    if (image == NULL)
+        return NULL;
+
+    instructions = (instruction_set_st *)calloc(1, sizeof(instruction_set_st));
+    if (instructions == NULL)
+        exit(ENOMEM);
+
     instructions->labels = (label_table_st *)malloc(sizeof(label_table_st));
     if (instructions->labels == NULL)
         exit(ENOMEM);
 
-    instructions->labels->label_table = (label_st *)malloc(DEFAULT_ARRAY_SIZE *
-                                                            sizeof(label_st));
+    // jump targets are resolved already, the label table stays empty.
+    instructions->labels->label_table = (label_st *)calloc(DEFAULT_ARRAY_SIZE,
+                                                           sizeof(label_st));
     if (instructions->labels->label_table == NULL)
         exit(ENOMEM);
 
@@ -97,17 +324,70 @@ instruction_set_st *instruction_load_program(const char *file_path) {
 
     instructions->labels->label_table_size = 0;
 
-    instructions->count = DEFAULT_ARRAY_SIZE;
+    instructions->count = image->count;
 
-    instructions->program_counter = 0;
+    instructions->instructs = (instruction_st *)calloc(image->count + 1,
+                                                       sizeof(instruction_st));
+    if (instructions->instructs == NULL)
+        exit(ENOMEM);
 
-    instructions->flag_register = 0;
+    // tokens stay in the read only image, decoded instructions never write them.
+    for (i = 0; i < image->count; i++) {
+        entry = &(image->entries[i]);
+        instruction = &(instructions->instructs[i]);
+        instruction->op_code = (char *)entry->op_code;
+        instruction->op_first = (char *)entry->op_first;
+        instruction->op_second = (char *)entry->op_second;
+        instruction->op_type = entry->op_type;
+        instruction->target = entry->target;
+        instruction->kinds[OPERAND_FIRST] = entry->kinds[OPERAND_FIRST];
+        instruction->kinds[OPERAND_SECOND] = entry->kinds[OPERAND_SECOND];
+        instruction->values[OPERAND_FIRST] = entry->values[OPERAND_FIRST];
+        instruction->values[OPERAND_SECOND] = entry->values[OPERAND_SECOND];
+        instruction->decoded = 1;
+    }
+
+    return instructions;
+}
+
+/**
+ * @brief write the decoded program as C source of an instruction_image_st.
+ * @param instruction_set a valid instruction_set object.
+ * @param fout output stream.
+ * @param symbol name of the image object.
+ * @return 0 on success; otherwise errno.
+ */
+int instruction_set_emit_c(instruction_set_st *instructions, FILE *fout, const char *symbol) {
+    instruction_st *instruction;
+    int i;
 
-    instructions->count = s_load_program(file_path, instructions);
+    if (instructions == NULL || fout == NULL || symbol == NULL)
+        return EINVAL;
 
-    s_replace_label(instructions, instructions->labels);
+    fprintf(fout, "/* generated by runtime --emit-c, do not edit. */\n");
+    fprintf(fout, "#include \"instruction.h\"\n\n");
+    fprintf(fout, "static const instruction_image_entry_st s_entries[] = {\n");
+    for (i = 0; i < instructions->count; i++) {
+        if (!instructions->instructs[i].decoded)
+            s_decode(instructions, i);
+        instruction = &(instructions->instructs[i]);
+        fprintf(fout, "    { %d, ", instruction->op_type);
+        s_emit_string(fout, instruction->op_code);
+        fprintf(fout, ", ");
+        s_emit_string(fout, instruction->op_first);
+        fprintf(fout, ", ");
+        s_emit_string(fout, instruction->op_second);
+        fprintf(fout, ", { %d, %d }, { %d, %d }, %d },\n",
+                      instruction->kinds[OPERAND_FIRST], instruction->kinds[OPERAND_SECOND],
+                      instruction->values[OPERAND_FIRST], instruction->values[OPERAND_SECOND],
+                      instruction->target);
+    }
+    // an empty array is not valid C.
+    fprintf(fout, "    { 0, 0, 0, 0, { 0, 0 }, { 0, 0 }, %d }\n};\n\n", INSTRUCTION_NO_TARGET);
+    fprintf(fout, "const instruction_image_st %s = { %d, s_entries };\n",
+                  symbol, instructions->count);
 
-    return instructions;
+    return ferror(fout) ? EIO : 0;
 }
 
 /**
@@ -115,21 +395,14 @@ instruction_set_st *instruction_load_program(const char *file_path) {
  * @param instructions, a valid instruction set object.
  */
 void instruction_clean_up(instruction_set_st *instructions) {
-    int i;
     if (instructions == NULL)
         return;
 
-    for (i = 0; i < instructions->count; i++) {
-        free(instructions->instructs[i].op_code);
-        free(instructions->instructs[i].op_first);
-        free(instructions->instructs[i].op_second);
-    }
-
     free(instructions->instructs);
 
-    for (i = 0; i < instructions->labels->label_table_size; i++) {
-        free(instructions->labels->label_table[i].label_name);
-    }
+    free(instructions->line_offsets);
+
+    free(instructions->text);
 
     free(instructions->labels->label_table);
 
@@ -150,7 +423,8 @@ instruction_st *instruction_set_get_instruction(instruction_set_st *instructions
         return NULL;
 
     // no more instructions.
-    if (instructions->program_counter >= instructions->count)
+    if (instructions->program_counter < 0 ||
+        instructions->program_counter >= instructions->count)
         return NULL;
 
     old_pc = instructions->program_counter;
@@ -158,9 +432,72 @@ instruction_st *instruction_set_get_instruction(instruction_set_st *instructions
 #ifdef DEBUG
     fprintf(stderr, "pc: %d\n", old_pc);
 #endif
+    if (!instructions->instructs[old_pc].decoded)
+        s_decode(instructions, old_pc);
+
     return &(instructions->instructs[old_pc]);
 }
 
+/**
+ * @brief get the total of instructions.
+ * @param instruction_set a valid instruction_set object.
+ * @return count of instructions.
+ */
+int instruction_set_get_count(instruction_set_st *instructions) {
+    if (instructions == NULL)
+        return 0;
+    return instructions->count;
+}
+
+/**
+ * @brief get the total of labels defined in the program.
+ * @param instruction_set a valid instruction_set object.
+ * @return count of labels, 0 for a program image.
+ */
+int instruction_set_get_label_count(instruction_set_st *instructions) {
+    if (instructions == NULL || instructions->labels == NULL)
+        return 0;
+    return instructions->labels->label_table_size;
+}
+
+/**
+ * @brief get the total of jumps resolved to a label so far,
+ *        instructions not decoded yet are not counted.
+ * @param instruction_set a valid instruction_set object.
+ * @return count of resolved jumps.
+ */
+int instruction_set_get_resolved_count(instruction_set_st *instructions) {
+    instruction_st *instruction;
+    int resolved = 0;
+    int i;
+
+    if (instructions == NULL)
+        return 0;
+
+    for (i = 0; i < instructions->count; i++) {
+        instruction = &(instructions->instructs[i]);
+        if (instruction->decoded && instruction->target != INSTRUCTION_NO_TARGET)
+            resolved++;
+    }
+    return resolved;
+}
+
+/**
+ * @brief get an instruction by its address, the program counter stays.
+ * @param instruction_set a valid instruction_set object.
+ * @param address address of the instruction, from 0 to count - 1.
+ * @return NULL on invalid address; otherwise a pointer to the instruction.
+ */
+instruction_st *instruction_set_get_address(instruction_set_st *instructions, int address) {
+    if (instructions == NULL || address < 0 || address >= instructions->count)
+        return NULL;
+
+    if (!instructions->instructs[address].decoded)
+        s_decode(instructions, address);
+
+    return &(instructions->instructs[address]);
+}
+
 /**
  * @brief set a new program counter
  * @param instruction_set a valid instruction_set object.
@@ -173,6 +510,31 @@ void instruction_set_set_pc(instruction_set_st *instructions, int new_pc) {
     instructions->program_counter = new_pc;
 }
 
+/**
+ * @brief get current program counter
+ * @param instruction_set a valid instruction_set object.
+ * @return program counter, address of the next instruction.
+ */
+int instruction_set_get_pc(instruction_set_st *instructions) {
+    if (instructions == NULL)
+        return 0;
+    return instructions->program_counter;
+}
+
+/**
+ * @brief get the identity of the loaded program
+ * @param instruction_set a valid instruction_set object.
+ * @return hash value over all instructions of the program.
+ */
+uint64_t instruction_set_get_hash(instruction_set_st *instructions) {
+    if (instructions == NULL)
+        return 0;
+    // computed on demand, it decodes every instruction.
+    if (instructions->hash == 0)
+        instructions->hash = s_hash_program(instructions);
+    return instructions->hash;
+}
+
 /**
  * @brief get the comparision result
  * @param instruction_set a valid instruction_set object.
@@ -203,23 +565,15 @@ void instruction_set_set_flag(instruction_set_st *instructions, int new_flag) {
  * @return a valid address for program counter, if label doesn't exist, exit.
  */
 unsigned int instruction_set_get_label(instruction_set_st *instructions, char *label) {
-    int i;
-    int label_len = 0;
-    char *converted_label = NULL;
+    label_st *found = NULL;
 
     if (instructions == NULL || label == NULL)
         exit(EINVAL);
 
-    label_len = strlen(label) + strlen(":") + 1;
+    found = s_find_label(instructions->labels, label, strlen(label));
+    if (found != NULL)
+        return found->address;
 
-    converted_label = (char *)malloc(label_len);
-    snprintf(converted_label, label_len, "%s:", label);
-    for (i = 0; i < instructions->labels->label_table_size; i++) {
-        if (strcmp(converted_label, instructions->labels->label_table[i].label_name) == 0) {
-            free(converted_label);
-            return instructions->labels->label_table[i].address;
-        }
-    }
     fprintf(stderr, "Invalid label.\n");
     exit(EPERM);
 }
@@ -259,20 +613,76 @@ char *instruction_get_op_second(instruction_st *instruction) {
 }
 
 /**
- * @brief load an ASM program into the runtime.
+ * @brief get decoded operation from an instruction.
+ * @param instruction, a valid instruction object.
+ * @return op_type, one of enum op_type.
+ */
+int instruction_get_op_type(instruction_st *instruction) {
+    if (instruction == NULL)
+        exit(EINVAL);
+    return instruction->op_type;
+}
+
+/**
+ * @brief get decoded kind of an operand.
+ * @param instruction, a valid instruction object.
+ * @param which, OPERAND_FIRST or OPERAND_SECOND.
+ * @return operand_kind, one of enum operand_kind.
+ */
+int instruction_get_operand_kind(instruction_st *instruction, int which) {
+    if (instruction == NULL || (which != OPERAND_FIRST && which != OPERAND_SECOND))
+        return OPERAND_NONE;
+    return instruction->kinds[which];
+}
+
+/**
+ * @brief get decoded value of an immediate operand.
+ * @param instruction, a valid instruction object.
+ * @param which, OPERAND_FIRST or OPERAND_SECOND.
+ * @return value of the operand, 0 if it is not an immediate.
+ */
+int instruction_get_operand_value(instruction_st *instruction, int which) {
+    if (instruction == NULL || (which != OPERAND_FIRST && which != OPERAND_SECOND))
+        return 0;
+    return instruction->values[which];
+}
+
+/**
+ * @brief get resolved jump target of an instruction.
+ * @param instruction, a valid instruction object.
+ * @return address of the target, INSTRUCTION_NO_TARGET if the label doesn't exist.
+ */
+int instruction_get_target(instruction_st *instruction) {
+    if (instruction == NULL)
+        return INSTRUCTION_NO_TARGET;
+    return instruction->target;
+}
+
+/**
+ * @brief get the name of an operation.
+ * @param op_type one of enum op_type.
+ * @return name of the operation, e.g. "MOV".
+ */
+const char *instruction_op_name(int op_type) {
+    if (op_type < 0 || op_type >= OP_COUNT)
+        return "UNKNOWN";
+    return s_op_names[op_type];
+}
+
+/**
+ * @brief read the ASM program into memory.
  * @param file_path ASM file path.
- * @param instruct_set [out] loaded instruction sequence.
- * @return total count of instructions.
+ * @param size [out] size of the program text.
+ * @return program text, '\0' terminated.
  */
-static int s_load_program(const char *file_path, instruction_set_st *instructions) {
+static char *s_read_program(const char *file_path, size_t *size) {
     FILE *fin = NULL;
-    char input_buff[BUFFER_SIZE];
-    char *op_code;
-    char *op_first;
-    char *op_second;
-    int count = 0;
+    char *text = NULL;
+    size_t capacity = 0;
+    size_t length = 0;
+    size_t got = 0;
 
-    if (file_path == NULL || instructions == NULL)
+    if (file_path == NULL || size == NULL)
         exit(EINVAL);
 
     fin = fopen(file_path, "r");
@@ -281,109 +691,387 @@ static int s_load_program(const char *file_path, instruction_set_st *instruction
         exit(ENOENT);
     }
 
-    while (fgets(input_buff, BUFFER_SIZE, fin)) {
-#ifdef DEBUG
-        fprintf(stderr, "line: %d, content: %s\n", count, input_buff);
-#endif
-        if (count >= instructions->count) {
-            instructions->instructs = realloc(instructions->instructs,
-                                              instructions->count * RESIZE_FACTOR);
+    if (fseek(fin, 0, SEEK_END) == 0 && ftell(fin) > 0) {
+        capacity = ftell(fin) + 1;
+        rewind(fin);
+    } else {
+        capacity = BUFSIZ;
+        rewind(fin);
+    }
 
-            if (instructions->instructs == NULL)
-                exit(ENOMEM);
+    text = (char *)malloc(capacity);
+    if (text == NULL)
+        exit(ENOMEM);
 
-            instructions->count *= RESIZE_FACTOR;
+    while ((got = fread(text + length, 1, capacity - length - 1, fin)) > 0) {
+        length += got;
+        if (length + 1 >= capacity) {
+            text = (char *)realloc(text, capacity * RESIZE_FACTOR);
+            if (text == NULL)
+                exit(ENOMEM);
+            capacity *= RESIZE_FACTOR;
         }
+    }
+    fclose(fin);
 
-        // spilit by ' ', get first op code or label.
-        op_code = strtok(input_buff, " \t\r\n");
+    text[length] = '\0';
+    *size = length;
+    return text;
+}
+
+/**
+ * @brief index the offset of each instruction in a chunk and collect the labels.
+ *        Thread entry of the first pass.
+ * @param chunk [in/out] chunk going to index, load_chunk_st.
+ * @return NULL.
+ */
+static void *s_index_chunk(void *arg) {
+    load_chunk_st *chunk = (load_chunk_st *)arg;
+    const char *text = chunk->instructions->text;
+    const char *end = text + chunk->end;
+    const char *line = text + chunk->begin;
+    const char *token;
+    const char *next_line;
+    int length;
+
+    chunk->capacity = DEFAULT_ARRAY_SIZE;
+    chunk->line_offsets = (size_t *)malloc(chunk->capacity * sizeof(size_t));
+    if (chunk->line_offsets == NULL)
+        exit(ENOMEM);
+
+    while (line < end) {
+        next_line = memchr(line, '\n', end - line);
+        next_line = (next_line == NULL) ? end : next_line + 1;
 
         // skip empty lines
-        if (op_code == NULL)
+        token = line;
+        while (token < next_line && strchr(SEPARATORS, *token) != NULL && *token != '\0')
+            token++;
+        if (token == next_line) {
+            line = next_line;
             continue;
+        }
 
-        // check op_code is label and put into label table with count(address).
-        if (strrchr(op_code, ':') != NULL) {
-#ifdef DEBUG
-            fprintf(stderr, "label: %s\n", op_code);
-#endif
-            s_insert_label(instructions->labels, op_code, count);
+        if (chunk->count >= chunk->capacity) {
+            chunk->line_offsets = (size_t *)realloc(chunk->line_offsets,
+                                    chunk->capacity * RESIZE_FACTOR * sizeof(size_t));
+            if (chunk->line_offsets == NULL)
+                exit(ENOMEM);
+            chunk->capacity *= RESIZE_FACTOR;
         }
-        // spilit by ' ', get first oprand and second oprand.
-        op_first = strtok(NULL, " \t\r\n");
-        op_second = strtok(NULL, " \t\r\n");
+        chunk->line_offsets[chunk->count] = token - text;
 
+        // check op_code is label and keep it with count(address).
+        length = strcspn(token, SEPARATORS);
+        if (length > 1 && token[length - 1] == ':') {
 #ifdef DEBUG
-        fprintf(stderr, "code: %s, first %s, second %s\n", op_code, op_first, op_second );
+            fprintf(stderr, "label: %.*s\n", length, token);
 #endif
-        instructions->instructs[count].op_code = strdup(op_code);
-        if (op_first != NULL)
-            instructions->instructs[count].op_first = strdup(op_first);
-        else
-            instructions->instructs[count].op_first = NULL;
-        if (op_second != NULL)
-            instructions->instructs[count].op_second = strdup(op_second);
-        else
-            instructions->instructs[count].op_second = NULL;
-        count++;
+            if (chunk->label_count >= chunk->label_capacity) {
+                chunk->label_capacity = chunk->label_capacity ?
+                                        chunk->label_capacity * RESIZE_FACTOR :
+                                        DEFAULT_ARRAY_SIZE;
+                chunk->labels = (chunk_label_st *)realloc(chunk->labels,
+                                    chunk->label_capacity * sizeof(chunk_label_st));
+                if (chunk->labels == NULL)
+                    exit(ENOMEM);
+            }
+            chunk->labels[chunk->label_count].label_name = token;
+            chunk->labels[chunk->label_count].label_length = length - 1;
+            // jump to the label skips the scope opening, but not the closing.
+            if (length >= 5 && memcmp(token + length - 5, "_end:", 5) == 0)
+                chunk->labels[chunk->label_count].address = chunk->count;
+            else
+                chunk->labels[chunk->label_count].address = chunk->count + 1;
+            chunk->label_count++;
+        }
+        chunk->count++;
+        line = next_line;
     }
-    fclose(fin);
 
-    return count;
+    return NULL;
 }
 
 /**
- * @brief replace label in ASM program into real address.
- * @param instruct_set [in/out] instructions going to replace.
- * @param labels [in] label table with real address.
+ * @brief publish the offsets of a chunk and decode it in eager mode.
+ *        Thread entry of the second pass.
+ * @param chunk [in/out] indexed chunk, load_chunk_st.
+ * @return NULL.
  */
-static void s_replace_label(instruction_set_st *instructions, label_table_st *labels) {
-    int i, j;
-    char *label;
+static void *s_decode_chunk(void *arg) {
+    load_chunk_st *chunk = (load_chunk_st *)arg;
+    int i;
 
-    if (instructions == NULL || labels == NULL)
-        exit(EINVAL);
+    if (chunk->count > 0)
+        memcpy(chunk->instructions->line_offsets + chunk->base, chunk->line_offsets,
+               chunk->count * sizeof(size_t));
 
-    for (i = 0; i < instructions->count; i++) {
-        label = instructions->instructs[i].op_code;
-        if (strrchr(label, ':')) {
-            for (j = 0; j < labels->label_table_size; j++) {
-                if (strcmp(label, labels->label_table[j].label_name) == 0) {
-                    labels->label_table[j].address = i;
-                    if (strstr(label, "_end:") == NULL) {
-                        labels->label_table[j].address = i + 1;
-                    }
-                }
-            }
+    if (chunk->mode != INSTRUCTION_LOAD_LAZY) {
+        for (i = 0; i < chunk->count; i++)
+            s_decode(chunk->instructions, chunk->base + i);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief run a pass on all chunks, one thread per chunk.
+ * @param chunks chunks going to process.
+ * @param count total of chunks.
+ * @param pass thread entry of the pass.
+ */
+static void s_run_pass(load_chunk_st *chunks, int count, void *(*pass)(void *)) {
+    pthread_t workers[MAX_LOAD_THREADS];
+    int i;
+
+    // the first chunk runs on the caller.
+    for (i = 1; i < count; i++) {
+        if (pthread_create(&workers[i], NULL, pass, &chunks[i]) != 0) {
+            fprintf(stderr, "Can't create loading thread.\n");
+            exit(EAGAIN);
+        }
+    }
+
+    pass(&chunks[0]);
+
+    for (i = 1; i < count; i++)
+        pthread_join(workers[i], NULL);
+}
+
+/**
+ * @brief decode one instruction into its fast form.
+ * @param instruct_set [in/out] instructions going to decode.
+ * @param address address of the instruction.
+ */
+static void s_decode(instruction_set_st *instructions, int address) {
+    instruction_st *instruction = &(instructions->instructs[address]);
+    char *cursor = instructions->text + instructions->line_offsets[address];
+    char *tokens[3] = { NULL, NULL, NULL };
+    label_st *label = NULL;
+    int i;
+
+    // split by ' ', get op code or label, first oprand and second oprand.
+    for (i = 0; i < 3; i++) {
+        while (*cursor != '\n' && *cursor != '\0' && strchr(SEPARATORS, *cursor) != NULL)
+            cursor++;
+        if (*cursor == '\n' || *cursor == '\0')
+            break;
+        tokens[i] = cursor;
+        cursor += strcspn(cursor, SEPARATORS);
+        if (*cursor == '\n' || *cursor == '\0') {
+            *cursor = '\0';
+            break;
         }
+        *cursor++ = '\0';
+    }
+#ifdef DEBUG
+    fprintf(stderr, "code: %s, first %s, second %s\n", tokens[0], tokens[1], tokens[2]);
+#endif
+    instruction->op_code = tokens[0];
+    instruction->op_first = tokens[1];
+    instruction->op_second = tokens[2];
+    instruction->target = INSTRUCTION_NO_TARGET;
+
+    for (i = 0; i < OP_SCOPE_OPEN; i++) {
+        if (strcmp(instruction->op_code, s_op_names[i]) == 0)
+            break;
+    }
+
+    if (i == OP_SCOPE_OPEN) {
+        // label change scope.(for1: scope++, for1_end: scope--)
+        if (strstr(instruction->op_code, "_end:"))
+            i = OP_SCOPE_CLOSE;
+        instruction->op_type = i;
+        instruction->kinds[OPERAND_FIRST] = OPERAND_NONE;
+        instruction->kinds[OPERAND_SECOND] = OPERAND_NONE;
+    } else {
+        instruction->op_type = i;
+        s_decode_operand(instruction, OPERAND_FIRST, instruction->op_first);
+        s_decode_operand(instruction, OPERAND_SECOND, instruction->op_second);
+    }
+
+    if (i >= OP_JE && i <= OP_JMP && instruction->op_first != NULL) {
+        label = s_find_label(instructions->labels, instruction->op_first,
+                             strlen(instruction->op_first));
+        if (label != NULL)
+            instruction->target = label->address;
     }
+
+    instruction->decoded = 1;
 }
 
 /**
- * @brief insert a label into label table.
+ * @brief decode one operand.
+ * @param instruction [in/out] instruction going to decode.
+ * @param which OPERAND_FIRST or OPERAND_SECOND.
+ * @param operand text of the operand, can be NULL.
+ */
+static void s_decode_operand(instruction_st *instruction, int which, const char *operand) {
+    instruction->values[which] = 0;
+    if (operand == NULL) {
+        instruction->kinds[which] = OPERAND_NONE;
+    } else if (isalpha(operand[0]) || operand[0] == '_') {
+        instruction->kinds[which] = OPERAND_VARIABLE;
+    } else {
+        instruction->kinds[which] = OPERAND_IMMEDIATE;
+        instruction->values[which] = atoi(operand);
+    }
+}
+
+/**
+ * @brief insert a label into label table, the later one wins on duplicate.
  * @param label_table a valid label table.
- * @param label_str the label string.
+ * @param label the label string, without ":".
+ * @param length length of the label string.
  * @param addr the address of the label.
  */
-static void s_insert_label(label_table_st *labels, char *label, unsigned int addr) {
+static void s_insert_label(label_table_st *labels, const char *label,
+                           int length, unsigned int addr) {
+    label_st *old_table;
+    label_st *found;
+    int old_capacity;
     int index;
+    int i;
+
     if (labels == NULL || label == NULL)
         return;
 
-    index = labels->label_table_size;
-    if (index >= labels->label_table_capacity) {
-        labels->label_table = realloc(labels->label_table, 
-                                      labels->label_table_capacity * RESIZE_FACTOR);
+    found = s_find_label(labels, label, length);
+    if (found != NULL) {
+        found->address = addr;
+        return;
+    }
+
+    // keep load factor under 1/2.
+    if ((labels->label_table_size + 1) * RESIZE_FACTOR > labels->label_table_capacity) {
+        old_table = labels->label_table;
+        old_capacity = labels->label_table_capacity;
 
+        labels->label_table = (label_st *)calloc(old_capacity * RESIZE_FACTOR,
+                                                 sizeof(label_st));
         if (labels->label_table == NULL)
             exit(ENOMEM);
 
-        labels->label_table_capacity *= RESIZE_FACTOR;
+        labels->label_table_capacity = old_capacity * RESIZE_FACTOR;
+        labels->label_table_size = 0;
+
+        for (i = 0; i < old_capacity; i++) {
+            if (old_table[i].label_name != NULL)
+                s_insert_label(labels, old_table[i].label_name,
+                               old_table[i].label_length, old_table[i].address);
+        }
+        free(old_table);
     }
 
-    labels->label_table[index].label_name = strdup(label);
+    index = s_hash_bytes(label, length) & (labels->label_table_capacity - 1);
+    while (labels->label_table[index].label_name != NULL)
+        index = (index + 1) & (labels->label_table_capacity - 1);
+
+    labels->label_table[index].label_name = label;
+
+    labels->label_table[index].label_length = length;
 
     labels->label_table[index].address = addr;
 
     labels->label_table_size++;
 }
+
+/**
+ * @brief find a label in label table.
+ * @param label_table a valid label table.
+ * @param label the label string, without ":".
+ * @param length length of the label string.
+ * @return NULL if the label doesn't exist; otherwise the label.
+ */
+static label_st *s_find_label(label_table_st *labels, const char *label, int length) {
+    label_st *entry;
+    int index;
+
+    index = s_hash_bytes(label, length) & (labels->label_table_capacity - 1);
+    while ((entry = &(labels->label_table[index]))->label_name != NULL) {
+        if (entry->label_length == length && memcmp(entry->label_name, label, length) == 0)
+            return entry;
+        index = (index + 1) & (labels->label_table_capacity - 1);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief hash all instructions, used as the identity of the program.
+ * @param instruct_set [in] loaded instruction sequence.
+ * @return hash value.
+ */
+static uint64_t s_hash_program(instruction_set_st *instructions) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    int i;
+
+    for (i = 0; i < instructions->count; i++) {
+        if (!instructions->instructs[i].decoded)
+            s_decode(instructions, i);
+        hash = s_hash_string(hash, instructions->instructs[i].op_code);
+        hash = s_hash_string(hash, instructions->instructs[i].op_first);
+        hash = s_hash_string(hash, instructions->instructs[i].op_second);
+    }
+
+    // 0 means not computed yet.
+    return hash ? hash : 1;
+}
+
+/**
+ * @brief feed a string into FNV-1a hash.
+ * @param hash current hash value.
+ * @param str string going to hash, NULL is treated as an empty string.
+ * @return new hash value.
+ */
+static uint64_t s_hash_string(uint64_t hash, const char *str) {
+    if (str != NULL) {
+        while (*str) {
+            hash ^= (unsigned char)*str++;
+            hash *= FNV_PRIME;
+        }
+    }
+    // terminator keeps "AB" "C" and "A" "BC" apart.
+    hash ^= 0xff;
+    hash *= FNV_PRIME;
+    return hash;
+}
+
+/**
+ * @brief FNV-1a hash of a sized string.
+ * @param str string going to hash.
+ * @param length length of the string.
+ * @return hash value.
+ */
+static uint64_t s_hash_bytes(const char *str, int length) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    while (length-- > 0) {
+        hash ^= (unsigned char)*str++;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * @brief write a string as a C string literal.
+ * @param fout output stream.
+ * @param str string going to write, NULL is written as 0.
+ */
+static void s_emit_string(FILE *fout, const char *str) {
+    if (str == NULL) {
+        fputc('0', fout);
+        return;
+    }
+
+    fputc('"', fout);
+    for ( ; *str; str++) {
+        if (*str == '"' || *str == '\\')
+            fputc('\\', fout);
+        if (isprint((unsigned char)*str) || *str == '"' || *str == '\\')
+            fputc(*str, fout);
+        else
+            fprintf(fout, "\\%03o", (unsigned char)*str);
+    }
+    fputc('"', fout);
+}
@@ -0,0 +1,404 @@
+/**
+ * @file ngram.c
+ * @brief Purpose: count the dynamic sequences of operations, with and without
+ *        the kinds of their operands, to guide the design of the instruction set.
+ *
+ * Every dispatched instruction is a 9-bit symbol: its operation in the low
+ * SYMBOL_OP_BITS bits, the kinds of its two operands above. The last symbols
+ * are kept in a shift register, and each dispatch ends one sequence of every
+ * length from NGRAM_MIN_LENGTH to NGRAM_MAX_LENGTH. A sequence is counted
+ * twice, by operations only and by operations with operand kinds, into one
+ * open addressing table keyed by the packed sequence.
+ *
+ * The counts file adds up over runs, so the report covers a set of programs:
+ *
+ *     ten-ngrams 1
+ *     dispatches <dispatches>
+ *     programs <programs>
+ *     <key in hex> <count>            one line per sequence
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "ngram.h"
+
+#define NGRAM_MAGIC             "ten-ngrams 1"      /**< first line of the counts file */
+#define SYMBOL_BITS             (9)                 /**< bits of a symbol */
+#define SYMBOL_OP_BITS          (5)                 /**< bits of the operation in a symbol */
+#define KEY_KINDS               (1ULL << 63)        /**< set in keys with operand kinds */
+#define KEY_LENGTH_SHIFT        (56)                /**< the length is stored above the sequence */
+#define DEFAULT_TABLE_SIZE      (1024)              /**< slots of the table at first, a power of 2 */
+#define RESIZE_FACTOR           (2)                 /**< resize factor when the table is half full */
+#define SYMBOL_NAME_SIZE        (32)                /**< longest name of a symbol */
+
+#define KEY(kinds, length, sequence) \
+    (((kinds) ? KEY_KINDS : 0) | ((uint64_t)(length) << KEY_LENGTH_SHIFT) | (sequence))
+#define KEY_LENGTH(key)         ((int)(((key) >> KEY_LENGTH_SHIFT) & 0x7F))
+
+struct ngram {
+    uint64_t *keys;                                 /**< packed sequences, 0 for an empty slot */
+    uint64_t *counts;                               /**< dispatches of each sequence */
+    size_t capacity;                                /**< slots of the table */
+    size_t used;                                    /**< slots in use */
+    uint64_t history;                               /**< last symbols, the newest in the low bits */
+    int seen;                                       /**< symbols in the history, up to NGRAM_MAX_LENGTH - 1 */
+    uint64_t op_masks[NGRAM_MAX_LENGTH + 1];        /**< keeps the operations of a sequence, by length */
+    uint64_t dispatches;                            /**< instructions dispatched */
+    uint64_t programs;                              /**< runs counted */
+};
+
+/**
+ * @brief add to the count of a sequence, the table grows when half full.
+ * @param ngram [in/out] a valid n-gram object.
+ * @param key the packed sequence.
+ * @param count dispatches to add.
+ */
+static void s_add(ngram_st *, uint64_t, uint64_t);
+
+/**
+ * @brief read an earlier counts file and add it up.
+ * @param ngram [in/out] a valid n-gram object.
+ * @param path path of the counts file.
+ * @return 0 on success or if it doesn't exist; otherwise errno, EBADMSG if not ours.
+ */
+static int s_merge(ngram_st *, const char *);
+
+/**
+ * @brief write the counts file.
+ * @param fout output stream.
+ * @param ngram a valid n-gram object.
+ */
+static void s_write_counts(FILE *, ngram_st *);
+
+/**
+ * @brief write the top sequences of one table of the report.
+ * @param fout output stream.
+ * @param ngram a valid n-gram object.
+ * @param kinds 1 for the sequences with operand kinds; otherwise 0.
+ * @param top sequences listed.
+ */
+static void s_write_top(FILE *, ngram_st *, int, int);
+
+/**
+ * @brief order slots by dispatches a fused instruction saves, descending, used by qsort.
+ * @return <0, 0 or >0.
+ */
+static int s_compare_saves(const void *, const void *);
+
+/**
+ * @brief initialize an empty n-gram counter.
+ * @return a valid n-gram object.
+ */
+ngram_st *ngram_init() {
+    ngram_st *ngram;
+    uint64_t op_mask = (1ULL << SYMBOL_OP_BITS) - 1;
+    int length;
+
+    ngram = (ngram_st *)calloc(1, sizeof(ngram_st));
+    if (ngram == NULL)
+        exit(ENOMEM);
+
+    ngram->capacity = DEFAULT_TABLE_SIZE;
+    ngram->keys = (uint64_t *)calloc(ngram->capacity, sizeof(uint64_t));
+    ngram->counts = (uint64_t *)calloc(ngram->capacity, sizeof(uint64_t));
+    if (ngram->keys == NULL || ngram->counts == NULL)
+        exit(ENOMEM);
+
+    for (length = 1; length <= NGRAM_MAX_LENGTH; length++)
+        ngram->op_masks[length] = (ngram->op_masks[length - 1] << SYMBOL_BITS) | op_mask;
+    ngram->programs = 1;
+
+    return ngram;
+}
+
+/**
+ * @brief clean up the n-gram object.
+ * @param ngram a valid n-gram object.
+ */
+void ngram_fini(ngram_st *ngram) {
+    if (ngram == NULL)
+        return;
+
+    free(ngram->keys);
+    free(ngram->counts);
+    free(ngram);
+}
+
+/**
+ * @brief count one dispatched instruction, as the end of every sequence leading to it.
+ * @param ngram a valid n-gram object.
+ * @param instruction the dispatched instruction.
+ */
+void ngram_count(ngram_st *ngram, instruction_st *instruction) {
+    uint64_t symbol;
+    uint64_t sequence;
+    uint64_t masked;
+    int op_type;
+    int length;
+
+    op_type = instruction_get_op_type(instruction);
+    symbol = op_type;
+    // the target of a jump is always a label, its kind tells nothing.
+    if (op_type < OP_JE || op_type > OP_JMP)
+        symbol |= instruction_get_operand_kind(instruction, OPERAND_FIRST) << SYMBOL_OP_BITS |
+                  instruction_get_operand_kind(instruction, OPERAND_SECOND) << (SYMBOL_OP_BITS + 2);
+    sequence = (ngram->history << SYMBOL_BITS) | symbol;
+
+    for (length = NGRAM_MIN_LENGTH; length <= ngram->seen + 1 && length <= NGRAM_MAX_LENGTH; length++) {
+        masked = sequence & ((1ULL << (length * SYMBOL_BITS)) - 1);
+        s_add(ngram, KEY(1, length, masked), 1);
+        s_add(ngram, KEY(0, length, masked & ngram->op_masks[length]), 1);
+    }
+
+    ngram->history = sequence & ((1ULL << ((NGRAM_MAX_LENGTH - 1) * SYMBOL_BITS)) - 1);
+    if (ngram->seen < NGRAM_MAX_LENGTH - 1)
+        ngram->seen++;
+    ngram->dispatches++;
+}
+
+/**
+ * @brief add the counts into "<prefix>.counts", so the counts of several programs
+ *        add up, then write the top sequences of all of them into "<prefix>.report".
+ * @param ngram a valid n-gram object.
+ * @param prefix prefix of the output files.
+ * @param top sequences listed per table.
+ * @return 0 on success; otherwise errno, EBADMSG if the counts file is not ours.
+ */
+int ngram_write(ngram_st *ngram, const char *prefix, int top) {
+    FILE *fout;
+    char *path;
+    size_t path_len;
+    int rc = 0;
+
+    if (ngram == NULL || prefix == NULL)
+        return EINVAL;
+
+    path_len = strlen(prefix) + strlen(".counts") + 1;
+    path = (char *)malloc(path_len);
+    if (path == NULL)
+        return ENOMEM;
+
+    snprintf(path, path_len, "%s.counts", prefix);
+    rc = s_merge(ngram, path);
+    if (rc != 0) {
+        free(path);
+        return rc;
+    }
+    fout = fopen(path, "w");
+    if (fout == NULL) {
+        rc = errno;
+        free(path);
+        return rc;
+    }
+    s_write_counts(fout, ngram);
+    if (fclose(fout) != 0)
+        rc = errno;
+
+    snprintf(path, path_len, "%s.report", prefix);
+    fout = fopen(path, "w");
+    if (fout == NULL) {
+        rc = errno;
+        free(path);
+        return rc;
+    }
+    fprintf(fout, "%" PRIu64 " dispatches in %" PRIu64 " program runs\n",
+                  ngram->dispatches, ngram->programs);
+    fprintf(fout, "covers: share of the dispatches inside the sequence\n");
+    fprintf(fout, "saves:  share of the dispatches gone if the sequence were one instruction,\n");
+    fprintf(fout, "        sequences overlap, so the shares of different rows don't add up\n");
+    s_write_top(fout, ngram, 0, top);
+    s_write_top(fout, ngram, 1, top);
+    if (fclose(fout) != 0 && rc == 0)
+        rc = errno;
+
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief add to the count of a sequence, the table grows when half full.
+ * @param ngram [in/out] a valid n-gram object.
+ * @param key the packed sequence.
+ * @param count dispatches to add.
+ */
+static void s_add(ngram_st *ngram, uint64_t key, uint64_t count) {
+    uint64_t *old_keys;
+    uint64_t *old_counts;
+    size_t old_capacity;
+    size_t mask;
+    size_t slot;
+    size_t i;
+
+    mask = ngram->capacity - 1;
+    slot = (key * 0x9E3779B97F4A7C15ULL >> 32) & mask;
+    while (ngram->keys[slot] != 0 && ngram->keys[slot] != key)
+        slot = (slot + 1) & mask;
+
+    if (ngram->keys[slot] == key) {
+        ngram->counts[slot] += count;
+        return;
+    }
+
+    ngram->keys[slot] = key;
+    ngram->counts[slot] = count;
+    ngram->used++;
+    if (ngram->used * 2 < ngram->capacity)
+        return;
+
+    old_keys = ngram->keys;
+    old_counts = ngram->counts;
+    old_capacity = ngram->capacity;
+
+    ngram->capacity *= RESIZE_FACTOR;
+    ngram->keys = (uint64_t *)calloc(ngram->capacity, sizeof(uint64_t));
+    ngram->counts = (uint64_t *)calloc(ngram->capacity, sizeof(uint64_t));
+    if (ngram->keys == NULL || ngram->counts == NULL)
+        exit(ENOMEM);
+    ngram->used = 0;
+
+    for (i = 0; i < old_capacity; i++) {
+        if (old_keys[i] != 0)
+            s_add(ngram, old_keys[i], old_counts[i]);
+    }
+    free(old_keys);
+    free(old_counts);
+}
+
+/**
+ * @brief read an earlier counts file and add it up.
+ * @param ngram [in/out] a valid n-gram object.
+ * @param path path of the counts file.
+ * @return 0 on success or if it doesn't exist; otherwise errno, EBADMSG if not ours.
+ */
+static int s_merge(ngram_st *ngram, const char *path) {
+    char magic[sizeof(NGRAM_MAGIC) + 1];
+    uint64_t dispatches;
+    uint64_t programs;
+    uint64_t key;
+    uint64_t count;
+    FILE *fin;
+    int rc = 0;
+
+    fin = fopen(path, "r");
+    if (fin == NULL)
+        return errno == ENOENT ? 0 : errno;
+
+    if (fgets(magic, sizeof(magic), fin) == NULL ||
+        strncmp(magic, NGRAM_MAGIC "\n", sizeof(magic)) != 0 ||
+        fscanf(fin, "dispatches %" SCNu64 " programs %" SCNu64, &dispatches, &programs) != 2) {
+        fclose(fin);
+        return EBADMSG;
+    }
+
+    while ((rc = fscanf(fin, "%" SCNx64 " %" SCNu64, &key, &count)) == 2) {
+        if (KEY_LENGTH(key) < NGRAM_MIN_LENGTH || KEY_LENGTH(key) > NGRAM_MAX_LENGTH)
+            break;
+        s_add(ngram, key, count);
+    }
+    fclose(fin);
+    if (rc != EOF)
+        return EBADMSG;
+
+    ngram->dispatches += dispatches;
+    ngram->programs += programs;
+    return 0;
+}
+
+/**
+ * @brief write the counts file.
+ * @param fout output stream.
+ * @param ngram a valid n-gram object.
+ */
+static void s_write_counts(FILE *fout, ngram_st *ngram) {
+    size_t i;
+
+    fprintf(fout, "%s\n", NGRAM_MAGIC);
+    fprintf(fout, "dispatches %" PRIu64 "\n", ngram->dispatches);
+    fprintf(fout, "programs %" PRIu64 "\n", ngram->programs);
+    for (i = 0; i < ngram->capacity; i++) {
+        if (ngram->keys[i] != 0)
+            fprintf(fout, "%" PRIx64 " %" PRIu64 "\n", ngram->keys[i], ngram->counts[i]);
+    }
+}
+
+/**
+ * @brief write the top sequences of one table of the report.
+ * @param fout output stream.
+ * @param ngram a valid n-gram object.
+ * @param kinds 1 for the sequences with operand kinds; otherwise 0.
+ * @param top sequences listed.
+ */
+static void s_write_top(FILE *fout, ngram_st *ngram, int kinds, int top) {
+    static const char *kind_names[] = { "", "var", "imm" };
+    char name[SYMBOL_NAME_SIZE];
+    uint64_t *order;
+    uint64_t symbol;
+    size_t count = 0;
+    size_t i;
+    int length;
+    int j;
+
+    order = (uint64_t *)malloc(ngram->used * 2 * sizeof(uint64_t));
+    if (order == NULL)
+        exit(ENOMEM);
+
+    // pairs of key and count, sorted together.
+    for (i = 0; i < ngram->capacity; i++) {
+        if (ngram->keys[i] != 0 && ((ngram->keys[i] & KEY_KINDS) != 0) == kinds) {
+            order[count * 2] = ngram->keys[i];
+            order[count * 2 + 1] = ngram->counts[i];
+            count++;
+        }
+    }
+    qsort(order, count, 2 * sizeof(uint64_t), s_compare_saves);
+
+    fprintf(fout, "\ntop %d %s, by dispatches saved\n", top,
+                  kinds ? "sequences with operand kinds" : "operation sequences");
+    fprintf(fout, "%5s %6s %14s %9s %9s  %s\n", "rank", "length", "count", "covers %",
+                  "saves %", "sequence");
+    for (i = 0; i < count && (int)i < top; i++) {
+        length = KEY_LENGTH(order[i * 2]);
+        fprintf(fout, "%5zu %6d %14" PRIu64 " %9.2f %9.2f ", i + 1, length, order[i * 2 + 1],
+                      ngram->dispatches ? 100.0 * order[i * 2 + 1] * length / ngram->dispatches : 0,
+                      ngram->dispatches ? 100.0 * order[i * 2 + 1] * (length - 1) / ngram->dispatches : 0);
+        for (j = length - 1; j >= 0; j--) {
+            symbol = (order[i * 2] >> (j * SYMBOL_BITS)) & ((1ULL << SYMBOL_BITS) - 1);
+            if (!kinds || (symbol >> SYMBOL_OP_BITS) == 0)
+                snprintf(name, sizeof(name), "%s",
+                         instruction_op_name(symbol & ((1 << SYMBOL_OP_BITS) - 1)));
+            else if ((symbol >> (SYMBOL_OP_BITS + 2)) == 0)
+                snprintf(name, sizeof(name), "%s(%s)",
+                         instruction_op_name(symbol & ((1 << SYMBOL_OP_BITS) - 1)),
+                         kind_names[(symbol >> SYMBOL_OP_BITS) & 3]);
+            else
+                snprintf(name, sizeof(name), "%s(%s,%s)",
+                         instruction_op_name(symbol & ((1 << SYMBOL_OP_BITS) - 1)),
+                         kind_names[(symbol >> SYMBOL_OP_BITS) & 3],
+                         kind_names[(symbol >> (SYMBOL_OP_BITS + 2)) & 3]);
+            fprintf(fout, " %s", name);
+        }
+        fprintf(fout, "\n");
+    }
+
+    free(order);
+}
+
+/**
+ * @brief order slots by dispatches a fused instruction saves, descending, used by qsort.
+ * @return <0, 0 or >0.
+ */
+static int s_compare_saves(const void *left, const void *right) {
+    const uint64_t *l = (const uint64_t *)left;
+    const uint64_t *r = (const uint64_t *)right;
+    uint64_t l_saves = l[1] * (KEY_LENGTH(l[0]) - 1);
+    uint64_t r_saves = r[1] * (KEY_LENGTH(r[0]) - 1);
+
+    if (l_saves != r_saves)
+        return l_saves < r_saves ? 1 : -1;
+    return l[0] < r[0] ? -1 : l[0] > r[0];
+}
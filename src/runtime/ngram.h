@@ -0,0 +1,50 @@
+/**
+ * @file ngram.h
+ * @brief Purpose: count the dynamic sequences of operations, with and without
+ *        the kinds of their operands, to guide the design of the instruction set.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __NGRAM_H__
+#define __NGRAM_H__
+
+#include "instruction.h"
+
+#define NGRAM_DEFAULT_PREFIX        "ngrams"        /**< default prefix of the output files */
+#define NGRAM_DEFAULT_TOP           (20)            /**< default sequences listed per table */
+#define NGRAM_MIN_LENGTH            (2)             /**< shortest sequence counted */
+#define NGRAM_MAX_LENGTH            (4)             /**< longest sequence counted */
+
+typedef struct ngram ngram_st;
+struct ngram;
+
+/**
+ * @brief initialize an empty n-gram counter.
+ * @return a valid n-gram object.
+ */
+ngram_st *ngram_init();
+
+/**
+ * @brief clean up the n-gram object.
+ * @param ngram a valid n-gram object.
+ */
+void ngram_fini(ngram_st *);
+
+/**
+ * @brief count one dispatched instruction, as the end of every sequence leading to it.
+ * @param ngram a valid n-gram object.
+ * @param instruction the dispatched instruction.
+ */
+void ngram_count(ngram_st *, instruction_st *);
+
+/**
+ * @brief add the counts into "<prefix>.counts", so the counts of several programs
+ *        add up, then write the top sequences of all of them into "<prefix>.report".
+ * @param ngram a valid n-gram object.
+ * @param prefix prefix of the output files.
+ * @param top sequences listed per table.
+ * @return 0 on success; otherwise errno, EBADMSG if the counts file is not ours.
+ */
+int ngram_write(ngram_st *, const char *, int);
+
+#endif
@@ -0,0 +1,186 @@
+/**
+ * @file perf_counters.c
+ * @brief Purpose: count hardware events of the runtime with perf_event_open.
+ *
+ * Each counter is opened on its own rather than as a group, so one event
+ * the cpu doesn't support leaves the others working. When the kernel
+ * multiplexes them, the counts are scaled by enabled / running time.
+ * The counters are inherited by the threads created after they open, so
+ * the load counts the threads of the parallel loader. The kernel adds the
+ * counts of a thread when it exits and a reset doesn't clear them, so each
+ * start reads a base that the stop subtracts.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "perf_counters.h"
+
+#define HW_CACHE_READ_MISS(cache)   ((cache) | (PERF_COUNT_HW_CACHE_OP_READ << 8) | \
+                                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16))
+
+struct perf_counters {
+    int fds[PERF_COUNTER_COUNT];                    /**< counter file descriptors, -1 if unavailable */
+    uint64_t bases[PERF_COUNTER_COUNT][3];          /**< value, time enabled, time running at start */
+    int error;                                      /**< errno of the first counter failed to open */
+};
+
+static const struct {
+    const char *name;                               /**< name in the stats report */
+    uint32_t type;                                  /**< perf_event_attr.type */
+    uint64_t config;                                /**< perf_event_attr.config */
+} s_events[PERF_COUNTER_COUNT] = {
+    [PERF_CYCLES]        = { "cycles",        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    [PERF_INSTRUCTIONS]  = { "instructions",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    [PERF_BRANCH_MISSES] = { "branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    [PERF_L1D_MISSES]    = { "l1d_misses",    PERF_TYPE_HW_CACHE,
+                             HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_L1D) },
+    [PERF_LLC_MISSES]    = { "llc_misses",    PERF_TYPE_HW_CACHE,
+                             HW_CACHE_READ_MISS(PERF_COUNT_HW_CACHE_LL) },
+};
+
+/**
+ * @brief open the counters for the calling thread and the threads it creates,
+ *        counting user space only.
+ *        Counters the kernel or the container refuses are left unavailable.
+ * @return a valid perf counters object, even if no counter is available.
+ */
+perf_counters_st *perf_counters_init() {
+    struct perf_event_attr attr;
+    perf_counters_st *counters;
+    int i;
+
+    counters = (perf_counters_st *)calloc(1, sizeof(perf_counters_st));
+    if (counters == NULL)
+        exit(ENOMEM);
+
+    for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = s_events[i].type;
+        attr.config = s_events[i].config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // seccomp in containers answers ENOSYS or EPERM, old kernels ENOENT.
+        counters->fds[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if (counters->fds[i] < 0) {
+            if (counters->error == 0)
+                counters->error = errno;
+            counters->fds[i] = -1;
+        }
+#ifdef DEBUG
+        fprintf(stderr, "perf counter %s: fd %d\n", s_events[i].name, counters->fds[i]);
+#endif
+    }
+
+    return counters;
+}
+
+/**
+ * @brief close the counters.
+ * @param counters a valid perf counters object.
+ */
+void perf_counters_fini(perf_counters_st *counters) {
+    int i;
+
+    if (counters == NULL)
+        return;
+
+    for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0)
+            close(counters->fds[i]);
+    }
+    free(counters);
+}
+
+/**
+ * @brief get why no counter is available.
+ * @param counters a valid perf counters object.
+ * @return 0 if any counter is available; otherwise errno of the first counter.
+ */
+int perf_counters_get_error(perf_counters_st *counters) {
+    int i;
+
+    if (counters == NULL)
+        return EINVAL;
+
+    for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] >= 0)
+            return 0;
+    }
+    return counters->error;
+}
+
+/**
+ * @brief reset and start the counters.
+ * @param counters a valid perf counters object.
+ */
+void perf_counters_start(perf_counters_st *counters) {
+    int i;
+
+    if (counters == NULL)
+        return;
+
+    for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] < 0)
+            continue;
+        ioctl(counters->fds[i], PERF_EVENT_IOC_RESET, 0);
+        if (read(counters->fds[i], counters->bases[i], sizeof(counters->bases[i])) !=
+            sizeof(counters->bases[i]))
+            memset(counters->bases[i], 0, sizeof(counters->bases[i]));
+        ioctl(counters->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+/**
+ * @brief stop the counters and read them.
+ * @param counters a valid perf counters object.
+ * @param values [out] the counts since the start.
+ */
+void perf_counters_stop(perf_counters_st *counters, perf_values_st *values) {
+    uint64_t buffer[3];                             /**< value, time enabled, time running */
+    int i;
+    int j;
+
+    if (counters == NULL || values == NULL)
+        return;
+
+    memset(values, 0, sizeof(perf_values_st));
+    for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (counters->fds[i] < 0)
+            continue;
+        ioctl(counters->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(counters->fds[i], buffer, sizeof(buffer)) != sizeof(buffer))
+            continue;
+        for (j = 0; j < 3; j++)
+            buffer[j] -= counters->bases[i][j];
+
+        values->available[i] = 1;
+        if (buffer[2] != 0 && buffer[2] < buffer[1])
+            values->values[i] = (uint64_t)((double)buffer[0] * buffer[1] / buffer[2]);
+        else
+            values->values[i] = buffer[0];
+    }
+}
+
+/**
+ * @brief get the name of a counter, as in the stats report.
+ * @param counter enum perf_counter.
+ * @return name of the counter.
+ */
+const char *perf_counter_name(int counter) {
+    if (counter < 0 || counter >= PERF_COUNTER_COUNT)
+        return "unknown";
+    return s_events[counter].name;
+}
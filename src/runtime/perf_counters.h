@@ -0,0 +1,70 @@
+/**
+ * @file perf_counters.h
+ * @brief Purpose: count hardware events of the runtime with perf_event_open.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __PERF_COUNTERS_H__
+#define __PERF_COUNTERS_H__
+
+#include <stdint.h>
+
+enum perf_counter {
+    PERF_CYCLES = 0,                                /**< cpu cycles */
+    PERF_INSTRUCTIONS,                              /**< retired cpu instructions */
+    PERF_BRANCH_MISSES,                             /**< mispredicted branches */
+    PERF_L1D_MISSES,                                /**< L1 data cache read misses */
+    PERF_LLC_MISSES,                                /**< last level cache read misses */
+    PERF_COUNTER_COUNT,                             /**< total of counters */
+};
+
+typedef struct perf_values {
+    int available[PERF_COUNTER_COUNT];              /**< 1 if the counter could be opened */
+    uint64_t values[PERF_COUNTER_COUNT];            /**< counts, scaled if multiplexed */
+} perf_values_st;
+
+typedef struct perf_counters perf_counters_st;
+struct perf_counters;
+
+/**
+ * @brief open the counters for the calling thread and the threads it creates,
+ *        counting user space only.
+ *        Counters the kernel or the container refuses are left unavailable.
+ * @return a valid perf counters object, even if no counter is available.
+ */
+perf_counters_st *perf_counters_init();
+
+/**
+ * @brief close the counters.
+ * @param counters a valid perf counters object.
+ */
+void perf_counters_fini(perf_counters_st *);
+
+/**
+ * @brief get why no counter is available.
+ * @param counters a valid perf counters object.
+ * @return 0 if any counter is available; otherwise errno of the first counter.
+ */
+int perf_counters_get_error(perf_counters_st *);
+
+/**
+ * @brief reset and start the counters.
+ * @param counters a valid perf counters object.
+ */
+void perf_counters_start(perf_counters_st *);
+
+/**
+ * @brief stop the counters and read them.
+ * @param counters a valid perf counters object.
+ * @param values [out] the counts since the start.
+ */
+void perf_counters_stop(perf_counters_st *, perf_values_st *);
+
+/**
+ * @brief get the name of a counter, as in the stats report.
+ * @param counter enum perf_counter.
+ * @return name of the counter.
+ */
+const char *perf_counter_name(int);
+
+#endif
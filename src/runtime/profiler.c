@@ -0,0 +1,537 @@
+/**
+ * @file profiler.c
+ * @brief Purpose: count the execution of each instruction and label region.
+ *
+ * The counters are indexed by program counter, the hot path is two array
+ * updates. The program is divided into regions by its labels: a region
+ * starts at "name:" and ends at the matching "name_end:", an "elseN:"
+ * region ends with its "ifN_end:". Regions nest like the scopes they open,
+ * code outside any label belongs to the "main" region.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "profiler.h"
+
+#define REGION_ROOT             (0)                 /**< index of the main region */
+#define DEFAULT_ARRAY_SIZE      (16)                /**< dynamic array default size */
+#define RESIZE_FACTOR           (2)                 /**< resize factor when dynamic array is too small */
+#define HOT_INSTRUCTIONS        (20)                /**< instructions listed in the report */
+
+enum region_kind {
+    REGION_BLOCK = 0,                               /**< main, stmt_list */
+    REGION_LOOP,                                    /**< forN */
+    REGION_BRANCH,                                  /**< ifN, elseN */
+};
+
+typedef struct region {
+    const char *name;                               /**< label name, without ":" */
+    int name_length;                                /**< length of the name */
+    int kind;                                       /**< enum region_kind */
+    int begin;                                      /**< address of the label */
+    int end;                                        /**< address of the end label */
+    int parent;                                     /**< index of the enclosing region */
+    uint64_t entries;                               /**< times entered, through the label or a jump */
+    uint64_t trips;                                 /**< back-edges taken, loops only */
+    uint64_t self_cost;                             /**< instructions executed in region only */
+    uint64_t total_cost;                            /**< instructions executed, nested included */
+} region_st;
+
+struct profiler {
+    instruction_set_st *instructions;               /**< the profiled program */
+    int count;                                      /**< total of instructions */
+    uint64_t *counts;                               /**< executions of each instruction */
+    uint64_t *taken;                                /**< taken jumps of each instruction */
+    int *owner;                                     /**< innermost region of each instruction */
+    region_st *regions;                             /**< all regions, parents go first */
+    int region_count;                               /**< total of regions */
+    int region_capacity;                            /**< capacity of regions */
+};
+
+/**
+ * @brief divide the program into regions by its labels.
+ * @param profiler [in/out] a valid profiler object.
+ */
+static void s_build_regions(profiler_st *);
+
+/**
+ * @brief append a region.
+ * @param profiler [in/out] a valid profiler object.
+ * @param name label name, without ":".
+ * @param length length of the name.
+ * @param begin address of the label.
+ * @param parent index of the enclosing region.
+ * @return index of the new region.
+ */
+static int s_add_region(profiler_st *, const char *, int, int, int);
+
+/**
+ * @brief sum up the counters into the regions.
+ * @param profiler [in/out] a valid profiler object.
+ */
+static void s_aggregate(profiler_st *);
+
+/**
+ * @brief write the path from main to a region, separated by ';'.
+ * @param fout output stream.
+ * @param profiler a valid profiler object.
+ * @param index index of the region.
+ */
+static void s_write_path(FILE *, profiler_st *, int);
+
+/**
+ * @brief write one instruction as text.
+ * @param fout output stream.
+ * @param instruction a decoded instruction.
+ */
+static void s_write_instruction(FILE *, instruction_st *);
+
+/**
+ * @brief write the report sorted by cost.
+ * @param fout output stream.
+ * @param profiler a valid profiler object, aggregated.
+ */
+static void s_write_report(FILE *, profiler_st *);
+
+/**
+ * @brief write the folded stacks, one line per region: "main;for1;if1 self_cost".
+ * @param fout output stream.
+ * @param profiler a valid profiler object, aggregated.
+ */
+static void s_write_folded(FILE *, profiler_st *);
+
+/**
+ * @brief order regions by total cost, descending, used by qsort.
+ * @param left index of a region.
+ * @param right index of a region.
+ * @return compare result.
+ */
+static int s_compare_region(const void *, const void *);
+
+/**
+ * @brief order instructions by executions, descending, used by qsort.
+ * @param left address of an instruction.
+ * @param right address of an instruction.
+ * @return compare result.
+ */
+static int s_compare_instruction(const void *, const void *);
+
+static profiler_st *s_sorting;                      /**< profiler being sorted */
+
+/**
+ * @brief initialize a profiler for a loaded program.
+ * @param instructions a valid instruction set object.
+ * @return a valid profiler object.
+ */
+profiler_st *profiler_init(instruction_set_st *instructions) {
+    profiler_st *profiler;
+
+    if (instructions == NULL)
+        exit(EINVAL);
+
+    profiler = (profiler_st *)calloc(1, sizeof(profiler_st));
+    if (profiler == NULL)
+        exit(ENOMEM);
+
+    profiler->instructions = instructions;
+    profiler->count = instruction_set_get_count(instructions);
+
+    profiler->counts = (uint64_t *)calloc(profiler->count + 1, sizeof(uint64_t));
+    profiler->taken = (uint64_t *)calloc(profiler->count + 1, sizeof(uint64_t));
+    profiler->owner = (int *)calloc(profiler->count + 1, sizeof(int));
+    if (profiler->counts == NULL || profiler->taken == NULL || profiler->owner == NULL)
+        exit(ENOMEM);
+
+    return profiler;
+}
+
+/**
+ * @brief clean up the profiler object.
+ * @param profiler a valid profiler object.
+ */
+void profiler_fini(profiler_st *profiler) {
+    if (profiler == NULL)
+        return;
+
+    free(profiler->counts);
+    free(profiler->taken);
+    free(profiler->owner);
+    free(profiler->regions);
+    free(profiler);
+}
+
+/**
+ * @brief count one executed instruction.
+ * @param profiler a valid profiler object.
+ * @param pc address of the executed instruction.
+ * @param next_pc program counter after the execution.
+ */
+void profiler_count(profiler_st *profiler, int pc, int next_pc) {
+    profiler->counts[pc]++;
+    if (next_pc != pc + 1)
+        profiler->taken[pc]++;
+}
+
+/**
+ * @brief write the report sorted by cost into "<prefix>.report" and
+ *        the folded stacks for flame graph tools into "<prefix>.folded".
+ * @param profiler a valid profiler object.
+ * @param prefix prefix of the output files.
+ * @return 0 on success; otherwise errno.
+ */
+int profiler_write(profiler_st *profiler, const char *prefix) {
+    FILE *fout;
+    char *path;
+    size_t path_len;
+    int rc = 0;
+
+    if (profiler == NULL || prefix == NULL)
+        return EINVAL;
+
+    // regions are built on demand, lazy loaded programs decode here.
+    if (profiler->regions == NULL)
+        s_build_regions(profiler);
+    s_aggregate(profiler);
+
+    path_len = strlen(prefix) + strlen(".report") + 1;
+    path = (char *)malloc(path_len);
+    if (path == NULL)
+        return ENOMEM;
+
+    snprintf(path, path_len, "%s.report", prefix);
+    fout = fopen(path, "w");
+    if (fout == NULL) {
+        rc = errno;
+        free(path);
+        return rc;
+    }
+    s_write_report(fout, profiler);
+    if (fclose(fout) != 0)
+        rc = errno;
+
+    snprintf(path, path_len, "%s.folded", prefix);
+    fout = fopen(path, "w");
+    if (fout == NULL) {
+        rc = errno;
+        free(path);
+        return rc;
+    }
+    s_write_folded(fout, profiler);
+    if (fclose(fout) != 0 && rc == 0)
+        rc = errno;
+
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief divide the program into regions by its labels.
+ * @param profiler [in/out] a valid profiler object.
+ */
+static void s_build_regions(profiler_st *profiler) {
+    instruction_st *instruction;
+    const char *name;
+    region_st *region;
+    int *stack;
+    int top = 0;
+    int length;
+    int found;
+    int pc;
+    int i;
+
+    stack = (int *)malloc((profiler->count + 1) * sizeof(int));
+    if (stack == NULL)
+        exit(ENOMEM);
+
+    stack[top] = s_add_region(profiler, "main", strlen("main"), 0, REGION_ROOT);
+
+    for (pc = 0; pc < profiler->count; pc++) {
+        instruction = instruction_set_get_address(profiler->instructions, pc);
+        name = instruction_get_op_code(instruction);
+
+        if (instruction_get_op_type(instruction) == OP_SCOPE_OPEN) {
+            length = strcspn(name, ":");
+            i = s_add_region(profiler, name, length, pc, stack[top]);
+            stack[++top] = i;
+        }
+
+        profiler->owner[pc] = stack[top];
+
+        if (instruction_get_op_type(instruction) == OP_SCOPE_CLOSE) {
+            // "for1_end:" closes "for1", and everything opened inside it.
+            length = strlen(name) - strlen("_end:");
+            found = -1;
+            for (i = top; i > 0; i--) {
+                region = &(profiler->regions[stack[i]]);
+                if (region->name_length == length && strncmp(region->name, name, length) == 0) {
+                    found = i;
+                    break;
+                }
+            }
+            for ( ; found > 0 && top >= found; top--)
+                profiler->regions[stack[top]].end = pc;
+        }
+    }
+
+    for ( ; top >= 0; top--)
+        profiler->regions[stack[top]].end = profiler->count - 1;
+
+    free(stack);
+}
+
+/**
+ * @brief append a region.
+ * @param profiler [in/out] a valid profiler object.
+ * @param name label name, without ":".
+ * @param length length of the name.
+ * @param begin address of the label.
+ * @param parent index of the enclosing region.
+ * @return index of the new region.
+ */
+static int s_add_region(profiler_st *profiler, const char *name, int length,
+                        int begin, int parent) {
+    region_st *region;
+
+    if (profiler->region_count >= profiler->region_capacity) {
+        profiler->region_capacity = profiler->region_capacity ?
+                                    profiler->region_capacity * RESIZE_FACTOR :
+                                    DEFAULT_ARRAY_SIZE;
+        profiler->regions = (region_st *)realloc(profiler->regions,
+                                    profiler->region_capacity * sizeof(region_st));
+        if (profiler->regions == NULL)
+            exit(ENOMEM);
+    }
+
+    region = &(profiler->regions[profiler->region_count]);
+    memset(region, 0, sizeof(region_st));
+    region->name = name;
+    region->name_length = length;
+    region->begin = begin;
+    region->end = begin;
+    region->parent = parent;
+    if (strncmp(name, "for", strlen("for")) == 0)
+        region->kind = REGION_LOOP;
+    else if (strncmp(name, "if", strlen("if")) == 0 || strncmp(name, "else", strlen("else")) == 0)
+        region->kind = REGION_BRANCH;
+    else
+        region->kind = REGION_BLOCK;
+
+    return profiler->region_count++;
+}
+
+/**
+ * @brief sum up the counters into the regions.
+ * @param profiler [in/out] a valid profiler object.
+ */
+static void s_aggregate(profiler_st *profiler) {
+    instruction_st *instruction;
+    region_st *region;
+    int target;
+    int pc;
+    int i;
+
+    for (i = 0; i < profiler->region_count; i++) {
+        region = &(profiler->regions[i]);
+        region->self_cost = 0;
+        region->total_cost = 0;
+        region->trips = 0;
+        region->entries = (i == REGION_ROOT) ? 1 : profiler->counts[region->begin];
+    }
+
+    for (pc = 0; pc < profiler->count; pc++) {
+        profiler->regions[profiler->owner[pc]].self_cost += profiler->counts[pc];
+
+        instruction = instruction_set_get_address(profiler->instructions, pc);
+        if (instruction_get_op_type(instruction) >= OP_JE &&
+            instruction_get_op_type(instruction) <= OP_JMP &&
+            instruction_get_target(instruction) >= 1) {
+            // a jump lands after the label, "JNE else1" enters else1 without running "else1:".
+            target = instruction_get_target(instruction);
+            region = &(profiler->regions[profiler->owner[target - 1]]);
+            if (region->begin == target - 1 && (pc < region->begin || pc > region->end))
+                region->entries += profiler->taken[pc];
+
+            // a loop iterates by jumping back to the instruction after its label.
+            for (i = profiler->owner[pc]; i != REGION_ROOT; i = profiler->regions[i].parent) {
+                region = &(profiler->regions[i]);
+                if (region->kind == REGION_LOOP &&
+                    region->begin + 1 == instruction_get_target(instruction)) {
+                    region->trips += profiler->taken[pc];
+                    break;
+                }
+            }
+        }
+    }
+
+    // children always come after their parent.
+    for (i = profiler->region_count - 1; i >= 0; i--) {
+        region = &(profiler->regions[i]);
+        region->total_cost += region->self_cost;
+        if (i != REGION_ROOT)
+            profiler->regions[region->parent].total_cost += region->total_cost;
+    }
+}
+
+/**
+ * @brief write the path from main to a region, separated by ';'.
+ * @param fout output stream.
+ * @param profiler a valid profiler object.
+ * @param index index of the region.
+ */
+static void s_write_path(FILE *fout, profiler_st *profiler, int index) {
+    region_st *region = &(profiler->regions[index]);
+
+    if (index != REGION_ROOT) {
+        s_write_path(fout, profiler, region->parent);
+        fputc(';', fout);
+    }
+    fprintf(fout, "%.*s", region->name_length, region->name);
+}
+
+/**
+ * @brief write one instruction as text.
+ * @param fout output stream.
+ * @param instruction a decoded instruction.
+ */
+static void s_write_instruction(FILE *fout, instruction_st *instruction) {
+    fprintf(fout, "%s", instruction_get_op_code(instruction));
+    if (instruction_get_op_first(instruction) != NULL)
+        fprintf(fout, " %s", instruction_get_op_first(instruction));
+    if (instruction_get_op_second(instruction) != NULL)
+        fprintf(fout, " %s", instruction_get_op_second(instruction));
+}
+
+/**
+ * @brief write the report sorted by cost.
+ * @param fout output stream.
+ * @param profiler a valid profiler object, aggregated.
+ */
+static void s_write_report(FILE *fout, profiler_st *profiler) {
+    instruction_st *instruction;
+    region_st *region;
+    int *order;
+    int size;
+    int op_type;
+    int pc;
+    int i;
+
+    size = profiler->count > profiler->region_count ? profiler->count : profiler->region_count;
+    order = (int *)malloc((size + 1) * sizeof(int));
+    if (order == NULL)
+        exit(ENOMEM);
+
+    fprintf(fout, "# instructions executed: %" PRIu64 "\n\n",
+                  profiler->regions[REGION_ROOT].total_cost);
+
+    // regions, by total cost.
+    for (i = 0; i < profiler->region_count; i++)
+        order[i] = i;
+    s_sorting = profiler;
+    qsort(order, profiler->region_count, sizeof(int), s_compare_region);
+
+    fprintf(fout, "%-14s %-14s %-10s %-10s %-11s %s\n",
+                  "total", "self", "entries", "trips", "lines", "region");
+    for (i = 0; i < profiler->region_count; i++) {
+        region = &(profiler->regions[order[i]]);
+        fprintf(fout, "%-14" PRIu64 " %-14" PRIu64 " %-10" PRIu64 " ",
+                      region->total_cost, region->self_cost, region->entries);
+        if (region->kind == REGION_LOOP)
+            fprintf(fout, "%-10" PRIu64 " ", region->trips);
+        else
+            fprintf(fout, "%-10s ", "-");
+        fprintf(fout, "%5d-%-5d ", region->begin + 1, region->end + 1);
+        s_write_path(fout, profiler, order[i]);
+        fputc('\n', fout);
+    }
+
+    // conditional branches, by executions.
+    fprintf(fout, "\n%-14s %-14s %-14s %-11s %-24s %s\n",
+                  "executed", "taken", "not-taken", "line", "instruction", "region");
+    for (i = 0; i < profiler->count; i++)
+        order[i] = i;
+    qsort(order, profiler->count, sizeof(int), s_compare_instruction);
+    for (i = 0; i < profiler->count; i++) {
+        pc = order[i];
+        instruction = instruction_set_get_address(profiler->instructions, pc);
+        op_type = instruction_get_op_type(instruction);
+        if (op_type < OP_JE || op_type >= OP_JMP)
+            continue;
+        fprintf(fout, "%-14" PRIu64 " %-14" PRIu64 " %-14" PRIu64 " %-11d %-4s %-19s ",
+                      profiler->counts[pc], profiler->taken[pc],
+                      profiler->counts[pc] - profiler->taken[pc], pc + 1,
+                      instruction_get_op_code(instruction),
+                      instruction_get_op_first(instruction));
+        s_write_path(fout, profiler, profiler->owner[pc]);
+        fputc('\n', fout);
+    }
+
+    // hottest instructions.
+    fprintf(fout, "\n%-14s %-11s %s\n", "executed", "line", "instruction");
+    for (i = 0; i < profiler->count && i < HOT_INSTRUCTIONS; i++) {
+        pc = order[i];
+        if (profiler->counts[pc] == 0)
+            break;
+        fprintf(fout, "%-14" PRIu64 " %-11d ", profiler->counts[pc], pc + 1);
+        s_write_instruction(fout, instruction_set_get_address(profiler->instructions, pc));
+        fputc('\n', fout);
+    }
+
+    free(order);
+}
+
+/**
+ * @brief write the folded stacks, one line per region: "main;for1;if1 self_cost".
+ * @param fout output stream.
+ * @param profiler a valid profiler object, aggregated.
+ */
+static void s_write_folded(FILE *fout, profiler_st *profiler) {
+    int i;
+
+    for (i = 0; i < profiler->region_count; i++) {
+        if (profiler->regions[i].self_cost == 0)
+            continue;
+        s_write_path(fout, profiler, i);
+        fprintf(fout, " %" PRIu64 "\n", profiler->regions[i].self_cost);
+    }
+}
+
+/**
+ * @brief order regions by total cost, descending, used by qsort.
+ * @param left index of a region.
+ * @param right index of a region.
+ * @return compare result.
+ */
+static int s_compare_region(const void *left, const void *right) {
+    int index_left = *(const int *)left;
+    int index_right = *(const int *)right;
+    uint64_t cost_left = s_sorting->regions[index_left].total_cost;
+    uint64_t cost_right = s_sorting->regions[index_right].total_cost;
+
+    if (cost_left != cost_right)
+        return cost_left < cost_right ? 1 : -1;
+    // ties keep program order.
+    return index_left - index_right;
+}
+
+/**
+ * @brief order instructions by executions, descending, used by qsort.
+ * @param left address of an instruction.
+ * @param right address of an instruction.
+ * @return compare result.
+ */
+static int s_compare_instruction(const void *left, const void *right) {
+    int index_left = *(const int *)left;
+    int index_right = *(const int *)right;
+    uint64_t cost_left = s_sorting->counts[index_left];
+    uint64_t cost_right = s_sorting->counts[index_right];
+
+    if (cost_left != cost_right)
+        return cost_left < cost_right ? 1 : -1;
+    // ties keep program order.
+    return index_left - index_right;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file profiler.h
+ * @brief Purpose: count the execution of each instruction and label region.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include "instruction.h"
+
+#define PROFILER_DEFAULT_PREFIX     "profile"       /**< default prefix of the output files */
+
+typedef struct profiler profiler_st;
+struct profiler;
+
+/**
+ * @brief initialize a profiler for a loaded program.
+ * @param instructions a valid instruction set object.
+ * @return a valid profiler object.
+ */
+profiler_st *profiler_init(instruction_set_st *);
+
+/**
+ * @brief clean up the profiler object.
+ * @param profiler a valid profiler object.
+ */
+void profiler_fini(profiler_st *);
+
+/**
+ * @brief count one executed instruction.
+ * @param profiler a valid profiler object.
+ * @param pc address of the executed instruction.
+ * @param next_pc program counter after the execution.
+ */
+void profiler_count(profiler_st *, int, int);
+
+/**
+ * @brief write the report sorted by cost into "<prefix>.report" and
+ *        the folded stacks for flame graph tools into "<prefix>.folded".
+ * @param profiler a valid profiler object.
+ * @param prefix prefix of the output files.
+ * @return 0 on success; otherwise errno.
+ */
+int profiler_write(profiler_st *, const char *);
+
+#endif
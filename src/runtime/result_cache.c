@@ -0,0 +1,335 @@
+/**
+ * @file result_cache.c
+ * @brief Purpose: cache the output of programs, keyed by the program identity.
+ *
+ * TEN programs take no input, their output depends on the program only. Each
+ * entry is one file named after the program hash:
+ *
+ *     header                      fixed size, see result_cache_header_st
+ *     output                      bytes written to stdout
+ *
+ * Entries are replaced atomically, readers never see a partial entry.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "result_cache.h"
+
+#define RESULT_CACHE_MAGIC      "TENRCACH"          /**< magic string, 8 bytes without '\0' */
+#define RESULT_CACHE_VERSION    (1)                 /**< version of the entry layout */
+#define DEFAULT_BUFFER_SIZE     (4096)              /**< default size of the capture buffer */
+#define RESIZE_FACTOR           (2)                 /**< resize factor when buffer is too small */
+
+typedef struct result_cache_header {
+    char magic[8];                                  /**< RESULT_CACHE_MAGIC */
+    uint32_t version;                               /**< RESULT_CACHE_VERSION */
+    uint32_t header_size;                           /**< sizeof(result_cache_header_st) */
+    uint64_t program_hash;                          /**< identity of the program */
+    int32_t exit_status;                            /**< exit status of the run */
+    uint32_t reserved;                              /**< padding, always 0 */
+    uint64_t executed;                              /**< instructions executed in the run */
+    uint64_t output_size;                           /**< size of the output */
+} result_cache_header_st;
+
+struct result_cache {
+    char *entry_path;                               /**< path of the cache entry */
+    uint64_t program_hash;                          /**< identity of the program */
+    size_t max_bytes;                               /**< limit of cached output */
+    char *output;                                   /**< captured output */
+    size_t output_size;                             /**< size of captured output */
+    size_t output_capacity;                         /**< capacity of output buffer */
+    int overflow;                                   /**< 1 if output is over the limit */
+};
+
+/**
+ * @brief map a valid cache entry into memory.
+ * @param cache a valid result cache object.
+ * @param size [out] size of the mapping.
+ * @return NULL if the entry doesn't exist or is invalid; otherwise the header.
+ */
+static const result_cache_header_st *s_map_entry(result_cache_st *, size_t *);
+
+/**
+ * @brief write the whole buffer into a file descriptor.
+ * @param fd a valid file descriptor.
+ * @param buffer data going to write.
+ * @param size size of the data.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_write_all(int, const char *, size_t);
+
+/**
+ * @brief open the cache entry of a program.
+ * @param cache_dir directory of the cache, must exist.
+ * @param program_hash identity of the program.
+ * @param max_bytes output larger than this is not cached.
+ * @return a valid result cache object.
+ */
+result_cache_st *result_cache_init(const char *cache_dir, uint64_t program_hash,
+                                   size_t max_bytes) {
+    result_cache_st *cache;
+    size_t path_len;
+
+    if (cache_dir == NULL)
+        exit(EINVAL);
+
+    cache = (result_cache_st *)calloc(1, sizeof(result_cache_st));
+    if (cache == NULL)
+        exit(ENOMEM);
+
+    // "<dir>/<16 hex digits>.out"
+    path_len = strlen(cache_dir) + 1 + 16 + strlen(".out") + 1;
+    cache->entry_path = (char *)malloc(path_len);
+    if (cache->entry_path == NULL)
+        exit(ENOMEM);
+    snprintf(cache->entry_path, path_len, "%s/%016" PRIx64 ".out", cache_dir, program_hash);
+
+    cache->program_hash = program_hash;
+    cache->max_bytes = max_bytes;
+
+    return cache;
+}
+
+/**
+ * @brief clean up the result cache object.
+ * @param cache a valid result cache object.
+ */
+void result_cache_fini(result_cache_st *cache) {
+    if (cache == NULL)
+        return;
+
+    free(cache->output);
+    free(cache->entry_path);
+    free(cache);
+}
+
+/**
+ * @brief replay the cached output into stdout with a single write.
+ * @param cache a valid result cache object.
+ * @param exit_status [out] exit status of the cached run.
+ * @return 0 on hit; otherwise errno, nothing written.
+ */
+int result_cache_replay(result_cache_st *cache, int *exit_status) {
+    const result_cache_header_st *header;
+    size_t size = 0;
+    int rc;
+
+    if (cache == NULL || exit_status == NULL)
+        return EINVAL;
+
+    header = s_map_entry(cache, &size);
+    if (header == NULL)
+        return ENOENT;
+
+#ifdef DEBUG
+    fprintf(stderr, "cache hit: %s, %" PRIu64 " bytes\n", cache->entry_path, header->output_size);
+#endif
+    rc = s_write_all(STDOUT_FILENO, (const char *)(header + 1), header->output_size);
+    *exit_status = header->exit_status;
+
+    munmap((void *)header, size);
+    return rc;
+}
+
+/**
+ * @brief keep a copy of the output going to stdout.
+ * @param cache a valid result cache object.
+ * @param buffer output of the program.
+ * @param size size of the output.
+ */
+void result_cache_capture(result_cache_st *cache, const char *buffer, size_t size) {
+    size_t capacity;
+
+    if (cache == NULL || buffer == NULL || cache->overflow)
+        return;
+
+    // over the limit, give up the whole output.
+    if (cache->output_size + size > cache->max_bytes) {
+        cache->overflow = 1;
+        free(cache->output);
+        cache->output = NULL;
+        cache->output_size = 0;
+        cache->output_capacity = 0;
+        return;
+    }
+
+    if (cache->output_size + size > cache->output_capacity) {
+        capacity = cache->output_capacity ? cache->output_capacity : DEFAULT_BUFFER_SIZE;
+        while (capacity < cache->output_size + size)
+            capacity *= RESIZE_FACTOR;
+
+        cache->output = (char *)realloc(cache->output, capacity);
+        if (cache->output == NULL)
+            exit(ENOMEM);
+        cache->output_capacity = capacity;
+    }
+
+    memcpy(cache->output + cache->output_size, buffer, size);
+    cache->output_size += size;
+}
+
+/**
+ * @brief compare the captured output with the cache entry.
+ * @param cache a valid result cache object.
+ * @param exit_status exit status of this run.
+ * @return 0 on same; ENOENT no entry; EBADMSG on different result.
+ */
+int result_cache_verify(result_cache_st *cache, int exit_status) {
+    const result_cache_header_st *header;
+    size_t size = 0;
+    int rc = 0;
+
+    if (cache == NULL)
+        return EINVAL;
+
+    header = s_map_entry(cache, &size);
+    if (header == NULL)
+        return ENOENT;
+
+    if (cache->overflow ||
+        header->exit_status != exit_status ||
+        header->output_size != cache->output_size ||
+        (cache->output_size > 0 &&
+         memcmp(header + 1, cache->output, cache->output_size) != 0))
+        rc = EBADMSG;
+
+    munmap((void *)header, size);
+    return rc;
+}
+
+/**
+ * @brief write the captured output into the cache entry, replace the old one.
+ * @param cache a valid result cache object.
+ * @param exit_status exit status of this run.
+ * @param executed total of instructions executed in this run.
+ * @return 0 on success; EFBIG if output is over the limit; otherwise errno.
+ */
+int result_cache_store(result_cache_st *cache, int exit_status, uint64_t executed) {
+    result_cache_header_st header;
+    char *tmp_path;
+    size_t tmp_len;
+    int fd;
+    int rc;
+
+    if (cache == NULL)
+        return EINVAL;
+
+    if (cache->overflow)
+        return EFBIG;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RESULT_CACHE_MAGIC, sizeof(header.magic));
+    header.version = RESULT_CACHE_VERSION;
+    header.header_size = sizeof(result_cache_header_st);
+    header.program_hash = cache->program_hash;
+    header.exit_status = exit_status;
+    header.executed = executed;
+    header.output_size = cache->output_size;
+
+    // a unique temporary file, concurrent runs of the same program may race.
+    tmp_len = strlen(cache->entry_path) + strlen(".XXXXXX") + 1;
+    tmp_path = (char *)malloc(tmp_len);
+    if (tmp_path == NULL)
+        return ENOMEM;
+    snprintf(tmp_path, tmp_len, "%s.XXXXXX", cache->entry_path);
+
+    fd = mkstemp(tmp_path);
+    if (fd < 0) {
+        rc = errno;
+        free(tmp_path);
+        return rc;
+    }
+
+    rc = s_write_all(fd, (const char *)&header, sizeof(header));
+    if (rc == 0)
+        rc = s_write_all(fd, cache->output, cache->output_size);
+    if (rc == 0 && fchmod(fd, 0644) != 0)
+        rc = errno;
+    if (close(fd) != 0 && rc == 0)
+        rc = errno;
+    if (rc == 0 && rename(tmp_path, cache->entry_path) != 0)
+        rc = errno;
+    if (rc != 0)
+        unlink(tmp_path);
+
+#ifdef DEBUG
+    fprintf(stderr, "cache store: %s, %zu bytes, rc %d\n",
+                    cache->entry_path, cache->output_size, rc);
+#endif
+    free(tmp_path);
+    return rc;
+}
+
+/**
+ * @brief map a valid cache entry into memory.
+ * @param cache a valid result cache object.
+ * @param size [out] size of the mapping.
+ * @return NULL if the entry doesn't exist or is invalid; otherwise the header.
+ */
+static const result_cache_header_st *s_map_entry(result_cache_st *cache, size_t *size) {
+    const result_cache_header_st *header;
+    struct stat file_stat;
+    void *mapped;
+    int fd;
+
+    fd = open(cache->entry_path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    if (fstat(fd, &file_stat) != 0 ||
+        (size_t)file_stat.st_size < sizeof(result_cache_header_st)) {
+        close(fd);
+        return NULL;
+    }
+
+    mapped = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return NULL;
+
+    header = (const result_cache_header_st *)mapped;
+    if (memcmp(header->magic, RESULT_CACHE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != RESULT_CACHE_VERSION ||
+        header->header_size != sizeof(result_cache_header_st) ||
+        header->program_hash != cache->program_hash ||
+        header->output_size != file_stat.st_size - sizeof(result_cache_header_st)) {
+        fprintf(stderr, "%s: invalid cache entry, ignored\n", cache->entry_path);
+        munmap(mapped, file_stat.st_size);
+        return NULL;
+    }
+
+    *size = file_stat.st_size;
+    return header;
+}
+
+/**
+ * @brief write the whole buffer into a file descriptor.
+ * @param fd a valid file descriptor.
+ * @param buffer data going to write.
+ * @param size size of the data.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_write_all(int fd, const char *buffer, size_t size) {
+    ssize_t written;
+
+    while (size > 0) {
+        written = write(fd, buffer, size);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return errno;
+        }
+        buffer += written;
+        size -= written;
+    }
+    return 0;
+}
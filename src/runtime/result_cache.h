@@ -0,0 +1,67 @@
+/**
+ * @file result_cache.h
+ * @brief Purpose: cache the output of programs, keyed by the program identity.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __RESULT_CACHE_H__
+#define __RESULT_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define RESULT_CACHE_MAX_BYTES      (16 << 20)      /**< default limit of cached output */
+#define RESULT_CACHE_MIN_EXECUTED   (100000)        /**< default instructions worth caching */
+
+typedef struct result_cache result_cache_st;
+struct result_cache;
+
+/**
+ * @brief open the cache entry of a program.
+ * @param cache_dir directory of the cache, must exist.
+ * @param program_hash identity of the program.
+ * @param max_bytes output larger than this is not cached.
+ * @return a valid result cache object.
+ */
+result_cache_st *result_cache_init(const char *, uint64_t, size_t);
+
+/**
+ * @brief clean up the result cache object.
+ * @param cache a valid result cache object.
+ */
+void result_cache_fini(result_cache_st *);
+
+/**
+ * @brief replay the cached output into stdout with a single write.
+ * @param cache a valid result cache object.
+ * @param exit_status [out] exit status of the cached run.
+ * @return 0 on hit; otherwise errno, nothing written.
+ */
+int result_cache_replay(result_cache_st *, int *);
+
+/**
+ * @brief keep a copy of the output going to stdout.
+ * @param cache a valid result cache object.
+ * @param buffer output of the program.
+ * @param size size of the output.
+ */
+void result_cache_capture(result_cache_st *, const char *, size_t);
+
+/**
+ * @brief compare the captured output with the cache entry.
+ * @param cache a valid result cache object.
+ * @param exit_status exit status of this run.
+ * @return 0 on same; ENOENT no entry; EBADMSG on different result.
+ */
+int result_cache_verify(result_cache_st *, int);
+
+/**
+ * @brief write the captured output into the cache entry, replace the old one.
+ * @param cache a valid result cache object.
+ * @param exit_status exit status of this run.
+ * @param executed total of instructions executed in this run.
+ * @return 0 on success; EFBIG if output is over the limit; otherwise errno.
+ */
+int result_cache_store(result_cache_st *, int, uint64_t);
+
+#endif
@@ -6,155 +6,222 @@
  * @author Xiangyu Guo
  */
 #include <stdio.h>
-#include <ctype.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <signal.h>
+#include <getopt.h>
 #include <unistd.h>
+#include <sysexits.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <time.h>
 
 #include "storage.h"
 #include "instruction.h"
-
-typedef void (*eval)(void *, void *);               /**< function pointer of eval functions */
+#include "checkpoint.h"
+#include "result_cache.h"
+#include "profiler.h"
+#include "ngram.h"
+#include "inspect.h"
+#include "sampler.h"
+#include "trace.h"
+#include "stats.h"
+#include "perf_counters.h"
+#include "timeline.h"
+
+#include "ten_sdt.h"
+
+typedef void (*eval)(instruction_st *);             /**< function pointer of eval functions */
 typedef int (*cmp_cb)(int);                         /**< function pointer of compare functions */
 
-typedef struct operation {
-    char *op_code;                                  /**< operation code */
-    eval eval_func;                                 /**< evaluate funcion on this operation code */
-} operation_st;
-
 static machine_memory_st *s_machine_store;          /**< environment storage during run time */
 static instruction_set_st *s_instructions;          /**< instuctions of the assembled asm */
 
+static const char *s_checkpoint_path;               /**< where to write the snapshot, NULL for none */
+static unsigned long s_checkpoint_every;            /**< snapshot every N back-edges, 0 for never */
+static unsigned long s_back_edges;                  /**< back-edges taken so far */
+static volatile sig_atomic_t s_checkpoint_request;  /**< snapshot requested by signal */
+static volatile sig_atomic_t s_exit_request;        /**< snapshot then exit, requested by signal */
+
+static const char *s_inspect_path;                  /**< where to append the state, NULL for stderr */
+static volatile sig_atomic_t s_inspect_request;     /**< state requested by SIGUSR1 */
+
+/**
+ * @brief program image linked into a self-contained executable,
+ *        undefined (NULL) in the plain runtime.
+ */
+extern const instruction_image_st g_ten_embedded_image __attribute__((weak));
+
+static result_cache_st *s_result_cache;             /**< output cache, NULL for none */
+
+static profiler_st *s_profiler;                     /**< execution counters, NULL for none */
+static const char *s_profile_prefix;                /**< prefix of the profile files */
+
+static ngram_st *s_ngram;                           /**< operation sequence counters, NULL for none */
+static const char *s_ngram_prefix;                  /**< prefix of the n-gram files */
+static int s_ngram_top = NGRAM_DEFAULT_TOP;         /**< sequences listed per table */
+
+static sampler_st *s_sampler;                       /**< cpu time sampler, NULL for none */
+static const char *s_sample_prefix;                 /**< prefix of the sample report */
+
+static trace_st *s_trace;                           /**< binary execution trace, NULL for none */
+
+static runtime_stats_st s_stats;                    /**< statistics of the run */
+static const char *s_stats_format;                  /**< format of the report, NULL for none */
+static const char *s_stats_path;                    /**< where to append the report, NULL for stderr */
+static struct timespec s_run_start;                 /**< when the program started to run */
+static perf_counters_st *s_perf;                    /**< hardware counters, NULL for none */
+static int s_perf_running;                          /**< 1 while counting the run phase */
+static timeline_st *s_timeline;                     /**< chrome trace timeline, NULL for none */
+static double s_evaluate_start = -1;                /**< when evaluate started on the timeline, -1 before */
+static volatile sig_atomic_t s_pc = -1;             /**< address of the running instruction, -1 outside */
+
+/* static tracepoints, see ten_sdt.h, arg0 of load is the byte code path, 0 if linked in. */
+TEN_SDT_SEMAPHORE(ten, load__start);               /**< arg0 path */
+TEN_SDT_SEMAPHORE(ten, load__end);                 /**< arg0 path, arg1 instructions */
+TEN_SDT_SEMAPHORE(ten, loop__enter);               /**< arg0 pc, arg1 label, arg2 depth inside */
+TEN_SDT_SEMAPHORE(ten, loop__exit);                /**< arg0 pc, arg1 label, arg2 depth inside */
+TEN_SDT_SEMAPHORE(ten, out);                       /**< arg0 pc, arg1 value */
+
+/**
+ * @brief get the value of an operand, a variable or an immediate.
+ * @param instruction a decoded instruction.
+ * @param which OPERAND_FIRST or OPERAND_SECOND.
+ * @return value of the operand, exit if the variable is undeclared.
+ */
+static int s_operand_value(instruction_st *, int);
+
+/**
+ * @brief check if a label belongs to a loop, e.g. "for1:" or "for1_end:".
+ * @param instruction a decoded label.
+ * @return 1 for a loop label; otherwise 0.
+ */
+static int s_is_loop(instruction_st *);
+
 /**
  * @brief evaluate function of all binary operations
- * @param first_operand, first operand.
- * @param second_operand, second operand.
+ * @param instruction a decoded instruction.
  * @param op_type operation type.(+ - * / % =)
  */
-static void eval_bin_op_helper(void *, void *, char);
+static void eval_bin_op_helper(instruction_st *, char);
 
 /**
  * @brief evaluate function of "DEC" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_dec(void *, void *);
+static void eval_dec(instruction_st *);
 
 /**
  * @brief evaluate function of "MOV" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_mov(void *, void *);
+static void eval_mov(instruction_st *);
 
 /**
  * @brief evaluate function of "OUT" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_out(void *, void *);
+static void eval_out(instruction_st *);
 
 /**
  * @brief evaluate function of "ADD" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_add(void *, void *);
+static void eval_add(instruction_st *);
 
 /**
  * @brief evaluate function of "SUB" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_sub(void *, void *);
+static void eval_sub(instruction_st *);
 
 /**
  * @brief evaluate function of "MUL" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_mul(void *, void *);
+static void eval_mul(instruction_st *);
 
 /**
  * @brief evaluate function of "DIV" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_div(void *, void *);
+static void eval_div(instruction_st *);
 
 /**
  * @brief evaluate function of "MOD" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_mod(void *, void *);
+static void eval_mod(instruction_st *);
 
 /**
  * @brief evaluate function of "CMP" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_cmp(void *, void *);
+static void eval_cmp(instruction_st *);
 
 /**
  * @brief evaluate function of "JE" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_je(void *, void *);
+static void eval_je(instruction_st *);
 
 /**
  * @brief evaluate function of "JNE" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_jne(void *, void *);
+static void eval_jne(instruction_st *);
 
 /**
  * @brief evaluate function of "JL" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_jl(void *, void *);
+static void eval_jl(instruction_st *);
 
 /**
  * @brief evaluate function of "JLE" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_jle(void *, void *);
+static void eval_jle(instruction_st *);
 
 /**
  * @brief evaluate function of "JG" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_jg(void *, void *);
+static void eval_jg(instruction_st *);
 
 /**
  * @brief evaluate function of "JGE" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_jge(void *, void *);
+static void eval_jge(instruction_st *);
 
 /**
  * @brief evaluate function of "JMP" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
+ */
+static void eval_jmp(instruction_st *);
+
+/**
+ * @brief evaluate function of labels, open a new scope.
+ * @param instruction a decoded instruction.
+ */
+static void eval_scope_open(instruction_st *);
+
+/**
+ * @brief evaluate function of end labels, close current scope.
+ * @param instruction a decoded instruction.
  */
-static void eval_jmp(void *, void *);
+static void eval_scope_close(instruction_st *);
 
 /**
  * @brief evaluate function of all boolean operations
- * @param first_operand, first operand.
- * @param second_operand, second operand.
+ * @param instruction a decoded instruction.
  * @param flag_cmp call back function on different comparing behavior on flag
  */
-static void eval_bool_op_helper(void *, void *, cmp_cb flag_cmp);
+static void eval_bool_op_helper(instruction_st *, cmp_cb flag_cmp);
 
 /**
  * @brief comparison function for "JE" instruction
@@ -206,12 +273,12 @@ static int cmp_jge(int);
 static int cmp_jmp(int);
 
 /**
- * @brief all operations provided by runtime.
+ * @brief all operations provided by runtime, indexed by enum op_type.
  * Type 1: declare
  * DEC var1            ; declare a variable
  *
  * Type 2: assignment
- * MOV var1, var2/value        ; assign var2/value to var1 
+ * MOV var1, var2/value        ; assign var2/value to var1
  *
  * Type 3: arithmetic operation
  * ADD var1, var2/value        ; add var2/value to var1
@@ -231,25 +298,30 @@ static int cmp_jmp(int);
  * JMP label                   ; Jump to label, always.
  *
  * Type 5: output result
- * OUT var1/value          ; Output var1/value. 
- */
-static operation_st g_operations[] = { {"DEC", eval_dec}, 
-                                       {"MOV", eval_mov},
-                                       {"OUT", eval_out},
-                                       {"ADD", eval_add},
-                                       {"SUB", eval_sub},
-                                       {"MUL", eval_mul},
-                                       {"DIV", eval_div},
-                                       {"MOD", eval_mod},
-                                       {"CMP", eval_cmp},
-                                       {"JE" , eval_je },
-                                       {"JNE", eval_jne},
-                                       {"JL" , eval_jl },
-                                       {"JLE", eval_jle},
-                                       {"JG" , eval_jg },
-                                       {"JGE", eval_jge},
-                                       {"JMP", eval_jmp},
-                                       {NULL , NULL} };
+ * OUT var1/value          ; Output var1/value.
+ *
+ * Type 6: scope
+ * label:                  ; open a new scope, e.g. for1:
+ * label_end:              ; close current scope, e.g. for1_end:
+ */
+static eval g_operations[OP_COUNT] = { [OP_DEC] = eval_dec,
+                                       [OP_MOV] = eval_mov,
+                                       [OP_OUT] = eval_out,
+                                       [OP_ADD] = eval_add,
+                                       [OP_SUB] = eval_sub,
+                                       [OP_MUL] = eval_mul,
+                                       [OP_DIV] = eval_div,
+                                       [OP_MOD] = eval_mod,
+                                       [OP_CMP] = eval_cmp,
+                                       [OP_JE]  = eval_je,
+                                       [OP_JNE] = eval_jne,
+                                       [OP_JL]  = eval_jl,
+                                       [OP_JLE] = eval_jle,
+                                       [OP_JG]  = eval_jg,
+                                       [OP_JGE] = eval_jge,
+                                       [OP_JMP] = eval_jmp,
+                                       [OP_SCOPE_OPEN]  = eval_scope_open,
+                                       [OP_SCOPE_CLOSE] = eval_scope_close };
 
 /**
  * @brief evaluate the ASM program.
@@ -262,6 +334,79 @@ static void s_evaluate(instruction_set_st *);
  */
 static void s_usage();
 
+/**
+ * @brief signal handler, request a snapshot on the next back-edge.
+ * @param signo SIGUSR2 for snapshot and continue, SIGTERM for snapshot and exit.
+ */
+static void s_checkpoint_signal(int);
+
+/**
+ * @brief signal handler, request the state on the next back-edge.
+ * @param signo SIGUSR1.
+ */
+static void s_inspect_signal(int);
+
+/**
+ * @brief called on each back-edge, take a snapshot if it is due or requested.
+ * @param target address jumped to.
+ */
+static void s_back_edge(int);
+
+/**
+ * @brief write the state of the program into s_inspect_path, then continue.
+ */
+static void s_inspect();
+
+/**
+ * @brief take a snapshot into s_checkpoint_path.
+ */
+static void s_checkpoint();
+
+/**
+ * @brief write the profile on exit, runtime errors included.
+ */
+static void s_profile_exit();
+
+/**
+ * @brief add up the n-gram counts and write the n-gram report on exit, runtime errors included.
+ */
+static void s_ngram_exit();
+
+/**
+ * @brief stop sampling and write the sample report on exit, runtime errors included.
+ */
+static void s_sample_exit();
+
+/**
+ * @brief write the statistics on exit, runtime errors included.
+ */
+static void s_stats_exit();
+
+/**
+ * @brief end the evaluate phase and finish the timeline on exit, runtime errors included.
+ */
+static void s_timeline_exit();
+
+/**
+ * @brief get the seconds since a point in time.
+ * @param start the point in time, CLOCK_MONOTONIC.
+ * @return seconds elapsed.
+ */
+static double s_seconds_since(const struct timespec *);
+
+/**
+ * @brief sum up the instructions executed by operation into s_stats.executed.
+ */
+static void s_count_executed();
+
+/**
+ * @brief start the trace record of an instruction about to run.
+ * @param pc address of the instruction.
+ * @param instruction the instruction.
+ * @return the record to finish after the instruction runs.
+ */
+static trace_record_st *s_trace_begin(int, instruction_st *);
+
 /**
  * @brief main entrance of runtime.
  * @param argc arguments count.
@@ -271,36 +416,675 @@ static void s_usage();
 int main(int argc, char *argv[])
 {
     struct stat file_stat;
+    struct sigaction action;
+    const char *restore_path = NULL;
+    char *end = NULL;
+    int load_mode = INSTRUCTION_LOAD_EAGER;
+    long load_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *cache_dir = NULL;
+    int cache_verify = 0;
+    unsigned long cache_max_bytes = RESULT_CACHE_MAX_BYTES;
+    unsigned long long cache_min_executed = RESULT_CACHE_MIN_EXECUTED;
+    int exit_status = 0;
+    const char *emit_c_path = NULL;
+    const char *asm_path = NULL;
+    long sample_interval = SAMPLER_DEFAULT_INTERVAL;
+    const char *trace_path = NULL;
+    const char *timeline_path = NULL;
+    double load_timeline = 0;
+    unsigned long long trace_records = TRACE_DEFAULT_RECORDS;
+    struct timespec load_start;
+    FILE *fout = NULL;
+    int option;
+    int rc;
+
+    static struct option long_options[] = {
+        {"checkpoint",       required_argument, NULL, 'c'},
+        {"checkpoint-every", required_argument, NULL, 'n'},
+        {"restore",          required_argument, NULL, 'r'},
+        {"lazy",             no_argument,       NULL, 'l'},
+        {"load-threads",     required_argument, NULL, 't'},
+        {"cache",            required_argument, NULL, 'C'},
+        {"cache-verify",     no_argument,       NULL, 'V'},
+        {"cache-max-bytes",  required_argument, NULL, 'B'},
+        {"cache-min-executed", required_argument, NULL, 'E'},
+        {"emit-c",           required_argument, NULL, 'e'},
+        {"profile",          optional_argument, NULL, 'p'},
+        {"sample",           optional_argument, NULL, 's'},
+        {"sample-interval",  required_argument, NULL, 'i'},
+        {"trace-bin",        required_argument, NULL, 'T'},
+        {"trace-records",    required_argument, NULL, 'R'},
+        {"stats",            optional_argument, NULL, 'S'},
+        {"stats-output",     required_argument, NULL, 'O'},
+        {"perf",             no_argument,       NULL, 'P'},
+        {"trace-out",        required_argument, NULL, 'J'},
+        {"ngrams",           optional_argument, NULL, 'G'},
+        {"ngrams-top",       required_argument, NULL, 'g'},
+        {"inspect-out",      required_argument, NULL, 'D'},
+        {NULL,               0,                 NULL, 0}
+    };
+
+    while ((option = getopt_long(argc, argv, "c:n:r:lt:C:VB:E:e:p::s::i:T:R:S::O:PJ:G::g:D:", long_options, NULL)) != -1) {
+        switch (option) {
+            case 'c':
+                s_checkpoint_path = optarg;
+                break;
+            case 'n':
+                s_checkpoint_every = strtoul(optarg, &end, 10);
+                if (*optarg == '\0' || *end != '\0') {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            case 'r':
+                restore_path = optarg;
+                break;
+            case 'l':
+                load_mode = INSTRUCTION_LOAD_LAZY;
+                break;
+            case 't':
+                load_threads = strtol(optarg, &end, 10);
+                if (*optarg == '\0' || *end != '\0' || load_threads < 1) {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            case 'C':
+                cache_dir = optarg;
+                break;
+            case 'V':
+                cache_verify = 1;
+                break;
+            case 'e':
+                emit_c_path = optarg;
+                break;
+            case 'p':
+                s_profile_prefix = optarg ? optarg : PROFILER_DEFAULT_PREFIX;
+                break;
+            case 'G':
+                s_ngram_prefix = optarg ? optarg : NGRAM_DEFAULT_PREFIX;
+                break;
+            case 'D':
+                s_inspect_path = optarg;
+                break;
+            case 'g':
+                s_ngram_top = strtol(optarg, &end, 10);
+                if (*optarg == '\0' || *end != '\0' || s_ngram_top < 1) {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            case 's':
+                s_sample_prefix = optarg ? optarg : SAMPLER_DEFAULT_PREFIX;
+                break;
+            case 'i':
+                sample_interval = strtol(optarg, &end, 10);
+                if (*optarg == '\0' || *end != '\0' || sample_interval < 1) {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            case 'S':
+                s_stats_format = optarg ? optarg : STATS_FORMAT_JSON;
+                if (strcmp(s_stats_format, STATS_FORMAT_JSON) != 0) {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            case 'O':
+                s_stats_path = optarg;
+                break;
+            case 'P':
+                s_stats.perf_enabled = 1;
+                break;
+            case 'T':
+                trace_path = optarg;
+                break;
+            case 'J':
+                timeline_path = optarg;
+                break;
+            case 'R':
+                trace_records = strtoull(optarg, &end, 10);
+                if (*optarg == '\0' || *end != '\0' || trace_records == 0) {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            case 'B':
+                cache_max_bytes = strtoul(optarg, &end, 10);
+                if (*optarg == '\0' || *end != '\0') {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            case 'E':
+                cache_min_executed = strtoull(optarg, &end, 10);
+                if (*optarg == '\0' || *end != '\0') {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            default:
+                s_usage();
+                return EINVAL;
+        }
+    }
+
+    // the counters only show up in the stats report.
+    if (s_stats.perf_enabled) {
+        if (s_stats_format == NULL)
+            s_stats_format = STATS_FORMAT_JSON;
+        s_perf = perf_counters_init();
+        s_stats.perf_error = perf_counters_get_error(s_perf);
+        perf_counters_start(s_perf);
+    }
+
+    if (timeline_path != NULL) {
+        s_timeline = timeline_open(timeline_path);
+        if (s_timeline == NULL) {
+            rc = errno;
+            fprintf(stderr, "trace %s failed: %s\n", timeline_path, strerror(rc));
+            exit(rc);
+        }
+        atexit(s_timeline_exit);
+        load_timeline = timeline_now(s_timeline);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &load_start);
+
+    if (&g_ten_embedded_image != NULL) {
+        // self-contained executable, the program is linked in.
+        if (optind != argc || emit_c_path != NULL) {
+            s_usage();
+            return EINVAL;
+        }
+
+        s_machine_store = machine_memory_init();
+
+        TEN_SDT_PROBE1(ten, load__start, asm_path);
+        s_instructions = instruction_load_image(&g_ten_embedded_image);
+    } else {
+        if (optind != argc - 1) {
+            s_usage();
+            return 0;
+        }
+
+        if (stat(argv[optind], &file_stat) != 0) {
+            fprintf(stderr, "%s\n", strerror(errno));
+            exit(errno);
+        }
 
-    if (argc != 2) {
-        s_usage();
-        return 0;
+        s_machine_store = machine_memory_init();
+
+        if (load_threads < 1)
+            load_threads = 1;
+
+        asm_path = argv[optind];
+        TEN_SDT_PROBE1(ten, load__start, asm_path);
+        s_instructions = instruction_load_program(asm_path, load_mode, load_threads);
     }
 
-    if (stat(argv[1], &file_stat) != 0) {
-        fprintf(stderr, "%s\n", strerror(errno));
-        exit(errno);
+    TEN_SDT_PROBE2(ten, load__end, asm_path, instruction_set_get_count(s_instructions));
+    s_stats.load_seconds = s_seconds_since(&load_start);
+    perf_counters_stop(s_perf, &s_stats.perf_load);
+    if (s_timeline != NULL)
+        timeline_phase(s_timeline, "load", load_timeline);
+
+    if (emit_c_path != NULL) {
+        fout = fopen(emit_c_path, "w");
+        if (fout == NULL) {
+            fprintf(stderr, "%s: %s\n", emit_c_path, strerror(errno));
+            exit(errno);
+        }
+        rc = instruction_set_emit_c(s_instructions, fout, "g_ten_embedded_image");
+        if (fclose(fout) != 0 && rc == 0)
+            rc = errno;
+        if (rc != 0) {
+            fprintf(stderr, "%s: %s\n", emit_c_path, strerror(rc));
+            unlink(emit_c_path);
+        }
+        instruction_clean_up(s_instructions);
+        machine_memory_fini(s_machine_store);
+        return rc;
     }
 
-    s_machine_store = machine_memory_init();
+    // the profilers and the tracers observe the run, so they run it as --cache-verify does.
+    if (s_profile_prefix != NULL || s_ngram_prefix != NULL || s_sample_prefix != NULL ||
+        trace_path != NULL || s_timeline != NULL)
+        cache_verify = 1;
+
+    // a resumed run only produces part of the output, it is never cached.
+    if (cache_dir != NULL && restore_path == NULL) {
+        s_result_cache = result_cache_init(cache_dir, instruction_set_get_hash(s_instructions),
+                                           cache_max_bytes);
+        if (!cache_verify && result_cache_replay(s_result_cache, &exit_status) == 0) {
+            s_stats.cached = 1;
+            s_stats.completed = 1;
+            s_stats_exit();
+            result_cache_fini(s_result_cache);
+            instruction_clean_up(s_instructions);
+            machine_memory_fini(s_machine_store);
+            return exit_status;
+        }
+    }
+
+    if (s_profile_prefix != NULL) {
+        s_profiler = profiler_init(s_instructions);
+        atexit(s_profile_exit);
+    }
 
-    s_instructions = instruction_load_program(argv[1]);
+    if (s_ngram_prefix != NULL) {
+        s_ngram = ngram_init();
+        atexit(s_ngram_exit);
+    }
 
+    if (s_sample_prefix != NULL) {
+        s_sampler = sampler_init(s_instructions, asm_path, &s_pc);
+        rc = sampler_start(s_sampler, sample_interval);
+        if (rc != 0) {
+            fprintf(stderr, "sample failed: %s\n", strerror(rc));
+            exit(rc);
+        }
+        atexit(s_sample_exit);
+    }
+
+    if (trace_path != NULL) {
+        s_trace = trace_create(trace_path, trace_records, s_instructions);
+        if (s_trace == NULL) {
+            rc = errno;
+            fprintf(stderr, "trace %s failed: %s\n", trace_path, strerror(rc));
+            exit(rc);
+        }
+    }
+
+    if (restore_path != NULL) {
+        rc = checkpoint_restore(restore_path, s_instructions, s_machine_store);
+        if (rc != 0) {
+            fprintf(stderr, "restore %s failed: %s\n", restore_path, strerror(rc));
+            exit(rc);
+        }
+    }
+
+    // a look at the program on SIGUSR1, output in progress is not interrupted.
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = s_inspect_signal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, NULL);
+
+    if (s_checkpoint_path != NULL) {
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = s_checkpoint_signal;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGUSR2, &action, NULL);
+        sigaction(SIGTERM, &action, NULL);
+    }
+
+    if (s_stats_format != NULL)
+        atexit(s_stats_exit);
+
+    clock_gettime(CLOCK_MONOTONIC, &s_run_start);
+    if (s_perf != NULL) {
+        perf_counters_start(s_perf);
+        s_perf_running = 1;
+    }
+    if (s_timeline != NULL)
+        s_evaluate_start = timeline_now(s_timeline);
     s_evaluate(s_instructions);
+    s_stats.completed = 1;
+    s_stats_exit();
+    s_timeline_exit();
+    perf_counters_fini(s_perf);
+    s_perf = NULL;
+
+    if (s_trace != NULL) {
+        trace_close(s_trace);
+        s_trace = NULL;
+    }
+
+    if (s_sampler != NULL) {
+        s_sample_exit();
+        sampler_fini(s_sampler);
+        s_sampler = NULL;
+    }
+
+    if (s_profiler != NULL) {
+        s_profile_exit();
+        profiler_fini(s_profiler);
+        s_profiler = NULL;
+    }
+
+    if (s_ngram != NULL) {
+        s_ngram_exit();
+        ngram_fini(s_ngram);
+        s_ngram = NULL;
+    }
+
+    // only a clean exit reaches here, runtime errors exit on the spot.
+    if (s_result_cache != NULL) {
+        fflush(stdout);
+        if (cache_verify && result_cache_verify(s_result_cache, 0) == EBADMSG) {
+            fprintf(stderr, "cache verify failed: output differs from the cached one\n");
+            exit_status = EX_SOFTWARE;
+        }
+        // a stale entry is replaced by this run, whatever its length.
+        if (s_stats.executed >= cache_min_executed || exit_status == EX_SOFTWARE)
+            result_cache_store(s_result_cache, 0, s_stats.executed);
+        result_cache_fini(s_result_cache);
+    }
 
     instruction_clean_up(s_instructions);
 
     machine_memory_fini(s_machine_store);
 
-    return 0;
+    return exit_status;
 }
 /**
  * @brief print out the usage information of runtime.
  */
 static void s_usage() {
     printf("Usage:\n");
-    printf("./runtime <input file>\n");
-    printf("e.g ./runtime program1.asm\n");
+    if (&g_ten_embedded_image != NULL) {
+        printf("./<program> [options]\n");
+    } else {
+        printf("./runtime [options] <input file>\n");
+        printf("e.g ./runtime program1.asm\n");
+    }
+    printf("Options:\n");
+    printf("  --checkpoint <file>         snapshot file, written on SIGUSR2 (continue)\n");
+    printf("                              or SIGTERM (exit %d)\n", EX_TEMPFAIL);
+    printf("  --checkpoint-every <n>      also write the snapshot every n back-edges\n");
+    printf("  --restore <file>            resume the program from a snapshot\n");
+    printf("  --inspect-out <file>        append the state written on SIGUSR1 to the file,\n");
+    printf("                              default stderr, then continue\n");
+    if (&g_ten_embedded_image == NULL) {
+        // the embedded program is decoded already.
+        printf("  --lazy                      decode an instruction the first time it runs\n");
+        printf("  --load-threads <n>          threads for loading large programs,\n");
+        printf("                              default one per online cpu\n");
+    }
+    printf("  --profile[=<prefix>]        count executions, write <prefix>.report and\n");
+    printf("                              <prefix>.folded on exit, default prefix \"%s\"\n",
+                                          PROFILER_DEFAULT_PREFIX);
+    printf("  --ngrams[=<prefix>]         count the sequences of 2 to 4 operations, add them up\n");
+    printf("                              in <prefix>.counts over runs, write the top ones to\n");
+    printf("                              <prefix>.report on exit, default prefix \"%s\"\n",
+                                          NGRAM_DEFAULT_PREFIX);
+    printf("  --ngrams-top <n>            sequences listed per table, default %d\n",
+                                          NGRAM_DEFAULT_TOP);
+    printf("  --sample[=<prefix>]         sample the running line every interval of cpu time,\n");
+    printf("                              write <prefix>.report on exit, default prefix \"%s\"\n",
+                                          SAMPLER_DEFAULT_PREFIX);
+    printf("  --sample-interval <usec>    microseconds between samples, default %d\n",
+                                          SAMPLER_DEFAULT_INTERVAL);
+    printf("  --trace-bin <file>          record every instruction into a binary ring file,\n");
+    printf("                              read it with trace-analyze\n");
+    printf("  --trace-records <n>         capacity of the ring, default %d records\n",
+                                          TRACE_DEFAULT_RECORDS);
+    printf("  --trace-out <file>          write a timeline of the load, the run, each loop\n");
+    printf("                              and the output in Chrome trace format\n");
+    printf("  --stats[=json]              write the counters of the run on exit\n");
+    printf("  --stats-output <file>       append the counters to file, default stderr\n");
+    printf("  --perf                      add hardware counters of the load and the run\n");
+    printf("                              to the stats report, implies --stats\n");
+    if (&g_ten_embedded_image == NULL)
+        printf("  --emit-c <file>             write the decoded program as C source and exit\n");
+    printf("  --cache <dir>               replay the output of an earlier run of the program\n");
+    printf("  --cache-verify              run anyway, fail (exit %d) if the output differs\n",
+                                          EX_SOFTWARE);
+    printf("  --cache-max-bytes <n>       don't cache output over n bytes, default %d\n",
+                                          RESULT_CACHE_MAX_BYTES);
+    printf("  --cache-min-executed <n>    don't cache runs under n instructions, default %d\n",
+                                          RESULT_CACHE_MIN_EXECUTED);
+}
+
+/**
+ * @brief signal handler, request a snapshot on the next back-edge.
+ * @param signo SIGUSR2 for snapshot and continue, SIGTERM for snapshot and exit.
+ */
+static void s_checkpoint_signal(int signo) {
+    if (signo == SIGTERM)
+        s_exit_request = 1;
+    s_checkpoint_request = 1;
+}
+
+/**
+ * @brief signal handler, request the state on the next back-edge.
+ * @param signo SIGUSR1.
+ */
+static void s_inspect_signal(int signo) {
+    (void)signo;
+    s_inspect_request = 1;
+}
+
+/**
+ * @brief called on each back-edge, take a snapshot if it is due or requested.
+ * @param target address jumped to.
+ */
+static void s_back_edge(int target) {
+    s_back_edges++;
+
+    if (s_timeline != NULL)
+        timeline_back_edge(s_timeline, target);
+
+    if (s_inspect_request) {
+        s_inspect_request = 0;
+        s_inspect();
+    }
+
+    if (s_checkpoint_path == NULL)
+        return;
+
+    if (s_checkpoint_request ||
+        (s_checkpoint_every != 0 && s_back_edges % s_checkpoint_every == 0)) {
+        s_checkpoint_request = 0;
+        s_checkpoint();
+        if (s_exit_request)
+            exit(EX_TEMPFAIL);
+    }
+}
+
+/**
+ * @brief take a snapshot into s_checkpoint_path.
+ */
+static void s_checkpoint() {
+    int rc;
+
+    // output before the snapshot must not be lost, nor repeated after restore.
+    fflush(stdout);
+    rc = checkpoint_save(s_checkpoint_path, s_instructions, s_machine_store);
+    if (rc != 0)
+        fprintf(stderr, "checkpoint %s failed: %s\n", s_checkpoint_path, strerror(rc));
+}
+
+/**
+ * @brief write the state of the program into s_inspect_path, then continue.
+ */
+static void s_inspect() {
+    FILE *fout = stderr;
+    int rc;
+
+    if (s_inspect_path != NULL) {
+        fout = fopen(s_inspect_path, "a");
+        if (fout == NULL) {
+            fprintf(stderr, "inspect %s failed: %s\n", s_inspect_path, strerror(errno));
+            return;
+        }
+    }
+
+    s_count_executed();
+    rc = inspect_write(fout, s_instructions, s_machine_store, s_stats.executed);
+    if (fout != stderr && fclose(fout) != 0 && rc == 0)
+        rc = errno;
+    if (rc != 0)
+        fprintf(stderr, "inspect failed: %s\n", strerror(rc));
+}
+
+/**
+ * @brief write the profile on exit, runtime errors included.
+ */
+static void s_profile_exit() {
+    int rc;
+
+    if (s_profiler == NULL)
+        return;
+
+    rc = profiler_write(s_profiler, s_profile_prefix);
+    if (rc != 0)
+        fprintf(stderr, "profile %s failed: %s\n", s_profile_prefix, strerror(rc));
+}
+
+/**
+ * @brief add up the n-gram counts and write the n-gram report on exit, runtime errors included.
+ */
+static void s_ngram_exit() {
+    int rc;
+
+    if (s_ngram == NULL)
+        return;
+
+    rc = ngram_write(s_ngram, s_ngram_prefix, s_ngram_top);
+    if (rc != 0)
+        fprintf(stderr, "ngrams %s failed: %s\n", s_ngram_prefix, strerror(rc));
+}
+
+/**
+ * @brief stop sampling and write the sample report on exit, runtime errors included.
+ */
+static void s_sample_exit() {
+    int rc;
+
+    if (s_sampler == NULL)
+        return;
+
+    rc = sampler_write(s_sampler, s_sample_prefix);
+    if (rc != 0)
+        fprintf(stderr, "sample %s failed: %s\n", s_sample_prefix, strerror(rc));
+}
+
+/**
+ * @brief write the statistics on exit, runtime errors included.
+ */
+static void s_stats_exit() {
+    struct rusage usage;
+    FILE *fout = stderr;
+    int rc;
+
+    if (s_stats_format == NULL)
+        return;
+
+    if (s_perf_running) {
+        perf_counters_stop(s_perf, &s_stats.perf_run);
+        s_perf_running = 0;
+    }
+
+    s_count_executed();
+    if (s_run_start.tv_sec != 0 || s_run_start.tv_nsec != 0)
+        s_stats.run_seconds = s_seconds_since(&s_run_start);
+    machine_memory_get_stats(s_machine_store, &s_stats.memory);
+    s_stats.instructions = instruction_set_get_count(s_instructions);
+    s_stats.labels = instruction_set_get_label_count(s_instructions);
+    s_stats.labels_resolved = instruction_set_get_resolved_count(s_instructions);
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+        s_stats.max_rss_kb = usage.ru_maxrss;
+
+    if (s_stats_path != NULL) {
+        fout = fopen(s_stats_path, "a");
+        if (fout == NULL) {
+            fprintf(stderr, "stats %s failed: %s\n", s_stats_path, strerror(errno));
+            s_stats_format = NULL;
+            return;
+        }
+    }
+
+    rc = stats_write_json(fout, &s_stats);
+    if (fout != stderr && fclose(fout) != 0 && rc == 0)
+        rc = errno;
+    if (rc != 0)
+        fprintf(stderr, "stats failed: %s\n", strerror(rc));
+
+    // written once, by the clean exit or else by the atexit handler.
+    s_stats_format = NULL;
+}
+
+/**
+ * @brief end the evaluate phase and finish the timeline on exit, runtime errors included.
+ */
+static void s_timeline_exit() {
+    int rc;
+
+    if (s_timeline == NULL)
+        return;
+
+    timeline_stop(s_timeline);
+    if (s_evaluate_start >= 0)
+        timeline_phase(s_timeline, "evaluate", s_evaluate_start);
+
+    rc = timeline_close(s_timeline);
+    if (rc != 0)
+        fprintf(stderr, "trace failed: %s\n", strerror(rc));
+
+    // written once, by the clean exit or else by the atexit handler.
+    s_timeline = NULL;
+}
+
+/**
+ * @brief sum up the instructions executed by operation into s_stats.executed.
+ */
+static void s_count_executed() {
+    int i;
+
+    // counted by operation only, the hot loop keeps one counter.
+    s_stats.executed = 0;
+    for (i = 0; i < OP_COUNT; i++)
+        s_stats.executed += s_stats.op_executed[i];
+}
+
+/**
+ * @brief get the seconds since a point in time.
+ * @param start the point in time, CLOCK_MONOTONIC.
+ * @return seconds elapsed.
+ */
+static double s_seconds_since(const struct timespec *start) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) + (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/**
+ * @brief start the trace record of an instruction about to run.
+ * @param pc address of the instruction.
+ * @param instruction the instruction.
+ * @return the record to finish after the instruction runs.
+ */
+static trace_record_st *s_trace_begin(int pc, instruction_st *instruction) {
+    trace_record_st *record = trace_append(s_trace);
+    memory_st *variable_memory;
+    char *variable_name;
+    int which;
+
+    record->pc = pc;
+    record->next_pc = -1;
+    record->op_type = instruction_get_op_type(instruction);
+    record->depth = machine_memory_get_scope(s_machine_store);
+    record->flag = instruction_set_get_flag(s_instructions);
+
+    // operands are read without the checks, DEC names a variable not declared yet.
+    for (which = OPERAND_FIRST; which <= OPERAND_SECOND; which++) {
+        record->values[which] = 0;
+        if (instruction_get_operand_kind(instruction, which) == OPERAND_IMMEDIATE) {
+            record->values[which] = instruction_get_operand_value(instruction, which);
+        } else if (instruction_get_operand_kind(instruction, which) == OPERAND_VARIABLE) {
+            variable_name = (which == OPERAND_FIRST) ? instruction_get_op_first(instruction) :
+                                                       instruction_get_op_second(instruction);
+            variable_memory = machine_memory_peek_variable(s_machine_store, variable_name);
+            if (variable_memory != NULL)
+                record->values[which] = memory_get_value(variable_memory);
+        }
+    }
+
+    return record;
 }
 
 /**
@@ -309,63 +1093,104 @@ static void s_usage() {
  */
 static void s_evaluate(instruction_set_st *instructions) {
     instruction_st *next_inst = NULL;
-    char *op_code = NULL;
-    char *op_first = NULL;
-    char *op_second = NULL;
-    int i;
+    trace_record_st *record = NULL;
+    int op_type;
+    int pc;
 
     if (instructions == NULL)
         exit(EINVAL);
 
-    while ((next_inst = instruction_set_get_instruction(instructions)) != NULL) {
-        op_code = instruction_get_op_code(next_inst);
-        op_first = instruction_get_op_first(next_inst);
-        op_second = instruction_get_op_second(next_inst);
+    while ((pc = instruction_set_get_pc(instructions),
+            next_inst = instruction_set_get_instruction(instructions)) != NULL) {
 #ifdef DEBUG
-        fprintf(stderr, "code: %s, first: %s, second: %s\n", op_code, op_first, op_second );
+        fprintf(stderr, "code: %s, first: %s, second: %s\n",
+                        instruction_get_op_code(next_inst),
+                        instruction_get_op_first(next_inst),
+                        instruction_get_op_second(next_inst));
 #endif
-        if (op_code == NULL) {
+        if (instruction_get_op_code(next_inst) == NULL) {
             fprintf(stderr, "Fetch failed\n");
             exit(EINVAL);
         }
-        // find method for op_code
-        i = 0;
-        while (g_operations[i].op_code != NULL) {
-            if (strcmp(op_code, g_operations[i].op_code) == 0) {
-                g_operations[i].eval_func(op_first, op_second);
-                break;
-            }
-            i++;
-        }
 
-        if (g_operations[i].op_code == NULL) {
-#ifdef DEBUG
-            fprintf(stderr, "label change scope\n");
-#endif
-            // label change scope.(for1: scope++, for1_end: scope--)
-            if (strstr(op_code, "_end:"))
-                machine_memory_close_scope(s_machine_store);
-            else
-                machine_memory_open_scope(s_machine_store);
+        if (s_trace != NULL)
+            record = s_trace_begin(pc, next_inst);
+
+        op_type = instruction_get_op_type(next_inst);
+        s_pc = pc;
+        g_operations[op_type](next_inst);
+        s_stats.op_executed[op_type]++;
+
+        if (record != NULL) {
+            record->next_pc = instruction_set_get_pc(instructions);
+            record->depth = machine_memory_get_scope(s_machine_store);
+            record->flag = instruction_set_get_flag(instructions);
         }
+
+        if (s_profiler != NULL)
+            profiler_count(s_profiler, pc, instruction_set_get_pc(instructions));
+
+        if (s_ngram != NULL)
+            ngram_count(s_ngram, next_inst);
+
+        // jumping backward closes a loop iteration.
+        if (instruction_set_get_pc(instructions) <= pc)
+            s_back_edge(instruction_set_get_pc(instructions));
+    }
+
+    s_count_executed();
+}
+
+/**
+ * @brief get the value of an operand, a variable or an immediate.
+ * @param instruction a decoded instruction.
+ * @param which OPERAND_FIRST or OPERAND_SECOND.
+ * @return value of the operand, exit if the variable is undeclared.
+ */
+static int s_operand_value(instruction_st *instruction, int which) {
+    memory_st *variable_memory;
+    char *variable_name = NULL;
+
+    if (instruction_get_operand_kind(instruction, which) != OPERAND_VARIABLE)
+        return instruction_get_operand_value(instruction, which);
+
+    variable_name = (which == OPERAND_FIRST) ? instruction_get_op_first(instruction) :
+                                               instruction_get_op_second(instruction);
+    // check variable on ALL scope, if doesn't exist, warning and exit.
+    variable_memory = machine_memory_get_variable(s_machine_store,
+                                                  variable_name,
+                                                  MEMORY_ALL_SCOPE);
+    if (variable_memory == NULL) {
+        fprintf(stderr, "Using undeclared variables %s! Exit\n", variable_name);
+        exit(EINVAL);
     }
+
+    return memory_get_value(variable_memory);
+}
+
+/**
+ * @brief check if a label belongs to a loop, e.g. "for1:" or "for1_end:".
+ * @param instruction a decoded label.
+ * @return 1 for a loop label; otherwise 0.
+ */
+static int s_is_loop(instruction_st *instruction) {
+    return strncmp(instruction_get_op_code(instruction), "for", 3) == 0;
 }
 
 /**
  * @brief evaluate function of "DEC" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_dec(void *first_operand, void *second_operand) {
+static void eval_dec(instruction_st *instruction) {
     memory_st *variable_memory;
     char *variable_name = NULL;
 
-    if (first_operand == NULL)
+    variable_name = instruction_get_op_first(instruction);
+    if (variable_name == NULL)
         return;
 
-    variable_name = (char *)first_operand;
     // check on this scope, if exist warning redefine and exit.
-    variable_memory = machine_memory_get_variable(s_machine_store, 
+    variable_memory = machine_memory_get_variable(s_machine_store,
                                                     variable_name,
                                                     MEMORY_CURRENT_SCOPE);
     if (variable_memory != NULL) {
@@ -373,7 +1198,7 @@ static void eval_dec(void *first_operand, void *second_operand) {
     }
 
     // doesn't exist, create a new one.
-    if (machine_memory_set_variable(s_machine_store, variable_name, 
+    if (machine_memory_set_variable(s_machine_store, variable_name,
                                     0, MEMORY_CURRENT_SCOPE) != 0) {
         fprintf(stderr, "Can't not create new variable.\n");
         exit(ENOMEM);
@@ -383,116 +1208,96 @@ static void eval_dec(void *first_operand, void *second_operand) {
 
 /**
  * @brief evaluate function of "OUT" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_out(void *first_operand, void *second_operand) {
-    memory_st *variable_memory;
-    char *var_one = NULL;
-    int value = 0;
+static void eval_out(instruction_st *instruction) {
+    char output[16];
+    int length;
+    int value;
 
-    if (first_operand == NULL)
+    if (instruction_get_operand_kind(instruction, OPERAND_FIRST) == OPERAND_NONE)
         return;
 
-    var_one = (char *)first_operand;
+    value = s_operand_value(instruction, OPERAND_FIRST);
+    TEN_SDT_PROBE2(ten, out, s_pc, value);
+    if (s_timeline != NULL)
+        timeline_out(s_timeline);
 
-    if (isalpha(var_one[0]) || var_one[0] == '_') {
-        // check var_one on ALL scope, if doesn't exist, warning and exit.
-        variable_memory = machine_memory_get_variable(s_machine_store, 
-                                                      var_one, 
-                                                      MEMORY_ALL_SCOPE);
-        if (variable_memory == NULL) {
-            fprintf(stderr, "Using undeclared variables! Exit\n");
-            exit(EINVAL);
-        }
-        // value 
-        value = memory_get_value(variable_memory);
-    } else {
-        value = atoi(var_one);
-    }
+    length = snprintf(output, sizeof(output), "%d\n", value);
+    fwrite(output, 1, length, stdout);
 
-    printf("%d\n", value);
+    if (s_result_cache != NULL)
+        result_cache_capture(s_result_cache, output, length);
 }
 
 /**
  * @brief evaluate function of "MOV" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_mov(void *first_operand, void *second_operand) {
-    eval_bin_op_helper(first_operand, second_operand, '=');
+static void eval_mov(instruction_st *instruction) {
+    eval_bin_op_helper(instruction, '=');
 }
 
 /**
  * @brief evaluate function of "ADD" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_add(void *first_operand, void *second_operand) {
-    eval_bin_op_helper(first_operand, second_operand, '+');
+static void eval_add(instruction_st *instruction) {
+    eval_bin_op_helper(instruction, '+');
 }
 
 /**
  * @brief evaluate function of "SUB" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_sub(void *first_operand, void *second_operand) {
-    eval_bin_op_helper(first_operand, second_operand, '-');
+static void eval_sub(instruction_st *instruction) {
+    eval_bin_op_helper(instruction, '-');
 }
 
 /**
  * @brief evaluate function of "MUL" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_mul(void *first_operand, void *second_operand) {
-    eval_bin_op_helper(first_operand, second_operand, '*');
+static void eval_mul(instruction_st *instruction) {
+    eval_bin_op_helper(instruction, '*');
 }
 
 /**
  * @brief evaluate function of "DIV" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_div(void *first_operand, void *second_operand) {
-    eval_bin_op_helper(first_operand, second_operand, '/');
+static void eval_div(instruction_st *instruction) {
+    eval_bin_op_helper(instruction, '/');
 }
 
 /**
  * @brief evaluate function of "MOD" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_mod(void *first_operand, void *second_operand) {
-    eval_bin_op_helper(first_operand, second_operand, '%');
+static void eval_mod(instruction_st *instruction) {
+    eval_bin_op_helper(instruction, '%');
 }
 
 /**
  * @brief evaluate function of all binary operations
- * @param first_operand, first operand.
- * @param second_operand, second operand.
+ * @param instruction a decoded instruction.
  * @param op_type operation type.(+ - * / % =)
  */
-static void eval_bin_op_helper(void *first_operand, 
-                               void *second_operand, 
-                               char op_type) {
+static void eval_bin_op_helper(instruction_st *instruction, char op_type) {
     memory_st *var_mem_one;
-    memory_st *var_mem_two;
     char *var_one = NULL;
-    char *var_two = NULL;
     int value_one = 0;
     int value_two = 0;
 
-    if (first_operand == NULL || second_operand == NULL)
+    if (instruction_get_operand_kind(instruction, OPERAND_FIRST) == OPERAND_NONE ||
+        instruction_get_operand_kind(instruction, OPERAND_SECOND) == OPERAND_NONE)
         return;
 
-    var_one = (char *)first_operand;
-    var_two = (char *)second_operand;
+    var_one = instruction_get_op_first(instruction);
 
     // check var_one on ALL scope, if doesn't exist, warning and exit.
-    var_mem_one = machine_memory_get_variable(s_machine_store, 
-                                              var_one, 
+    var_mem_one = machine_memory_get_variable(s_machine_store,
+                                              var_one,
                                               MEMORY_ALL_SCOPE);
     if (var_mem_one == NULL) {
         fprintf(stderr, "Using undeclared variables %s! Exit\n", var_one);
@@ -501,21 +1306,8 @@ static void eval_bin_op_helper(void *first_operand,
     // value_one = from var_one on the storage.
     value_one = memory_get_value(var_mem_one);
 
-    if (isalpha(var_two[0]) || var_two[0] == '_') {
-        // check var_two on ALL scope, if doesn't exist, warning and exit.
-        var_mem_two = machine_memory_get_variable(s_machine_store, 
-                                                  var_two, 
-                                                  MEMORY_ALL_SCOPE);
-        if (var_mem_two == NULL) {
-            fprintf(stderr, "Using undeclared variables %s! Exit\n", var_two);
-            exit(EINVAL);
-        }
-        // value_two = from var_two on the storage.
-        value_two = memory_get_value(var_mem_two);
-    } else {
-        value_two = atoi(second_operand);
-    }
- 
+    value_two = s_operand_value(instruction, OPERAND_SECOND);
+
     switch (op_type) {
         case '+':
             value_one += value_two;
@@ -539,59 +1331,25 @@ static void eval_bin_op_helper(void *first_operand,
             exit(EPERM);
             break;
     }
-    
+
     // put value into the var_one.
     memory_set_value(var_mem_one, value_one);
 }
 
 /**
  * @brief evaluate function of "CMP" instruction
- * @param first first operand.
- * @param second second operand.
+ * @param instruction a decoded instruction.
  */
-static void eval_cmp(void *first_operand, void *second_operand) {
-    memory_st *var_mem_one;
-    memory_st *var_mem_two;
-    char *var_one = NULL;
-    char *var_two = NULL;
+static void eval_cmp(instruction_st *instruction) {
     int value_one = 0;
     int value_two = 0;
 
-    if (first_operand == NULL || second_operand == NULL)
+    if (instruction_get_operand_kind(instruction, OPERAND_FIRST) == OPERAND_NONE ||
+        instruction_get_operand_kind(instruction, OPERAND_SECOND) == OPERAND_NONE)
         return;
 
-    var_one = (char *)first_operand;
-    var_two = (char *)second_operand;
-
-    if (isalpha(var_one[0]) || var_one[0] == '_') {
-        // check var_one on ALL scope, if doesn't exist, warning and exit.
-        var_mem_one = machine_memory_get_variable(s_machine_store, 
-                                                  var_one, 
-                                                  MEMORY_ALL_SCOPE);
-        if (var_mem_one == NULL) {
-            fprintf(stderr, "Using undeclared variables %s! Exit\n", var_one);
-            exit(EINVAL);
-        }
-        // value_one = from var_one on the storage.
-        value_one = memory_get_value(var_mem_one);
-    } else {
-        value_one = atoi(var_one);
-    }
-
-    if (isalpha(var_two[0]) || var_two[0] == '_') {
-        // check var_two on ALL scope, if doesn't exist, warning and exit.
-        var_mem_two = machine_memory_get_variable(s_machine_store, 
-                                                  var_two, 
-                                                  MEMORY_ALL_SCOPE);
-        if (var_mem_two == NULL) {
-            fprintf(stderr, "Using undeclared variables %s! Exit\n", var_two);
-            exit(EINVAL);
-        }
-        // value_two = from var_two on the storage.
-        value_two = memory_get_value(var_mem_two);
-    } else {
-        value_two = atoi(second_operand);
-    }
+    value_one = s_operand_value(instruction, OPERAND_FIRST);
+    value_two = s_operand_value(instruction, OPERAND_SECOND);
 #ifdef DEBUG
     fprintf(stderr, "cmp result: %d\n", value_one - value_two);
 #endif
@@ -601,88 +1359,115 @@ static void eval_cmp(void *first_operand, void *second_operand) {
 
 /**
  * @brief evaluate function of "JE" instruction
- * @param flag flag value.
+ * @param instruction a decoded instruction.
  */
-static void eval_je(void *first_operand, void *second_operand) {
-    eval_bool_op_helper(first_operand, second_operand, cmp_je);
+static void eval_je(instruction_st *instruction) {
+    eval_bool_op_helper(instruction, cmp_je);
 }
 
 /**
  * @brief evaluate function of "JNE" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_jne(void *first_operand, void *second_operand) {
-    eval_bool_op_helper(first_operand, second_operand, cmp_jne);
+static void eval_jne(instruction_st *instruction) {
+    eval_bool_op_helper(instruction, cmp_jne);
 }
 
 /**
  * @brief evaluate function of "JL" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_jl(void *first_operand, void *second_operand) {
-    eval_bool_op_helper(first_operand, second_operand, cmp_jl);
+static void eval_jl(instruction_st *instruction) {
+    eval_bool_op_helper(instruction, cmp_jl);
 }
 
 /**
  * @brief evaluate function of "JLE" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_jle(void *first_operand, void *second_operand) {
-    eval_bool_op_helper(first_operand, second_operand, cmp_jle);
+static void eval_jle(instruction_st *instruction) {
+    eval_bool_op_helper(instruction, cmp_jle);
 }
 
 /**
  * @brief evaluate function of "JG" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_jg(void *first_operand, void *second_operand) {
-    eval_bool_op_helper(first_operand, second_operand, cmp_jg);
+static void eval_jg(instruction_st *instruction) {
+    eval_bool_op_helper(instruction, cmp_jg);
 }
 
 /**
  * @brief evaluate function of "JGE" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
  */
-static void eval_jge(void *first_operand, void *second_operand) {
-    eval_bool_op_helper(first_operand, second_operand, cmp_jge);
+static void eval_jge(instruction_st *instruction) {
+    eval_bool_op_helper(instruction, cmp_jge);
 }
 
 /**
  * @brief evaluate function of "JMP" instruction
- * @param first label.
- * @param second unused, will ignore.
+ * @param instruction a decoded instruction.
+ */
+static void eval_jmp(instruction_st *instruction) {
+    eval_bool_op_helper(instruction, cmp_jmp);
+}
+
+/**
+ * @brief evaluate function of labels, open a new scope.
+ * @param instruction a decoded instruction.
+ */
+static void eval_scope_open(instruction_st *instruction) {
+#ifdef DEBUG
+    fprintf(stderr, "label change scope\n");
+#endif
+    machine_memory_open_scope(s_machine_store);
+
+    if (s_timeline != NULL && s_is_loop(instruction))
+        timeline_loop_enter(s_timeline, s_pc, instruction_get_op_code(instruction));
+    if (TEN_SDT_ENABLED(ten, loop__enter) && s_is_loop(instruction))
+        TEN_SDT_PROBE3(ten, loop__enter, s_pc, instruction_get_op_code(instruction),
+                       machine_memory_get_scope(s_machine_store));
+}
+
+/**
+ * @brief evaluate function of end labels, close current scope.
+ * @param instruction a decoded instruction.
  */
-static void eval_jmp(void *first_operand, void *second_operand) {
-    eval_bool_op_helper(first_operand, second_operand, cmp_jmp);
+static void eval_scope_close(instruction_st *instruction) {
+#ifdef DEBUG
+    fprintf(stderr, "label change scope\n");
+#endif
+    if (TEN_SDT_ENABLED(ten, loop__exit) && s_is_loop(instruction))
+        TEN_SDT_PROBE3(ten, loop__exit, s_pc, instruction_get_op_code(instruction),
+                       machine_memory_get_scope(s_machine_store));
+    if (s_timeline != NULL && s_is_loop(instruction))
+        timeline_loop_exit(s_timeline);
+
+    machine_memory_close_scope(s_machine_store);
 }
 
 /**
  * @brief evaluate function of all boolean operations
- * @param first_operand, first operand.
- * @param second_operand, second operand.
+ * @param instruction a decoded instruction.
  * @param flag_cmp call back function on different comparing behavior on flag
  */
-static void eval_bool_op_helper(void *first_operand, 
-                               void *second_operand, 
-                               cmp_cb flag_cmp) {
-    char *label = NULL;
+static void eval_bool_op_helper(instruction_st *instruction, cmp_cb flag_cmp) {
     int flag = 0;
-    unsigned int new_pc = 0;
+    int new_pc = 0;
 
-    if (first_operand == NULL || flag_cmp == NULL)
+    if (instruction_get_op_first(instruction) == NULL || flag_cmp == NULL)
         return;
 
     // get flag from instructions set.
     flag = instruction_set_get_flag(s_instructions);
 
-    // lookup target label.
-    label = (char *)first_operand;
-    new_pc = instruction_set_get_label(s_instructions, label);
+    // target label resolved on decoding.
+    new_pc = instruction_get_target(instruction);
+    if (new_pc == INSTRUCTION_NO_TARGET) {
+        fprintf(stderr, "Invalid label.\n");
+        exit(EPERM);
+    }
 
     // set program counter if condition matched.
     if (flag_cmp(flag)) {
@@ -0,0 +1,475 @@
+/**
+ * @file sampler.c
+ * @brief Purpose: sample the running instruction on a cpu timer and
+ *        attribute the samples to the lines of the source.
+ *
+ * ITIMER_PROF raises SIGPROF every interval of cpu time, the handler bumps
+ * the counter of the running instruction, whose address the interpreter
+ * keeps for it. The interpreter pays one store per instruction. The compiler writes a line table next to the byte
+ * code, "source <path>" then one "pc line column" per instruction, which
+ * is read only when the report is written.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <sys/time.h>
+
+#include "sampler.h"
+
+#define HOT_INSTRUCTIONS        (20)                /**< instructions listed in the report */
+#define LINE_TABLE_SUFFIX       ".lines"            /**< suffix of the line table */
+#define SOURCE_TAG              "source "           /**< first line of the line table */
+
+struct sampler {
+    instruction_set_st *instructions;               /**< the sampled program */
+    const volatile sig_atomic_t *pc;                /**< address of the running instruction */
+    int count;                                      /**< total of instructions */
+    uint64_t *counts;                               /**< samples of each instruction */
+    uint64_t outside;                               /**< samples outside the program */
+    uint64_t total;                                 /**< all samples */
+    long interval;                                  /**< microseconds between samples */
+    char *table_path;                               /**< path of the line table, NULL for none */
+    char *source_path;                              /**< path of the source, from the line table */
+    int *lines;                                     /**< source line of each instruction, 0 for none */
+    int *columns;                                   /**< source column of each instruction */
+    int max_line;                                   /**< last line in the line table */
+    uint64_t *line_counts;                          /**< samples of each source line */
+    char **source;                                  /**< text of the source lines, NULL if unreadable */
+    struct sigaction saved;                         /**< SIGPROF action before start */
+    int running;                                    /**< 1 if the timer is armed */
+};
+
+/**
+ * @brief SIGPROF handler, count the running instruction.
+ * @param signo SIGPROF.
+ */
+static void s_sample_signal(int);
+
+/**
+ * @brief read the line table and the source text.
+ * @param sampler [in/out] a valid sampler object.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_load_line_table(sampler_st *);
+
+/**
+ * @brief read the lines of the source, up to the last line in the line table.
+ * @param sampler [in/out] a valid sampler object with a line table.
+ */
+static void s_load_source(sampler_st *);
+
+/**
+ * @brief write the report.
+ * @param fout output stream.
+ * @param sampler a valid sampler object.
+ */
+static void s_write_report(FILE *, sampler_st *);
+
+/**
+ * @brief order source lines by samples, descending, used by qsort.
+ * @param left a source line.
+ * @param right a source line.
+ * @return compare result.
+ */
+static int s_compare_line(const void *, const void *);
+
+/**
+ * @brief order instructions by samples, descending, used by qsort.
+ * @param left address of an instruction.
+ * @param right address of an instruction.
+ * @return compare result.
+ */
+static int s_compare_instruction(const void *, const void *);
+
+static sampler_st *s_active;                        /**< sampler the handler counts into */
+static sampler_st *s_sorting;                       /**< sampler being sorted */
+
+/**
+ * @brief initialize a sampler for a loaded program.
+ * @param instructions a valid instruction set object.
+ * @param asm_path path of the byte code, its line table is "<asm_path>.lines";
+ *        NULL for none, samples are then reported by instruction only.
+ * @param pc address of the running instruction, kept by the interpreter,
+ *        -1 outside the program; read by the SIGPROF handler.
+ * @return a valid sampler object.
+ */
+sampler_st *sampler_init(instruction_set_st *instructions, const char *asm_path,
+                         const volatile sig_atomic_t *pc) {
+    sampler_st *sampler;
+    size_t path_len;
+
+    if (instructions == NULL || pc == NULL)
+        exit(EINVAL);
+
+    sampler = (sampler_st *)calloc(1, sizeof(sampler_st));
+    if (sampler == NULL)
+        exit(ENOMEM);
+
+    sampler->instructions = instructions;
+    sampler->pc = pc;
+    sampler->count = instruction_set_get_count(instructions);
+    sampler->counts = (uint64_t *)calloc(sampler->count + 1, sizeof(uint64_t));
+    if (sampler->counts == NULL)
+        exit(ENOMEM);
+
+    if (asm_path != NULL) {
+        path_len = strlen(asm_path) + strlen(LINE_TABLE_SUFFIX) + 1;
+        sampler->table_path = (char *)malloc(path_len);
+        if (sampler->table_path == NULL)
+            exit(ENOMEM);
+        snprintf(sampler->table_path, path_len, "%s%s", asm_path, LINE_TABLE_SUFFIX);
+    }
+
+    return sampler;
+}
+
+/**
+ * @brief clean up the sampler object, stop it if running.
+ * @param sampler a valid sampler object.
+ */
+void sampler_fini(sampler_st *sampler) {
+    int i;
+
+    if (sampler == NULL)
+        return;
+
+    sampler_stop(sampler);
+
+    if (sampler->source != NULL) {
+        for (i = 0; i <= sampler->max_line; i++)
+            free(sampler->source[i]);
+        free(sampler->source);
+    }
+    free(sampler->line_counts);
+    free(sampler->lines);
+    free(sampler->columns);
+    free(sampler->source_path);
+    free(sampler->table_path);
+    free(sampler->counts);
+    free(sampler);
+}
+
+/**
+ * @brief start sampling on SIGPROF, only one sampler runs at a time.
+ * @param sampler a valid sampler object.
+ * @param interval microseconds of cpu time between samples.
+ * @return 0 on success; otherwise errno.
+ */
+int sampler_start(sampler_st *sampler, long interval) {
+    struct sigaction action;
+    struct itimerval timer;
+
+    if (sampler == NULL || interval <= 0)
+        return EINVAL;
+    if (s_active != NULL)
+        return EBUSY;
+
+    s_active = sampler;
+    sampler->interval = interval;
+
+    // a sample must not break the output writes of the program.
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = s_sample_signal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, &sampler->saved) != 0) {
+        s_active = NULL;
+        return errno;
+    }
+
+    timer.it_interval.tv_sec = interval / 1000000;
+    timer.it_interval.tv_usec = interval % 1000000;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+        sigaction(SIGPROF, &sampler->saved, NULL);
+        s_active = NULL;
+        return errno;
+    }
+
+    sampler->running = 1;
+    return 0;
+}
+
+/**
+ * @brief stop sampling, the counters are kept.
+ * @param sampler a valid sampler object.
+ */
+void sampler_stop(sampler_st *sampler) {
+    struct itimerval timer;
+
+    if (sampler == NULL || !sampler->running)
+        return;
+
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, NULL);
+
+    // a SIGPROF still pending would terminate the process with the default action.
+    signal(SIGPROF, SIG_IGN);
+    sigaction(SIGPROF, &sampler->saved, NULL);
+
+    sampler->running = 0;
+    s_active = NULL;
+}
+
+/**
+ * @brief write the samples by source line and by instruction into "<prefix>.report".
+ * @param sampler a valid sampler object.
+ * @param prefix prefix of the output file.
+ * @return 0 on success; otherwise errno.
+ */
+int sampler_write(sampler_st *sampler, const char *prefix) {
+    FILE *fout;
+    char *path;
+    size_t path_len;
+    int rc = 0;
+
+    if (sampler == NULL || prefix == NULL)
+        return EINVAL;
+
+    sampler_stop(sampler);
+
+    if (sampler->lines == NULL && sampler->table_path != NULL) {
+        rc = s_load_line_table(sampler);
+        if (rc != 0)
+            fprintf(stderr, "%s: %s, samples reported by instruction\n",
+                            sampler->table_path, strerror(rc));
+    }
+
+    path_len = strlen(prefix) + strlen(".report") + 1;
+    path = (char *)malloc(path_len);
+    if (path == NULL)
+        return ENOMEM;
+
+    snprintf(path, path_len, "%s.report", prefix);
+    fout = fopen(path, "w");
+    if (fout == NULL) {
+        rc = errno;
+        free(path);
+        return rc;
+    }
+    s_write_report(fout, sampler);
+    rc = 0;
+    if (fclose(fout) != 0)
+        rc = errno;
+
+    free(path);
+    return rc;
+}
+
+/**
+ * @brief SIGPROF handler, count the running instruction.
+ * @param signo SIGPROF.
+ */
+static void s_sample_signal(int signo) {
+    sampler_st *sampler = s_active;
+    int pc;
+
+    if (sampler == NULL)
+        return;
+
+    pc = *sampler->pc;
+
+    if (pc >= 0 && pc < sampler->count)
+        sampler->counts[pc]++;
+    else
+        sampler->outside++;
+    sampler->total++;
+}
+
+/**
+ * @brief read the line table and the source text.
+ * @param sampler [in/out] a valid sampler object.
+ * @return 0 on success; otherwise errno.
+ */
+static int s_load_line_table(sampler_st *sampler) {
+    FILE *fin;
+    char *header = NULL;
+    size_t header_size = 0;
+    ssize_t length;
+    int pc;
+    int line;
+    int column;
+    int i;
+
+    fin = fopen(sampler->table_path, "r");
+    if (fin == NULL)
+        return errno;
+
+    length = getline(&header, &header_size, fin);
+    if (length <= (ssize_t)strlen(SOURCE_TAG) ||
+        strncmp(header, SOURCE_TAG, strlen(SOURCE_TAG)) != 0) {
+        free(header);
+        fclose(fin);
+        return EBADMSG;
+    }
+    if (header[length - 1] == '\n')
+        header[length - 1] = '\0';
+    sampler->source_path = strdup(header + strlen(SOURCE_TAG));
+    free(header);
+
+    sampler->lines = (int *)calloc(sampler->count + 1, sizeof(int));
+    sampler->columns = (int *)calloc(sampler->count + 1, sizeof(int));
+    if (sampler->source_path == NULL || sampler->lines == NULL || sampler->columns == NULL)
+        exit(ENOMEM);
+
+    // a table of another build of the program is ignored past its end.
+    while (fscanf(fin, "%d %d %d", &pc, &line, &column) == 3) {
+        if (pc < 0 || pc >= sampler->count || line < 0)
+            continue;
+        sampler->lines[pc] = line;
+        sampler->columns[pc] = column;
+        if (line > sampler->max_line)
+            sampler->max_line = line;
+    }
+    fclose(fin);
+
+    sampler->line_counts = (uint64_t *)calloc(sampler->max_line + 1, sizeof(uint64_t));
+    if (sampler->line_counts == NULL)
+        exit(ENOMEM);
+    for (i = 0; i < sampler->count; i++)
+        sampler->line_counts[sampler->lines[i]] += sampler->counts[i];
+
+    s_load_source(sampler);
+    return 0;
+}
+
+/**
+ * @brief read the lines of the source, up to the last line in the line table.
+ * @param sampler [in/out] a valid sampler object with a line table.
+ */
+static void s_load_source(sampler_st *sampler) {
+    FILE *fin;
+    char *text = NULL;
+    size_t text_size = 0;
+    ssize_t length;
+    int line = 1;
+
+    fin = fopen(sampler->source_path, "r");
+    if (fin == NULL)
+        return;
+
+    sampler->source = (char **)calloc(sampler->max_line + 1, sizeof(char *));
+    if (sampler->source == NULL)
+        exit(ENOMEM);
+
+    while (line <= sampler->max_line && (length = getline(&text, &text_size, fin)) >= 0) {
+        while (length > 0 && (text[length - 1] == '\n' || text[length - 1] == '\r'))
+            text[--length] = '\0';
+        sampler->source[line++] = strdup(text);
+    }
+    free(text);
+    fclose(fin);
+}
+
+/**
+ * @brief write the report.
+ * @param fout output stream.
+ * @param sampler a valid sampler object.
+ */
+static void s_write_report(FILE *fout, sampler_st *sampler) {
+    instruction_st *instruction;
+    const char *text;
+    double total;
+    int *order;
+    int size;
+    int pc;
+    int i;
+
+    size = sampler->count > sampler->max_line ? sampler->count : sampler->max_line;
+    order = (int *)malloc((size + 1) * sizeof(int));
+    if (order == NULL)
+        exit(ENOMEM);
+
+    total = sampler->total > 0 ? (double)sampler->total : 1.0;
+
+    fprintf(fout, "# samples: %" PRIu64 ", every %ld us of cpu time, %" PRIu64 " outside the program\n",
+                  sampler->total, sampler->interval, sampler->outside);
+
+    s_sorting = sampler;
+
+    // source lines, by samples.
+    if (sampler->line_counts != NULL) {
+        fprintf(fout, "# source: %s\n\n", sampler->source_path);
+        fprintf(fout, "%-14s %-8s %-7s %s\n", "samples", "percent", "line", "source");
+        for (i = 0; i <= sampler->max_line; i++)
+            order[i] = i;
+        qsort(order, sampler->max_line + 1, sizeof(int), s_compare_line);
+        for (i = 0; i <= sampler->max_line; i++) {
+            if (sampler->line_counts[order[i]] == 0)
+                break;
+            if (order[i] == 0) {
+                text = "(generated code)";
+            } else {
+                text = (sampler->source && sampler->source[order[i]]) ? sampler->source[order[i]] : "";
+                while (*text == ' ' || *text == '\t')
+                    text++;
+            }
+            fprintf(fout, "%-14" PRIu64 " %6.2f%%  %-7d %s\n",
+                          sampler->line_counts[order[i]],
+                          sampler->line_counts[order[i]] * 100.0 / total, order[i], text);
+        }
+    } else {
+        fprintf(fout, "# source: unknown, no line table\n");
+    }
+
+    // hottest instructions.
+    fprintf(fout, "\n%-14s %-8s %-11s %-11s %s\n",
+                  "samples", "percent", "address", "source", "instruction");
+    for (i = 0; i < sampler->count; i++)
+        order[i] = i;
+    qsort(order, sampler->count, sizeof(int), s_compare_instruction);
+    for (i = 0; i < sampler->count && i < HOT_INSTRUCTIONS; i++) {
+        pc = order[i];
+        if (sampler->counts[pc] == 0)
+            break;
+        instruction = instruction_set_get_address(sampler->instructions, pc);
+        fprintf(fout, "%-14" PRIu64 " %6.2f%%  %-11d ",
+                      sampler->counts[pc], sampler->counts[pc] * 100.0 / total, pc + 1);
+        if (sampler->lines != NULL && sampler->lines[pc] > 0)
+            fprintf(fout, "%5d:%-5d ", sampler->lines[pc], sampler->columns[pc]);
+        else
+            fprintf(fout, "%-11s ", "-");
+        fprintf(fout, "%s", instruction_get_op_code(instruction));
+        if (instruction_get_op_first(instruction) != NULL)
+            fprintf(fout, " %s", instruction_get_op_first(instruction));
+        if (instruction_get_op_second(instruction) != NULL)
+            fprintf(fout, " %s", instruction_get_op_second(instruction));
+        fputc('\n', fout);
+    }
+
+    free(order);
+}
+
+/**
+ * @brief order source lines by samples, descending, used by qsort.
+ * @param left a source line.
+ * @param right a source line.
+ * @return compare result.
+ */
+static int s_compare_line(const void *left, const void *right) {
+    uint64_t left_count = s_sorting->line_counts[*(const int *)left];
+    uint64_t right_count = s_sorting->line_counts[*(const int *)right];
+
+    if (left_count != right_count)
+        return left_count > right_count ? -1 : 1;
+    return *(const int *)left - *(const int *)right;
+}
+
+/**
+ * @brief order instructions by samples, descending, used by qsort.
+ * @param left address of an instruction.
+ * @param right address of an instruction.
+ * @return compare result.
+ */
+static int s_compare_instruction(const void *left, const void *right) {
+    uint64_t left_count = s_sorting->counts[*(const int *)left];
+    uint64_t right_count = s_sorting->counts[*(const int *)right];
+
+    if (left_count != right_count)
+        return left_count > right_count ? -1 : 1;
+    return *(const int *)left - *(const int *)right;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file sampler.h
+ * @brief Purpose: sample the running instruction on a cpu timer and
+ *        attribute the samples to the lines of the source.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __SAMPLER_H__
+#define __SAMPLER_H__
+
+#include <signal.h>
+
+#include "instruction.h"
+
+#define SAMPLER_DEFAULT_PREFIX      "sample"        /**< default prefix of the output file */
+#define SAMPLER_DEFAULT_INTERVAL    (1000)          /**< default microseconds of cpu time between samples */
+
+typedef struct sampler sampler_st;
+struct sampler;
+
+/**
+ * @brief initialize a sampler for a loaded program.
+ * @param instructions a valid instruction set object.
+ * @param asm_path path of the byte code, its line table is "<asm_path>.lines";
+ *        NULL for none, samples are then reported by instruction only.
+ * @param pc address of the running instruction, kept by the interpreter,
+ *        -1 outside the program; read by the SIGPROF handler.
+ * @return a valid sampler object.
+ */
+sampler_st *sampler_init(instruction_set_st *, const char *, const volatile sig_atomic_t *);
+
+/**
+ * @brief clean up the sampler object, stop it if running.
+ * @param sampler a valid sampler object.
+ */
+void sampler_fini(sampler_st *);
+
+/**
+ * @brief start sampling on SIGPROF, only one sampler runs at a time.
+ * @param sampler a valid sampler object.
+ * @param interval microseconds of cpu time between samples.
+ * @return 0 on success; otherwise errno.
+ */
+int sampler_start(sampler_st *, long);
+
+/**
+ * @brief stop sampling, the counters are kept.
+ * @param sampler a valid sampler object.
+ */
+void sampler_stop(sampler_st *);
+
+/**
+ * @brief write the samples by source line and by instruction into "<prefix>.report".
+ * @param sampler a valid sampler object.
+ * @param prefix prefix of the output file.
+ * @return 0 on success; otherwise errno.
+ */
+int sampler_write(sampler_st *, const char *);
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file stats.c
+ * @brief Purpose: report where the time and memory of a run go.
+ *
+ * The report is one JSON object on one line, so the reports of many runs
+ * can be appended to one file and compared across builds.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "stats.h"
+
+/**
+ * @brief write the hardware counters of a phase as a JSON object,
+ *        with IPC and the misses per VM instruction derived from them.
+ * @param fout output stream.
+ * @param perf the counters of the phase.
+ * @param executed VM instructions executed in the phase.
+ */
+static void s_write_perf(FILE *, const perf_values_st *, uint64_t);
+
+/**
+ * @brief write a ratio, null if a counter is unavailable or the divisor is 0.
+ * @param fout output stream.
+ * @param name name of the ratio.
+ * @param available 1 if both counters are available.
+ * @param dividend the dividend.
+ * @param divisor the divisor.
+ */
+static void s_write_ratio(FILE *, const char *, int, uint64_t, uint64_t);
+
+/**
+ * @brief write the statistics as one JSON object.
+ * @param fout output stream.
+ * @param stats the statistics of a run.
+ * @return 0 on success; otherwise errno.
+ */
+int stats_write_json(FILE *fout, const runtime_stats_st *stats) {
+    int i;
+
+    if (fout == NULL || stats == NULL)
+        return EINVAL;
+
+    fprintf(fout, "{\"executed\":%" PRIu64 ",\"by_opcode\":{", stats->executed);
+    for (i = 0; i < OP_COUNT; i++) {
+        fprintf(fout, "%s\"%s\":%" PRIu64, i == 0 ? "" : ",",
+                      instruction_op_name(i), stats->op_executed[i]);
+    }
+    fprintf(fout, "},");
+
+    fprintf(fout, "\"variable_lookups\":%" PRIu64 ",\"lookup_probes\":%" PRIu64 ","
+                  "\"scope_opens\":%" PRIu64 ",\"scope_closes\":%" PRIu64 ","
+                  "\"peak_allocated_address\":%d,\"peak_scope\":%d,",
+                  stats->memory.lookups, stats->memory.probes,
+                  stats->memory.scope_opens, stats->memory.scope_closes,
+                  stats->memory.peak_allocated, stats->memory.peak_scope);
+
+    fprintf(fout, "\"instructions\":%d,\"labels\":%d,\"labels_resolved\":%d,",
+                  stats->instructions, stats->labels, stats->labels_resolved);
+
+    if (stats->perf_enabled) {
+        fprintf(fout, "\"perf\":{");
+        if (stats->perf_error != 0) {
+            fprintf(fout, "\"error\":\"%s\"", strerror(stats->perf_error));
+        } else {
+            fprintf(fout, "\"load\":");
+            s_write_perf(fout, &stats->perf_load, 0);
+            fprintf(fout, ",\"run\":");
+            s_write_perf(fout, &stats->perf_run, stats->executed);
+        }
+        fprintf(fout, "},");
+    }
+
+    fprintf(fout, "\"load_seconds\":%.6f,\"run_seconds\":%.6f,\"max_rss_kb\":%ld,"
+                  "\"cached\":%s,\"completed\":%s}\n",
+                  stats->load_seconds, stats->run_seconds, stats->max_rss_kb,
+                  stats->cached ? "true" : "false", stats->completed ? "true" : "false");
+
+    if (fflush(fout) != 0 || ferror(fout))
+        return EIO;
+    return 0;
+}
+
+/**
+ * @brief write the hardware counters of a phase as a JSON object,
+ *        with IPC and the misses per VM instruction derived from them.
+ * @param fout output stream.
+ * @param perf the counters of the phase.
+ * @param executed VM instructions executed in the phase.
+ */
+static void s_write_perf(FILE *fout, const perf_values_st *perf, uint64_t executed) {
+    int i;
+
+    fputc('{', fout);
+    for (i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (perf->available[i])
+            fprintf(fout, "\"%s\":%" PRIu64 ",", perf_counter_name(i), perf->values[i]);
+        else
+            fprintf(fout, "\"%s\":null,", perf_counter_name(i));
+    }
+
+    s_write_ratio(fout, "ipc", perf->available[PERF_INSTRUCTIONS] && perf->available[PERF_CYCLES],
+                  perf->values[PERF_INSTRUCTIONS], perf->values[PERF_CYCLES]);
+
+    // the load phase runs no VM instruction.
+    if (executed > 0) {
+        fputc(',', fout);
+        s_write_ratio(fout, "cycles_per_vm_instruction", perf->available[PERF_CYCLES],
+                      perf->values[PERF_CYCLES], executed);
+        fputc(',', fout);
+        s_write_ratio(fout, "branch_misses_per_vm_instruction", perf->available[PERF_BRANCH_MISSES],
+                      perf->values[PERF_BRANCH_MISSES], executed);
+        fputc(',', fout);
+        s_write_ratio(fout, "l1d_misses_per_vm_instruction", perf->available[PERF_L1D_MISSES],
+                      perf->values[PERF_L1D_MISSES], executed);
+        fputc(',', fout);
+        s_write_ratio(fout, "llc_misses_per_vm_instruction", perf->available[PERF_LLC_MISSES],
+                      perf->values[PERF_LLC_MISSES], executed);
+    }
+    fputc('}', fout);
+}
+
+/**
+ * @brief write a ratio, null if a counter is unavailable or the divisor is 0.
+ * @param fout output stream.
+ * @param name name of the ratio.
+ * @param available 1 if both counters are available.
+ * @param dividend the dividend.
+ * @param divisor the divisor.
+ */
+static void s_write_ratio(FILE *fout, const char *name, int available,
+                          uint64_t dividend, uint64_t divisor) {
+    if (available && divisor != 0)
+        fprintf(fout, "\"%s\":%.4f", name, (double)dividend / divisor);
+    else
+        fprintf(fout, "\"%s\":null", name);
+}
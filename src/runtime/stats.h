@@ -0,0 +1,45 @@
+/**
+ * @file stats.h
+ * @brief Purpose: report where the time and memory of a run go.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __STATS_H__
+#define __STATS_H__
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "instruction.h"
+#include "storage.h"
+#include "perf_counters.h"
+
+#define STATS_FORMAT_JSON           "json"          /**< the only report format */
+
+typedef struct runtime_stats {
+    uint64_t executed;                              /**< instructions executed */
+    uint64_t op_executed[OP_COUNT];                 /**< instructions executed by operation */
+    machine_memory_stats_st memory;                 /**< counters of the machine memory */
+    int instructions;                               /**< total of instructions */
+    int labels;                                     /**< labels defined */
+    int labels_resolved;                            /**< jumps resolved to a label */
+    double load_seconds;                            /**< time to load the program */
+    double run_seconds;                             /**< time to run the program */
+    long max_rss_kb;                                /**< peak resident set size */
+    int cached;                                     /**< 1 if the output was replayed from the cache */
+    int completed;                                  /**< 1 if the program ran to the end */
+    int perf_enabled;                               /**< 1 if hardware counters were asked for */
+    int perf_error;                                 /**< errno if no counter is available */
+    perf_values_st perf_load;                       /**< hardware counters of the load phase */
+    perf_values_st perf_run;                        /**< hardware counters of the run phase */
+} runtime_stats_st;
+
+/**
+ * @brief write the statistics as one JSON object.
+ * @param fout output stream.
+ * @param stats the statistics of a run.
+ * @return 0 on success; otherwise errno.
+ */
+int stats_write_json(FILE *, const runtime_stats_st *);
+
+#endif
@@ -12,6 +12,12 @@
 
 #include "storage.h"
 
+#include "ten_sdt.h"
+
+/* static tracepoints, see ten_sdt.h. */
+TEN_SDT_SEMAPHORE(ten, scope__open);               /**< arg0 new depth, arg1 first address */
+TEN_SDT_SEMAPHORE(ten, scope__close);              /**< arg0 closed depth, arg1 released variables */
+
 #define STATIC_MEMORY_SIZE      (32)                /**< memory size of the virtual machine */
 #define SCOPE_BOUNDRAY_SIZE     (4)                 /**< array size of the scope boundray */
 #define RESIZE_FACTOR           (2)                 /**< resize factor when memory size is too small */
@@ -31,6 +37,7 @@ struct machine_memory
     int *scope_boundary;                            /**< indicate the scope range */
     int scope_capacity;                             /**< capacity of scope_boundary */
     memory_st *static_memory;                       /**< static memory */
+    machine_memory_stats_st stats;                  /**< usage counters */
 };      
 
 /**
@@ -61,8 +68,10 @@ machine_memory_st *machine_memory_init() {
 
     machine_store->memory_size = STATIC_MEMORY_SIZE;
 
+    memset(&(machine_store->stats), 0, sizeof(machine_store->stats));
+
     memset(machine_store->static_memory, 0, 
-            sizeof(STATIC_MEMORY_SIZE * sizeof(memory_st)));
+            STATIC_MEMORY_SIZE * sizeof(memory_st));
 
     return machine_store;
 }
@@ -107,12 +116,39 @@ memory_st* machine_memory_get_variable(machine_memory_st *machine_store,
         boundry = machine_store->scope_boundary[machine_store->current_scope];
     }
 
+    // the probes are counted once per lookup, the loop stays free of stores.
+    machine_store->stats.lookups++;
+    machine_store->stats.probes += index + 1;
     for ( ; index >= boundry; index--) {
         variable_memory = &(machine_store->static_memory[index]);
-        if (strcmp(variable_memory->variable_name, variable_name) == 0)
+        if (strcmp(variable_memory->variable_name, variable_name) == 0) {
+            machine_store->stats.probes -= index;
             return variable_memory;
+        }
     }
 
+    machine_store->stats.probes -= boundry;
+    return NULL;
+}
+
+/**
+ * @brief get a variable in any scope without counting the lookup, for the
+ *        tracer and the state dump, which only observe the program.
+ * @param machine_store a valid machine_store.
+ * @param variable_name variable name.
+ * @return NULL on failed or doesn't exist; otherwise a pointer to variable_memory.
+ */
+memory_st* machine_memory_peek_variable(machine_memory_st *machine_store,
+                                         const char *variable_name) {
+    int index;
+
+    if (machine_store == NULL || variable_name == NULL)
+        return NULL;
+
+    for (index = machine_store->allocated_address - 1; index >= 0; index--) {
+        if (strcmp(machine_store->static_memory[index].variable_name, variable_name) == 0)
+            return &(machine_store->static_memory[index]);
+    }
     return NULL;
 }
 
@@ -136,7 +172,7 @@ int machine_memory_set_variable(machine_memory_st *machine_store,
     if (index >= machine_store->memory_size) {
         machine_store->static_memory = realloc(machine_store->static_memory, 
                                                machine_store->memory_size * 
-                                               RESIZE_FACTOR);
+                                               RESIZE_FACTOR * sizeof(memory_st));
     
         if (machine_store->static_memory == NULL) {
             exit(ENOMEM);
@@ -150,6 +186,8 @@ int machine_memory_set_variable(machine_memory_st *machine_store,
     static_memory->variable_value = value;
     static_memory->scope = machine_store->current_scope;
     machine_store->allocated_address++;
+    if (machine_store->allocated_address > machine_store->stats.peak_allocated)
+        machine_store->stats.peak_allocated = machine_store->allocated_address;
 
     return 0;
 }
@@ -163,6 +201,9 @@ void machine_memory_open_scope(machine_memory_st *machine_store) {
         return;
 
     machine_store->current_scope++;
+    machine_store->stats.scope_opens++;
+    if (machine_store->current_scope > machine_store->stats.peak_scope)
+        machine_store->stats.peak_scope = machine_store->current_scope;
 #ifdef DEBUG
     fprintf(stderr, "scope: %d\n", machine_store->current_scope);
 #endif
@@ -178,6 +219,9 @@ void machine_memory_open_scope(machine_memory_st *machine_store) {
     }
 
     machine_store->scope_boundary[machine_store->current_scope] = machine_store->allocated_address;
+
+    TEN_SDT_PROBE2(ten, scope__open, machine_store->current_scope,
+                   machine_store->allocated_address);
 }
 
 /**
@@ -209,11 +253,102 @@ void machine_memory_close_scope(machine_memory_st *machine_store) {
         free(static_memory->variable_name);
     }
 
+    TEN_SDT_PROBE2(ten, scope__close, machine_store->current_scope,
+                   machine_store->allocated_address - boundary);
+
     machine_store->allocated_address = boundary;
 
     machine_store->scope_boundary[machine_store->current_scope] = 0;
 
     machine_store->current_scope--;
+    machine_store->stats.scope_closes++;
+}
+
+/**
+ * @brief get the current scope level of the machine memory.
+ * @param machine_store a valid machine_store.
+ * @return current scope, 0 for the global scope.
+ */
+int machine_memory_get_scope(machine_memory_st *machine_store) {
+    if (machine_store == NULL)
+        return 0;
+
+    return machine_store->current_scope;
+}
+
+/**
+ * @brief get the first address of a scope.
+ * @param machine_store a valid machine_store.
+ * @param scope scope level, from 0 to current scope.
+ * @return the first address belongs to the scope, -1 on invalid scope.
+ */
+int machine_memory_get_scope_boundary(machine_memory_st *machine_store, int scope) {
+    if (machine_store == NULL || scope < 0 || scope > machine_store->current_scope)
+        return -1;
+
+    return machine_store->scope_boundary[scope];
+}
+
+/**
+ * @brief get the number of allocated variables on all scopes.
+ * @param machine_store a valid machine_store.
+ * @return count of variables.
+ */
+int machine_memory_get_count(machine_memory_st *machine_store) {
+    if (machine_store == NULL)
+        return 0;
+
+    return machine_store->allocated_address;
+}
+
+/**
+ * @brief get a variable by its address.
+ * @param machine_store a valid machine_store.
+ * @param address address of the variable, from 0 to count - 1.
+ * @return NULL on invalid address; otherwise a pointer to variable_memory.
+ */
+memory_st *machine_memory_get_address(machine_memory_st *machine_store, int address) {
+    if (machine_store == NULL || address < 0 || 
+        address >= machine_store->allocated_address)
+        return NULL;
+
+    return &(machine_store->static_memory[address]);
+}
+
+/**
+ * @brief get the usage counters of the machine memory.
+ * @param machine_store a valid machine_store.
+ * @param stats [out] the counters.
+ */
+void machine_memory_get_stats(machine_memory_st *machine_store, machine_memory_stats_st *stats) {
+    if (machine_store == NULL || stats == NULL)
+        return;
+
+    *stats = machine_store->stats;
+}
+
+/**
+ * @brief get the name of memory object.
+ * @param variable_memory a valid memory object.
+ * @return the name of the variable.
+ */
+char *memory_get_name(memory_st *variable) {
+    if (variable == NULL)
+        exit(EINVAL);
+
+    return variable->variable_name;
+}
+
+/**
+ * @brief get the scope of memory object.
+ * @param variable_memory a valid memory object.
+ * @return the scope the variable declared on.
+ */
+int memory_get_scope(memory_st *variable) {
+    if (variable == NULL)
+        exit(EINVAL);
+
+    return variable->scope;
 }
 
 /**
@@ -8,6 +8,8 @@
 #ifndef __STORAGE_H__
 #define __STORAGE_H__
 
+#include <stdint.h>
+
 #define MEMORY_CURRENT_SCOPE        (0)             /**< Search on current scope */
 #define MEMORY_ALL_SCOPE            (-1)            /**< Search on all scope */
 
@@ -17,6 +19,15 @@ struct memory;
 typedef struct machine_memory machine_memory_st;
 struct machine_memory;
 
+typedef struct machine_memory_stats {
+    uint64_t lookups;                               /**< calls of machine_memory_get_variable */
+    uint64_t probes;                                /**< variables compared by the lookups */
+    uint64_t scope_opens;                           /**< scopes opened */
+    uint64_t scope_closes;                          /**< scopes closed */
+    int peak_allocated;                             /**< peak of allocated_address */
+    int peak_scope;                                 /**< peak of current_scope */
+} machine_memory_stats_st;
+
 /**
  * @brief initialize the machine memory.
  * @return machine_store a valid machine_store.
@@ -38,6 +49,15 @@ void machine_memory_fini(machine_memory_st *);
  */
 memory_st* machine_memory_get_variable(machine_memory_st *, char *, int);
 
+/**
+ * @brief get a variable in any scope without counting the lookup, for the
+ *        tracer and the state dump, which only observe the program.
+ * @param machine_store a valid machine_store.
+ * @param variable_name variable name.
+ * @return NULL on failed or doesn't exist; otherwise a pointer to variable_memory.
+ */
+memory_st* machine_memory_peek_variable(machine_memory_st *, const char *);
+
 /**
  * @brief set a variable to the storage.
  * @param machine_store a valid machine_store.
@@ -60,6 +80,50 @@ void machine_memory_open_scope(machine_memory_st *);
  */
 void machine_memory_close_scope(machine_memory_st *);
 
+/**
+ * @brief get the current scope level of the machine memory.
+ * @param machine_store a valid machine_store.
+ * @return current scope, 0 for the global scope.
+ */
+int machine_memory_get_scope(machine_memory_st *);
+
+/**
+ * @brief get the first address of a scope.
+ * @param machine_store a valid machine_store.
+ * @param scope scope level, from 0 to current scope.
+ * @return the first address belongs to the scope, -1 on invalid scope.
+ */
+int machine_memory_get_scope_boundary(machine_memory_st *, int);
+
+/**
+ * @brief get the number of allocated variables on all scopes.
+ * @param machine_store a valid machine_store.
+ * @return count of variables.
+ */
+int machine_memory_get_count(machine_memory_st *);
+
+/**
+ * @brief get a variable by its address.
+ * @param machine_store a valid machine_store.
+ * @param address address of the variable, from 0 to count - 1.
+ * @return NULL on invalid address; otherwise a pointer to variable_memory.
+ */
+memory_st *machine_memory_get_address(machine_memory_st *, int);
+
+/**
+ * @brief get the name of memory object.
+ * @param variable_memory a valid memory object.
+ * @return the name of the variable.
+ */
+char *memory_get_name(memory_st *);
+
+/**
+ * @brief get the scope of memory object.
+ * @param variable_memory a valid memory object.
+ * @return the scope the variable declared on.
+ */
+int memory_get_scope(memory_st *);
+
 /**
  * @brief get a value from memory object.
  * @param variable_memory a valid memory object.
@@ -74,4 +138,11 @@ int memory_get_value(memory_st *);
  */
 void memory_set_value(memory_st *, int);
 
+/**
+ * @brief get the usage counters of the machine memory.
+ * @param machine_store a valid machine_store.
+ * @param stats [out] the counters.
+ */
+void machine_memory_get_stats(machine_memory_st *, machine_memory_stats_st *);
+
 #endif
\ No newline at end of file
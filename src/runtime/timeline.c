@@ -0,0 +1,212 @@
+/**
+ * @file timeline.c
+ * @brief Purpose: record the phases, loops and output of a run as a
+ *        Chrome trace timeline.
+ *
+ * Each entry of a "forN:" loop is a span from the label to "forN_end:",
+ * with the number of iterations, i.e. jumps back to the loop head. Spans
+ * of nested loops nest, so the cost of an inner loop shows under the
+ * iteration of its outer loop. The OUT instructions between two loop
+ * boundaries make one "out" span with the number of lines.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "chrome_trace.h"
+#include "timeline.h"
+
+#define LOOP_STACK_SIZE         (16)                /**< initial depth of the loop stack */
+#define RESIZE_FACTOR           (2)                 /**< growth of the loop stack */
+#define LABEL_SIZE              (32)                /**< longest label kept, with '\0' */
+
+typedef struct loop_span {
+    char name[LABEL_SIZE];                          /**< the label without ':' */
+    int pc;                                         /**< address of the label */
+    double start;                                   /**< when the loop was entered */
+    long iterations;                                /**< jumps back to the loop head */
+} loop_span_st;
+
+struct timeline {
+    chrome_trace_st *trace;                         /**< the trace file */
+    loop_span_st *loops;                            /**< the loops entered, innermost last */
+    int depth;                                      /**< loops entered */
+    int capacity;                                   /**< capacity of loops */
+    double out_start;                               /**< first line of the burst */
+    double out_end;                                 /**< last line of the burst */
+    long out_lines;                                 /**< lines of the burst, 0 for none */
+};
+
+/**
+ * @brief write the burst of output, if any, a loop boundary ends it.
+ * @param timeline a valid timeline object.
+ */
+static void s_flush_out(timeline_st *);
+
+/**
+ * @brief create the timeline file.
+ * @param path path of the trace file, truncated if exists.
+ * @return NULL on failed, errno is set; otherwise a valid timeline object.
+ */
+timeline_st *timeline_open(const char *path) {
+    timeline_st *timeline;
+    chrome_trace_st *trace;
+
+    trace = chrome_trace_open(path, "runtime");
+    if (trace == NULL)
+        return NULL;
+
+    timeline = (timeline_st *)calloc(1, sizeof(timeline_st));
+    if (timeline == NULL)
+        exit(ENOMEM);
+
+    timeline->loops = (loop_span_st *)malloc(LOOP_STACK_SIZE * sizeof(loop_span_st));
+    if (timeline->loops == NULL)
+        exit(ENOMEM);
+
+    timeline->trace = trace;
+    timeline->capacity = LOOP_STACK_SIZE;
+    return timeline;
+}
+
+/**
+ * @brief end the open spans, finish the file and clean up the timeline object.
+ * @param timeline a valid timeline object.
+ * @return 0 on success; otherwise errno.
+ */
+int timeline_close(timeline_st *timeline) {
+    int rc;
+
+    if (timeline == NULL)
+        return EINVAL;
+
+    timeline_stop(timeline);
+
+    rc = chrome_trace_close(timeline->trace);
+    free(timeline->loops);
+    free(timeline);
+    return rc;
+}
+
+/**
+ * @brief end the loops and the burst of output still open, the program stopped
+ *        inside them.
+ * @param timeline a valid timeline object.
+ */
+void timeline_stop(timeline_st *timeline) {
+    while (timeline->depth > 0)
+        timeline_loop_exit(timeline);
+    s_flush_out(timeline);
+}
+
+/**
+ * @brief get the time on the timeline, the start of a phase.
+ * @param timeline a valid timeline object.
+ * @return microseconds since the timeline was opened.
+ */
+double timeline_now(timeline_st *timeline) {
+    return chrome_trace_now(timeline->trace);
+}
+
+/**
+ * @brief record a phase of the run, from its start until now.
+ * @param timeline a valid timeline object.
+ * @param name name of the phase, e.g. "load".
+ * @param start start of the phase, from timeline_now.
+ */
+void timeline_phase(timeline_st *timeline, const char *name, double start) {
+    chrome_trace_span(timeline->trace, "phase", name, start,
+                      chrome_trace_now(timeline->trace), NULL);
+}
+
+/**
+ * @brief a loop is entered, on its label.
+ * @param timeline a valid timeline object.
+ * @param pc address of the label.
+ * @param label the label, e.g. "for1:".
+ */
+void timeline_loop_enter(timeline_st *timeline, int pc, const char *label) {
+    loop_span_st *loop;
+
+    s_flush_out(timeline);
+
+    if (timeline->depth >= timeline->capacity) {
+        timeline->capacity *= RESIZE_FACTOR;
+        timeline->loops = (loop_span_st *)realloc(timeline->loops,
+                                    timeline->capacity * sizeof(loop_span_st));
+        if (timeline->loops == NULL)
+            exit(ENOMEM);
+    }
+
+    loop = &(timeline->loops[timeline->depth++]);
+    snprintf(loop->name, sizeof(loop->name), "%.*s",
+             (int)strcspn(label, ":"), label);
+    loop->pc = pc;
+    loop->iterations = 0;
+    loop->start = chrome_trace_now(timeline->trace);
+}
+
+/**
+ * @brief a backward jump is taken, an iteration if it goes to the innermost loop.
+ * @param timeline a valid timeline object.
+ * @param target address jumped to.
+ */
+void timeline_back_edge(timeline_st *timeline, int target) {
+    loop_span_st *loop;
+
+    if (timeline->depth == 0)
+        return;
+
+    // the loop head is right after the label, jumps skip the scope opening.
+    loop = &(timeline->loops[timeline->depth - 1]);
+    if (target == loop->pc + 1)
+        loop->iterations++;
+}
+
+/**
+ * @brief the innermost loop is left, on its end label.
+ * @param timeline a valid timeline object.
+ */
+void timeline_loop_exit(timeline_st *timeline) {
+    loop_span_st *loop;
+    char args[64];
+
+    if (timeline->depth == 0)
+        return;
+
+    s_flush_out(timeline);
+
+    loop = &(timeline->loops[--timeline->depth]);
+    snprintf(args, sizeof(args), "\"pc\":%d,\"iterations\":%ld", loop->pc, loop->iterations);
+    chrome_trace_span(timeline->trace, "loop", loop->name, loop->start,
+                      chrome_trace_now(timeline->trace), args);
+}
+
+/**
+ * @brief a line is written, consecutive lines between loop boundaries make a burst.
+ * @param timeline a valid timeline object.
+ */
+void timeline_out(timeline_st *timeline) {
+    timeline->out_end = chrome_trace_now(timeline->trace);
+    if (timeline->out_lines++ == 0)
+        timeline->out_start = timeline->out_end;
+}
+
+/**
+ * @brief write the burst of output, if any, a loop boundary ends it.
+ * @param timeline a valid timeline object.
+ */
+static void s_flush_out(timeline_st *timeline) {
+    char args[32];
+
+    if (timeline->out_lines == 0)
+        return;
+
+    snprintf(args, sizeof(args), "\"lines\":%ld", timeline->out_lines);
+    chrome_trace_span(timeline->trace, "out", "out", timeline->out_start,
+                      timeline->out_end, args);
+    timeline->out_lines = 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file timeline.h
+ * @brief Purpose: record the phases, loops and output of a run as a
+ *        Chrome trace timeline.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __TIMELINE_H__
+#define __TIMELINE_H__
+
+typedef struct timeline timeline_st;
+struct timeline;
+
+/**
+ * @brief create the timeline file.
+ * @param path path of the trace file, truncated if exists.
+ * @return NULL on failed, errno is set; otherwise a valid timeline object.
+ */
+timeline_st *timeline_open(const char *);
+
+/**
+ * @brief end the open spans, finish the file and clean up the timeline object.
+ * @param timeline a valid timeline object.
+ * @return 0 on success; otherwise errno.
+ */
+int timeline_close(timeline_st *);
+
+/**
+ * @brief end the loops and the burst of output still open, the program stopped
+ *        inside them.
+ * @param timeline a valid timeline object.
+ */
+void timeline_stop(timeline_st *);
+
+/**
+ * @brief get the time on the timeline, the start of a phase.
+ * @param timeline a valid timeline object.
+ * @return microseconds since the timeline was opened.
+ */
+double timeline_now(timeline_st *);
+
+/**
+ * @brief record a phase of the run, from its start until now.
+ * @param timeline a valid timeline object.
+ * @param name name of the phase, e.g. "load".
+ * @param start start of the phase, from timeline_now.
+ */
+void timeline_phase(timeline_st *, const char *, double);
+
+/**
+ * @brief a loop is entered, on its label.
+ * @param timeline a valid timeline object.
+ * @param pc address of the label.
+ * @param label the label, e.g. "for1:".
+ */
+void timeline_loop_enter(timeline_st *, int, const char *);
+
+/**
+ * @brief a backward jump is taken, an iteration if it goes to the innermost loop.
+ * @param timeline a valid timeline object.
+ * @param target address jumped to.
+ */
+void timeline_back_edge(timeline_st *, int);
+
+/**
+ * @brief the innermost loop is left, on its end label.
+ * @param timeline a valid timeline object.
+ */
+void timeline_loop_exit(timeline_st *);
+
+/**
+ * @brief a line is written, consecutive lines between loop boundaries make a burst.
+ * @param timeline a valid timeline object.
+ */
+void timeline_out(timeline_st *);
+
+#endif
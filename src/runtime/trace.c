@@ -0,0 +1,259 @@
+/**
+ * @file trace.c
+ * @brief Purpose: record every executed instruction into a memory-mapped ring file.
+ *
+ * The trace file is a fixed size header followed by a ring of fixed size
+ * records:
+ *
+ *     header                      see trace_header_st
+ *     records[capacity]           see trace_record_st
+ *
+ * Record n goes to slot n % capacity, the header keeps the count of records
+ * ever written. The file is shared-mapped, so the kernel writes it back
+ * even if the runtime is killed, and the trace ends at the failing instruction.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "trace.h"
+
+#define TRACE_MAGIC             "TENTRACE"          /**< magic string, 8 bytes without '\0' */
+#define TRACE_VERSION           (1)                 /**< version of the file layout */
+
+typedef struct trace_header {
+    char magic[8];                                  /**< TRACE_MAGIC */
+    uint32_t version;                               /**< TRACE_VERSION */
+    uint32_t header_size;                           /**< sizeof(trace_header_st) */
+    uint32_t record_size;                           /**< sizeof(trace_record_st) */
+    int32_t instruction_count;                      /**< total of instructions of the program */
+    uint64_t program_hash;                          /**< identity of the program */
+    uint64_t capacity;                              /**< slots in the ring */
+    uint64_t written;                               /**< records ever written */
+} trace_header_st;
+
+struct trace {
+    trace_header_st *header;                        /**< the mapped file */
+    trace_record_st *records;                       /**< the ring, right after the header */
+    size_t size;                                    /**< size of the mapping */
+    uint64_t capacity;                              /**< slots in the ring */
+    uint64_t written;                               /**< records ever written */
+};
+
+/**
+ * @brief create a trace file and map it for recording.
+ * @param path path of the trace file, truncated if exists.
+ * @param records capacity of the ring, older records are overwritten.
+ * @param instructions the traced program.
+ * @return NULL on failed, errno is set; otherwise a valid trace object.
+ */
+trace_st *trace_create(const char *path, uint64_t records, instruction_set_st *instructions) {
+    trace_st *trace;
+    void *mapping;
+    size_t size;
+    int fd;
+    int rc;
+
+    if (path == NULL || records == 0 || instructions == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    size = sizeof(trace_header_st) + records * sizeof(trace_record_st);
+
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return NULL;
+
+    if (ftruncate(fd, size) != 0) {
+        rc = errno;
+        close(fd);
+        errno = rc;
+        return NULL;
+    }
+
+    mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    rc = errno;
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        errno = rc;
+        return NULL;
+    }
+
+    trace = (trace_st *)calloc(1, sizeof(trace_st));
+    if (trace == NULL)
+        exit(ENOMEM);
+
+    trace->header = (trace_header_st *)mapping;
+    trace->records = (trace_record_st *)(trace->header + 1);
+    trace->size = size;
+    trace->capacity = records;
+
+    memcpy(trace->header->magic, TRACE_MAGIC, sizeof(trace->header->magic));
+    trace->header->version = TRACE_VERSION;
+    trace->header->header_size = sizeof(trace_header_st);
+    trace->header->record_size = sizeof(trace_record_st);
+    trace->header->instruction_count = instruction_set_get_count(instructions);
+    trace->header->program_hash = instruction_set_get_hash(instructions);
+    trace->header->capacity = records;
+    trace->header->written = 0;
+
+    return trace;
+}
+
+/**
+ * @brief map an existing trace file for reading.
+ * @param path path of the trace file.
+ * @return NULL on failed, errno is set; otherwise a valid trace object.
+ */
+trace_st *trace_open(const char *path) {
+    const trace_header_st *header;
+    struct stat file_stat;
+    trace_st *trace;
+    void *mapping;
+    int fd;
+    int rc;
+
+    if (path == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    if (fstat(fd, &file_stat) != 0) {
+        rc = errno;
+        close(fd);
+        errno = rc;
+        return NULL;
+    }
+    if ((size_t)file_stat.st_size < sizeof(trace_header_st)) {
+        close(fd);
+        errno = EBADMSG;
+        return NULL;
+    }
+
+    mapping = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    rc = errno;
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        errno = rc;
+        return NULL;
+    }
+
+    header = (const trace_header_st *)mapping;
+    if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != TRACE_VERSION ||
+        header->header_size != sizeof(trace_header_st) ||
+        header->record_size != sizeof(trace_record_st) ||
+        header->capacity == 0 ||
+        header->capacity > (file_stat.st_size - sizeof(trace_header_st)) / sizeof(trace_record_st)) {
+        munmap(mapping, file_stat.st_size);
+        errno = EBADMSG;
+        return NULL;
+    }
+
+    trace = (trace_st *)calloc(1, sizeof(trace_st));
+    if (trace == NULL)
+        exit(ENOMEM);
+
+    trace->header = (trace_header_st *)mapping;
+    trace->records = (trace_record_st *)(trace->header + 1);
+    trace->size = file_stat.st_size;
+    trace->capacity = header->capacity;
+    trace->written = header->written;
+
+    return trace;
+}
+
+/**
+ * @brief unmap the trace file and clean up the trace object.
+ * @param trace a valid trace object.
+ */
+void trace_close(trace_st *trace) {
+    if (trace == NULL)
+        return;
+
+    munmap(trace->header, trace->size);
+    free(trace);
+}
+
+/**
+ * @brief take the next slot of the ring, the oldest record is overwritten when full.
+ * @param trace a valid trace object, created for recording.
+ * @return the slot to fill.
+ */
+trace_record_st *trace_append(trace_st *trace) {
+    trace_record_st *record;
+
+    record = &(trace->records[trace->written % trace->capacity]);
+    trace->header->written = ++trace->written;
+    return record;
+}
+
+/**
+ * @brief get the number of records ever appended.
+ * @param trace a valid trace object.
+ * @return records appended.
+ */
+uint64_t trace_get_written(trace_st *trace) {
+    if (trace == NULL)
+        return 0;
+    return trace->written;
+}
+
+/**
+ * @brief get the number of records still in the ring.
+ * @param trace a valid trace object.
+ * @return records kept, at most the capacity.
+ */
+uint64_t trace_get_kept(trace_st *trace) {
+    if (trace == NULL)
+        return 0;
+    return trace->written < trace->capacity ? trace->written : trace->capacity;
+}
+
+/**
+ * @brief get a kept record, in execution order.
+ * @param trace a valid trace object.
+ * @param index 0 for the oldest kept record.
+ * @return NULL if out of range; otherwise the record.
+ */
+const trace_record_st *trace_get_record(trace_st *trace, uint64_t index) {
+    uint64_t kept = trace_get_kept(trace);
+
+    if (index >= kept)
+        return NULL;
+    return &(trace->records[(trace->written - kept + index) % trace->capacity]);
+}
+
+/**
+ * @brief get the hash of the traced program.
+ * @param trace a valid trace object.
+ * @return hash of the decoded program.
+ */
+uint64_t trace_get_hash(trace_st *trace) {
+    if (trace == NULL)
+        return 0;
+    return trace->header->program_hash;
+}
+
+/**
+ * @brief get the number of instructions of the traced program.
+ * @param trace a valid trace object.
+ * @return total of instructions.
+ */
+int trace_get_instruction_count(trace_st *trace) {
+    if (trace == NULL)
+        return 0;
+    return trace->header->instruction_count;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file trace.h
+ * @brief Purpose: record every executed instruction into a memory-mapped ring file.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdint.h>
+
+#include "instruction.h"
+
+#define TRACE_DEFAULT_RECORDS       (1 << 20)       /**< default capacity of the ring, in records */
+
+typedef struct trace_record {
+    int32_t pc;                                     /**< address of the instruction */
+    int32_t next_pc;                                /**< program counter after it, -1 if it failed */
+    uint16_t op_type;                               /**< enum op_type */
+    uint16_t depth;                                 /**< scope depth after it */
+    int32_t values[2];                              /**< operand values read by it, 0 for none */
+    int32_t flag;                                   /**< flag after it, set by CMP */
+} trace_record_st;
+
+typedef struct trace trace_st;
+struct trace;
+
+/**
+ * @brief create a trace file and map it for recording.
+ * @param path path of the trace file, truncated if exists.
+ * @param records capacity of the ring, older records are overwritten.
+ * @param instructions the traced program.
+ * @return NULL on failed, errno is set; otherwise a valid trace object.
+ */
+trace_st *trace_create(const char *, uint64_t, instruction_set_st *);
+
+/**
+ * @brief map an existing trace file for reading.
+ * @param path path of the trace file.
+ * @return NULL on failed, errno is set; otherwise a valid trace object.
+ */
+trace_st *trace_open(const char *);
+
+/**
+ * @brief unmap the trace file and clean up the trace object.
+ * @param trace a valid trace object.
+ */
+void trace_close(trace_st *);
+
+/**
+ * @brief take the next slot of the ring, the oldest record is overwritten when full.
+ * @param trace a valid trace object, created for recording.
+ * @return the slot to fill.
+ */
+trace_record_st *trace_append(trace_st *);
+
+/**
+ * @brief get the number of records ever appended.
+ * @param trace a valid trace object.
+ * @return records appended.
+ */
+uint64_t trace_get_written(trace_st *);
+
+/**
+ * @brief get the number of records still in the ring.
+ * @param trace a valid trace object.
+ * @return records kept, at most the capacity.
+ */
+uint64_t trace_get_kept(trace_st *);
+
+/**
+ * @brief get a kept record, in execution order.
+ * @param trace a valid trace object.
+ * @param index 0 for the oldest kept record.
+ * @return NULL if out of range; otherwise the record.
+ */
+const trace_record_st *trace_get_record(trace_st *, uint64_t);
+
+/**
+ * @brief get the hash of the traced program.
+ * @param trace a valid trace object.
+ * @return hash of the decoded program.
+ */
+uint64_t trace_get_hash(trace_st *);
+
+/**
+ * @brief get the number of instructions of the traced program.
+ * @param trace a valid trace object.
+ * @return total of instructions.
+ */
+int trace_get_instruction_count(trace_st *);
+
+#endif
@@ -0,0 +1,440 @@
+/**
+ * @file trace_analyze.c
+ * @brief Purpose: read a binary execution trace offline and report on it.
+ *
+ * The report covers the records still in the ring: taken ratio of each
+ * conditional jump, entries of each basic block, scope depth over time and
+ * the hottest address ranges. With the byte code of the traced program,
+ * the instructions are shown as well.
+ * @version 1.0
+ * @date 10.18.2026
+ */
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <inttypes.h>
+
+#include "instruction.h"
+#include "trace.h"
+
+#define DEFAULT_RANGE_WIDTH     (16)                /**< addresses per range */
+#define DEFAULT_TOP             (20)                /**< rows per table */
+#define DEPTH_SLICES            (20)                /**< time slices of the scope depth */
+
+typedef struct analysis {
+    trace_st *trace;                                /**< the trace being read */
+    instruction_set_st *instructions;               /**< the traced program, NULL if not given */
+    int count;                                      /**< total of instructions */
+    uint64_t kept;                                  /**< records in the ring */
+    uint64_t *executed;                             /**< executions of each instruction */
+    uint64_t *taken;                                /**< taken jumps of each instruction */
+    uint64_t *entries;                              /**< entries of each block leader */
+    uint64_t *block_length;                         /**< instructions run in each block */
+    uint64_t *range_executed;                       /**< executions of each address range */
+    int range_width;                                /**< addresses per range */
+    int range_count;                                /**< total of ranges */
+    int top;                                        /**< rows per table */
+} analysis_st;
+
+/**
+ * @brief count the records into the analysis.
+ * @param analysis [in/out] a valid analysis object.
+ */
+static void s_count(analysis_st *);
+
+/**
+ * @brief write the taken ratio of the conditional jumps.
+ * @param analysis a valid analysis object, counted.
+ */
+static void s_report_branches(analysis_st *);
+
+/**
+ * @brief write the basic blocks by entries.
+ * @param analysis a valid analysis object, counted.
+ */
+static void s_report_blocks(analysis_st *);
+
+/**
+ * @brief write min, average and max scope depth of each time slice.
+ * @param analysis a valid analysis object.
+ */
+static void s_report_depth(analysis_st *);
+
+/**
+ * @brief write the hottest address ranges.
+ * @param analysis a valid analysis object, counted.
+ */
+static void s_report_ranges(analysis_st *);
+
+/**
+ * @brief write an instruction, or its operation name without the byte code.
+ * @param analysis a valid analysis object.
+ * @param pc address of the instruction.
+ * @param op_type operation of the instruction, from the trace.
+ */
+static void s_write_instruction(analysis_st *, int, int);
+
+/**
+ * @brief order addresses by the sort key, descending, used by qsort.
+ * @param left an address.
+ * @param right an address.
+ * @return compare result.
+ */
+static int s_compare_key(const void *, const void *);
+
+/**
+ * @brief print out the usage information of trace-analyze.
+ */
+static void s_usage();
+
+static const uint64_t *s_sort_key;                  /**< counters being sorted by */
+static int *s_op_types;                             /**< operation at each address, -1 if never run */
+
+/**
+ * @brief main entrance of trace-analyze.
+ * @param argc arguments count.
+ * @param argv arguments vector.
+ * @return 0 on success; otherwise errno.
+ */
+int main(int argc, char *argv[])
+{
+    analysis_st analysis;
+    char *end = NULL;
+    int option;
+    int rc;
+
+    memset(&analysis, 0, sizeof(analysis));
+    analysis.range_width = DEFAULT_RANGE_WIDTH;
+    analysis.top = DEFAULT_TOP;
+
+    while ((option = getopt(argc, argv, "w:n:")) != -1) {
+        switch (option) {
+            case 'w':
+                analysis.range_width = strtol(optarg, &end, 10);
+                if (*optarg == '\0' || *end != '\0' || analysis.range_width < 1) {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            case 'n':
+                analysis.top = strtol(optarg, &end, 10);
+                if (*optarg == '\0' || *end != '\0' || analysis.top < 1) {
+                    s_usage();
+                    return EINVAL;
+                }
+                break;
+            default:
+                s_usage();
+                return EINVAL;
+        }
+    }
+
+    if (optind != argc - 1 && optind != argc - 2) {
+        s_usage();
+        return 0;
+    }
+
+    analysis.trace = trace_open(argv[optind]);
+    if (analysis.trace == NULL) {
+        rc = errno;
+        fprintf(stderr, "%s: %s\n", argv[optind], strerror(rc));
+        return rc;
+    }
+    analysis.count = trace_get_instruction_count(analysis.trace);
+    analysis.kept = trace_get_kept(analysis.trace);
+
+    printf("# trace: %s\n", argv[optind]);
+    printf("# records: %" PRIu64 " written, %" PRIu64 " kept\n",
+           trace_get_written(analysis.trace), analysis.kept);
+    printf("# program: %d instructions, hash %016" PRIx64 "\n",
+           analysis.count, trace_get_hash(analysis.trace));
+
+    if (optind == argc - 2) {
+        analysis.instructions = instruction_load_program(argv[optind + 1],
+                                                         INSTRUCTION_LOAD_LAZY, 1);
+        if (instruction_set_get_hash(analysis.instructions) != trace_get_hash(analysis.trace) ||
+            instruction_set_get_count(analysis.instructions) != analysis.count) {
+            fprintf(stderr, "%s is not the traced program, instructions not shown\n",
+                            argv[optind + 1]);
+            instruction_clean_up(analysis.instructions);
+            analysis.instructions = NULL;
+        }
+    }
+
+    s_count(&analysis);
+    s_report_branches(&analysis);
+    s_report_blocks(&analysis);
+    s_report_depth(&analysis);
+    s_report_ranges(&analysis);
+
+    free(analysis.executed);
+    free(analysis.taken);
+    free(analysis.entries);
+    free(analysis.block_length);
+    free(analysis.range_executed);
+    free(s_op_types);
+    if (analysis.instructions != NULL)
+        instruction_clean_up(analysis.instructions);
+    trace_close(analysis.trace);
+    return 0;
+}
+
+/**
+ * @brief count the records into the analysis.
+ * @param analysis [in/out] a valid analysis object.
+ */
+static void s_count(analysis_st *analysis) {
+    const trace_record_st *record;
+    const trace_record_st *previous = NULL;
+    int leader = -1;
+    uint64_t i;
+    int pc;
+
+    analysis->range_count = (analysis->count + analysis->range_width - 1) / analysis->range_width;
+
+    analysis->executed = (uint64_t *)calloc(analysis->count + 1, sizeof(uint64_t));
+    analysis->taken = (uint64_t *)calloc(analysis->count + 1, sizeof(uint64_t));
+    analysis->entries = (uint64_t *)calloc(analysis->count + 1, sizeof(uint64_t));
+    analysis->block_length = (uint64_t *)calloc(analysis->count + 1, sizeof(uint64_t));
+    analysis->range_executed = (uint64_t *)calloc(analysis->range_count + 1, sizeof(uint64_t));
+    s_op_types = (int *)malloc((analysis->count + 1) * sizeof(int));
+    if (analysis->executed == NULL || analysis->taken == NULL || analysis->entries == NULL ||
+        analysis->block_length == NULL || analysis->range_executed == NULL || s_op_types == NULL)
+        exit(ENOMEM);
+    for (pc = 0; pc < analysis->count; pc++)
+        s_op_types[pc] = -1;
+
+    for (i = 0; i < analysis->kept; i++) {
+        record = trace_get_record(analysis->trace, i);
+        pc = record->pc;
+        if (pc < 0 || pc >= analysis->count)
+            continue;
+
+        analysis->executed[pc]++;
+        analysis->range_executed[pc / analysis->range_width]++;
+        s_op_types[pc] = record->op_type;
+        if (record->op_type >= OP_JE && record->op_type <= OP_JMP &&
+            record->next_pc != pc + 1)
+            analysis->taken[pc]++;
+
+        // a block starts after any jump or a transfer, and where the ring starts.
+        if (previous == NULL ||
+            (previous->op_type >= OP_JE && previous->op_type <= OP_JMP) ||
+            previous->next_pc != pc) {
+            leader = pc;
+            analysis->entries[leader]++;
+        }
+        analysis->block_length[leader]++;
+        previous = record;
+    }
+}
+
+/**
+ * @brief write the taken ratio of the conditional jumps.
+ * @param analysis a valid analysis object, counted.
+ */
+static void s_report_branches(analysis_st *analysis) {
+    int *order;
+    int rows = 0;
+    int pc;
+    int i;
+
+    order = (int *)malloc((analysis->count + 1) * sizeof(int));
+    if (order == NULL)
+        exit(ENOMEM);
+
+    for (pc = 0; pc < analysis->count; pc++) {
+        if (s_op_types[pc] >= OP_JE && s_op_types[pc] < OP_JMP)
+            order[rows++] = pc;
+    }
+    s_sort_key = analysis->executed;
+    qsort(order, rows, sizeof(int), s_compare_key);
+
+    printf("\n## conditional jumps, by executions\n");
+    printf("%-14s %-14s %-14s %-8s %-9s %s\n",
+           "executed", "taken", "not-taken", "taken%", "address", "instruction");
+    for (i = 0; i < rows && i < analysis->top; i++) {
+        pc = order[i];
+        printf("%-14" PRIu64 " %-14" PRIu64 " %-14" PRIu64 " %6.2f%%  %-9d ",
+               analysis->executed[pc], analysis->taken[pc],
+               analysis->executed[pc] - analysis->taken[pc],
+               analysis->taken[pc] * 100.0 / analysis->executed[pc], pc + 1);
+        s_write_instruction(analysis, pc, s_op_types[pc]);
+        putchar('\n');
+    }
+
+    free(order);
+}
+
+/**
+ * @brief write the basic blocks by entries.
+ * @param analysis a valid analysis object, counted.
+ */
+static void s_report_blocks(analysis_st *analysis) {
+    double total;
+    int *order;
+    int rows = 0;
+    int pc;
+    int i;
+
+    order = (int *)malloc((analysis->count + 1) * sizeof(int));
+    if (order == NULL)
+        exit(ENOMEM);
+
+    for (pc = 0; pc < analysis->count; pc++) {
+        if (analysis->entries[pc] > 0)
+            order[rows++] = pc;
+    }
+    s_sort_key = analysis->entries;
+    qsort(order, rows, sizeof(int), s_compare_key);
+
+    total = analysis->kept > 0 ? (double)analysis->kept : 1.0;
+
+    printf("\n## basic blocks, by entries\n");
+    printf("%-14s %-10s %-8s %-9s %s\n", "entries", "length", "share%", "address", "first instruction");
+    for (i = 0; i < rows && i < analysis->top; i++) {
+        pc = order[i];
+        printf("%-14" PRIu64 " %-10.1f %6.2f%%  %-9d ",
+               analysis->entries[pc],
+               (double)analysis->block_length[pc] / analysis->entries[pc],
+               analysis->block_length[pc] * 100.0 / total, pc + 1);
+        s_write_instruction(analysis, pc, s_op_types[pc]);
+        putchar('\n');
+    }
+
+    free(order);
+}
+
+/**
+ * @brief write min, average and max scope depth of each time slice.
+ * @param analysis a valid analysis object.
+ */
+static void s_report_depth(analysis_st *analysis) {
+    const trace_record_st *record;
+    uint64_t slice_size;
+    uint64_t first;
+    uint64_t last;
+    uint64_t sum;
+    uint64_t i;
+    int min_depth;
+    int max_depth;
+    int slice;
+
+    printf("\n## scope depth over time\n");
+    printf("%-8s %-24s %-6s %-8s %s\n", "slice", "records", "min", "average", "max");
+    if (analysis->kept == 0)
+        return;
+
+    slice_size = (analysis->kept + DEPTH_SLICES - 1) / DEPTH_SLICES;
+    for (slice = 0; slice < DEPTH_SLICES; slice++) {
+        first = slice * slice_size;
+        if (first >= analysis->kept)
+            break;
+        last = first + slice_size < analysis->kept ? first + slice_size : analysis->kept;
+
+        sum = 0;
+        min_depth = -1;
+        max_depth = 0;
+        for (i = first; i < last; i++) {
+            record = trace_get_record(analysis->trace, i);
+            sum += record->depth;
+            if (min_depth < 0 || record->depth < min_depth)
+                min_depth = record->depth;
+            if (record->depth > max_depth)
+                max_depth = record->depth;
+        }
+        printf("%-8d %10" PRIu64 "-%-13" PRIu64 " %-6d %-8.2f %d\n",
+               slice, first, last - 1, min_depth, (double)sum / (last - first), max_depth);
+    }
+}
+
+/**
+ * @brief write the hottest address ranges.
+ * @param analysis a valid analysis object, counted.
+ */
+static void s_report_ranges(analysis_st *analysis) {
+    double total;
+    int *order;
+    int range;
+    int begin;
+    int end;
+    int i;
+
+    order = (int *)malloc((analysis->range_count + 1) * sizeof(int));
+    if (order == NULL)
+        exit(ENOMEM);
+
+    for (range = 0; range < analysis->range_count; range++)
+        order[range] = range;
+    s_sort_key = analysis->range_executed;
+    qsort(order, analysis->range_count, sizeof(int), s_compare_key);
+
+    total = analysis->kept > 0 ? (double)analysis->kept : 1.0;
+
+    printf("\n## hottest address ranges, %d addresses each\n", analysis->range_width);
+    printf("%-14s %-8s %s\n", "executed", "share%", "addresses");
+    for (i = 0; i < analysis->range_count && i < analysis->top; i++) {
+        range = order[i];
+        if (analysis->range_executed[range] == 0)
+            break;
+        begin = range * analysis->range_width;
+        end = begin + analysis->range_width < analysis->count ?
+              begin + analysis->range_width : analysis->count;
+        printf("%-14" PRIu64 " %6.2f%%  %d-%d\n", analysis->range_executed[range],
+               analysis->range_executed[range] * 100.0 / total, begin + 1, end);
+    }
+
+    free(order);
+}
+
+/**
+ * @brief write an instruction, or its operation name without the byte code.
+ * @param analysis a valid analysis object.
+ * @param pc address of the instruction.
+ * @param op_type operation of the instruction, from the trace.
+ */
+static void s_write_instruction(analysis_st *analysis, int pc, int op_type) {
+    instruction_st *instruction;
+
+    if (analysis->instructions == NULL) {
+        printf("%s", instruction_op_name(op_type));
+        return;
+    }
+
+    instruction = instruction_set_get_address(analysis->instructions, pc);
+    printf("%s", instruction_get_op_code(instruction));
+    if (instruction_get_op_first(instruction) != NULL)
+        printf(" %s", instruction_get_op_first(instruction));
+    if (instruction_get_op_second(instruction) != NULL)
+        printf(" %s", instruction_get_op_second(instruction));
+}
+
+/**
+ * @brief order addresses by the sort key, descending, used by qsort.
+ * @param left an address.
+ * @param right an address.
+ * @return compare result.
+ */
+static int s_compare_key(const void *left, const void *right) {
+    uint64_t left_key = s_sort_key[*(const int *)left];
+    uint64_t right_key = s_sort_key[*(const int *)right];
+
+    if (left_key != right_key)
+        return left_key > right_key ? -1 : 1;
+    return *(const int *)left - *(const int *)right;
+}
+
+/**
+ * @brief print out the usage information of trace-analyze.
+ */
+static void s_usage() {
+    printf("Usage:\n");
+    printf("./trace-analyze [options] <trace file> [asm file]\n");
+    printf("e.g ./runtime --trace-bin program1.trace program1.asm\n");
+    printf("    ./trace-analyze program1.trace program1.asm\n");
+    printf("Options:\n");
+    printf("  -w <n>                      addresses per range, default %d\n", DEFAULT_RANGE_WIDTH);
+    printf("  -n <n>                      rows per table, default %d\n", DEFAULT_TOP);
+}